@@ -3,8 +3,19 @@
 #include <windows.h>
 #include "game.hpp"
 #include "render.hpp"
+#include "render_soft.hpp"
 #include "input.hpp"
+#include "frame_scheduler.hpp"
+#include "sim_thread.hpp"
+#include "replay.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
 #include <ctime>
+#include <thread>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
 
 const int WINDOW_W = 1280;
 const int WINDOW_H = 720;
@@ -16,47 +27,164 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 // A pointer to the window so input & rendering can reference it if needed
 static HWND g_hwnd = nullptr;
 
+// Persistent backbuffer: a top-down 32bpp DIB section created once. GDI draws into it through
+// g_backDC; the software renderer (F2 toggles) writes its pixels directly.
+static HDC g_backDC = nullptr;
+static HBITMAP g_backBmp = nullptr, g_backOldBmp = nullptr;
+static uint32_t* g_backPixels = nullptr;
+static bool g_softwareRender = false;
+static double g_renderAlpha = 1.0; // interpolation between the last two ticks, from the snapshot clock
+
+// F4 cycles the world view through zoomed-out map views drawn from the world summary (map
+// cells per pixel; 0 = the normal view)
+static const double MAP_ZOOMS[] = { 0, 1, 4, 16 };
+static int g_mapZoom = 0;
+
+// Every session is recorded (seed + per-tick thrust + state hashes) so it can be replayed
+// headlessly with tools/replay; blocks are flushed as the game runs, so a crash keeps them.
+static const char* REPLAY_PATH = "last_session.replay";
+static ReplayRecorder g_recorder;
+
+// Profiled builds (PROFILE_ENABLED) show zone timings in the HUD and write the zones still in
+// the ring buffers as a Chrome trace on F3 and at exit.
+static const char* TRACE_PATH = "profile_trace.json";
+
+// The sim thread's input source: once per tick it drains the events the window thread queued
+// (input_drain) and samples thrust from the resulting state, so a tick sees one consistent
+// input. The oldest drained event's receipt time travels with the snapshot for latency.
+static Vec2 windowInputThrust(int, void*){
+    double oldest;
+    if(input_drain(&oldest) > 0) sim_thread_note_input(oldest);
+    return get_input_thrust();
+}
+
+// Repaints: the main loop asks for one frame per scheduler frame. Any other WM_PAINT (window
+// uncovered, moved) re-presents the backbuffer as it is instead of drawing another frame.
+static bool g_frameRequested = false;
+
+// Frame clock and wait for the scheduler: QPC time, and a waitable-timer sleep that spins the
+// last half millisecond. Window messages end the wait early so input is not held up.
+static LARGE_INTEGER g_perfFreq;
+static HANDLE g_frameTimer = nullptr;
+static bool g_timerPeriodSet = false;
+
+static double winNow(void*){
+    LARGE_INTEGER t; QueryPerformanceCounter(&t);
+    return (double)t.QuadPart / (double)g_perfFreq.QuadPart;
+}
+
+static void winWait(double seconds, void*){
+    double until = winNow(nullptr) + seconds;
+    if(seconds > 0.001 && g_frameTimer){
+        LARGE_INTEGER due; due.QuadPart = -(LONGLONG)((seconds - 0.0005) * 1e7); // relative, 100 ns units
+        if(SetWaitableTimer(g_frameTimer, &due, 0, NULL, NULL, FALSE)
+            && MsgWaitForMultipleObjects(1, &g_frameTimer, FALSE, INFINITE, QS_ALLINPUT) != WAIT_OBJECT_0)
+            return; // a message arrived
+    }
+    while(winNow(nullptr) < until) SwitchToThread();
+}
+
+static void createFrameTimer(){
+    QueryPerformanceFrequency(&g_perfFreq);
+    g_frameTimer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if(!g_frameTimer){
+        // pre-1803 Windows: plain timer, with the system timer resolution raised to 1 ms
+        g_frameTimer = CreateWaitableTimerW(NULL, FALSE, NULL);
+        g_timerPeriodSet = timeBeginPeriod(1) == 0;
+    }
+}
+
+static void destroyFrameTimer(){
+    if(g_frameTimer){ CloseHandle(g_frameTimer); g_frameTimer = nullptr; }
+    if(g_timerPeriodSet){ timeEndPeriod(1); g_timerPeriodSet = false; }
+}
+
+
+static void createBackbuffer(HWND hwnd){
+    BITMAPINFO bi; ZeroMemory(&bi, sizeof(bi));
+    bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bi.bmiHeader.biWidth = WINDOW_W;
+    bi.bmiHeader.biHeight = -WINDOW_H; // top-down
+    bi.bmiHeader.biPlanes = 1;
+    bi.bmiHeader.biBitCount = 32;
+    bi.bmiHeader.biCompression = BI_RGB;
+    HDC wnd = GetDC(hwnd);
+    g_backDC = CreateCompatibleDC(wnd);
+    g_backBmp = CreateDIBSection(wnd, &bi, DIB_RGB_COLORS, (void**)&g_backPixels, NULL, 0);
+    g_backOldBmp = (HBITMAP)SelectObject(g_backDC, g_backBmp);
+    ReleaseDC(hwnd, wnd);
+}
+
+static void destroyBackbuffer(){
+    if(!g_backDC) return;
+    SelectObject(g_backDC, g_backOldBmp);
+    DeleteObject(g_backBmp);
+    DeleteDC(g_backDC);
+    g_backDC = nullptr; g_backPixels = nullptr;
+}
+
+static void paintSoftware(){
+    GdiFlush(); // finish any pending GDI work on the DIB before touching its pixels
+    Framebuffer fb = { g_backPixels, WINDOW_W, WINDOW_H, WINDOW_W };
+    if(g_mapZoom) render_draw_map(fb, MAP_ZOOMS[g_mapZoom], g_renderAlpha);
+    else render_draw_world(fb, g_renderAlpha);
+    // the software pass redraws the whole view, so it only drops the dirty cells; the GDI
+    // tile cache has missed them and is rebuilt if F2 switches back
+    sim_view_clear_dirty_cells();
+    render_invalidate_cache();
+    render_draw_hud(fb);
+    render_draw_ui(fb);
+    if(sim_view().paused) render_draw_text(fb, 220, 120, "PAUSED", fb_rgb(200,200,255), 6);
+    if(sim_view().gameOver) render_draw_text(fb, 160, 120, "GAME OVER", fb_rgb(255,80,80), 7);
+}
+
+static void paintGdi(HDC mem){
+    if(g_mapZoom) render_draw_map(mem, MAP_ZOOMS[g_mapZoom], g_renderAlpha);
+    else render_draw_world(mem, g_renderAlpha);
+    render_draw_hud(mem);
+    render_draw_ui(mem);
+
+    if(sim_view().paused){
+        SetBkMode(mem, TRANSPARENT);
+        SetTextColor(mem, RGB(255,255,255));
+        HFONT hf = CreateFontA(48,0,0,0,FW_BOLD,0,0,0,0,0,0,0,0,"Consolas");
+        HFONT oldf = (HFONT)SelectObject(mem,hf);
+        render_draw_text(mem, 220, 120, "PAUSED", RGB(200,200,255));
+        SelectObject(mem,oldf);
+        DeleteObject(hf);
+    }
+
+    if(sim_view().gameOver){
+        HFONT hf = CreateFontA(56,0,0,0,FW_BOLD,0,0,0,0,0,0,0,0,"Arial");
+        HFONT oldf = (HFONT)SelectObject(mem,hf);
+        render_draw_text(mem, 160, 120, "GAME OVER", RGB(255,80,80));
+        SelectObject(mem, oldf);
+        DeleteObject(hf);
+    }
+}
+
 LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam){
     switch(msg){
         case WM_PAINT:
         {
+            PROFILE_ZONE("paint");
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
-            // double buffered drawing
-            HDC mem = CreateCompatibleDC(hdc);
-            HBITMAP bmp = CreateCompatibleBitmap(hdc, WINDOW_W, WINDOW_H);
-            HBITMAP oldbmp = (HBITMAP)SelectObject(mem, bmp);
-
-            // draw everything to mem DC
-            render_draw_world(mem);
-            render_draw_hud(mem);
-            render_draw_ui(mem);
-
-            if(game_is_paused()){
-                RECT rc = {0,0,WINDOW_W-HUD_WIDTH, WINDOW_H};
-                SetBkMode(mem, TRANSPARENT);
-                SetTextColor(mem, RGB(255,255,255));
-                HFONT hf = CreateFontA(48,0,0,0,FW_BOLD,0,0,0,0,0,0,0,0,"Consolas");
-                HFONT oldf = (HFONT)SelectObject(mem,hf);
-                render_draw_text(mem, 220, 120, "PAUSED", RGB(200,200,255));
-                SelectObject(mem,oldf);
-                DeleteObject(hf);
+            // double buffered drawing into the persistent backbuffer (absent until init is done)
+            if(g_backDC){
+                bool frame = g_frameRequested;
+                if(frame){
+                    g_frameRequested = false;
+                    sim_view_update();
+                    g_renderAlpha = sim_view_alpha();
+                    if(g_softwareRender) paintSoftware();
+                    else paintGdi(g_backDC);
+                }
+                PROFILE_ZONE("present");
+                BitBlt(hdc, 0, 0, WINDOW_W, WINDOW_H, g_backDC, 0, 0, SRCCOPY);
+                GdiFlush();
+                if(frame) sim_view_note_present(sched_default_now(nullptr));
             }
-
-            if(game_is_over()){
-                HFONT hf = CreateFontA(56,0,0,0,FW_BOLD,0,0,0,0,0,0,0,0,"Arial");
-                HFONT oldf = (HFONT)SelectObject(mem,hf);
-                render_draw_text(mem, 160, 120, "GAME OVER", RGB(255,80,80));
-                SelectObject(mem, oldf);
-                DeleteObject(hf);
-            }
-
-            // finalize: blit mem to window
-            BitBlt(hdc, 0, 0, WINDOW_W, WINDOW_H, mem, 0, 0, SRCCOPY);
-            // cleanup
-            SelectObject(mem, oldbmp);
-            DeleteObject(bmp);
-            DeleteDC(mem);
             EndPaint(hwnd, &ps);
         } break;
 
@@ -66,11 +194,14 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam){
         case WM_RBUTTONUP:
         case WM_MOUSEMOVE:
         case WM_KEYDOWN:
+            if(msg == WM_KEYDOWN && wParam == VK_F2) g_softwareRender = !g_softwareRender;
+            if(msg == WM_KEYDOWN && wParam == VK_F3) profiler_write_chrome_trace(TRACE_PATH);
+            if(msg == WM_KEYDOWN && wParam == VK_F4) g_mapZoom = (g_mapZoom + 1) % (int)(sizeof(MAP_ZOOMS) / sizeof(MAP_ZOOMS[0]));
+            // fall through
         case WM_KEYUP:
-        {
+            // queued for the next tick; the frame that shows it is painted by the main loop
             input_handle_window_event(hwnd, msg, wParam, lParam);
-            InvalidateRect(hwnd, NULL, FALSE);
-        } break;
+            break;
 
         case WM_DESTROY:
             PostQuitMessage(0);
@@ -82,7 +213,6 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam){
 }
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nShowCmd){
-    srand((unsigned)time(NULL));
     // register class
     WNDCLASS wc = {0};
     wc.lpfnWndProc = WndProc;
@@ -107,44 +237,62 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     UpdateWindow(hwnd);
 
     // initialize subsystems
-    game_init();
+    PROFILE_THREAD("main");
+    game_set_input_source(windowInputThrust, nullptr);
+    game_init((uint32_t)time(NULL));
+    g_recorder.start(game_session(), REPLAY_PATH); // the game runs unrecorded if this fails
+    // world regions ahead of the ship are generated on background threads
+    unsigned hw = std::thread::hardware_concurrency();
+    game_session().stream.start_workers(hw > 3 ? 2 : 1);
+    // big ships and swarms split the tick's read phases over a pool; the sim thread is worker 0
+    ThreadPool tickPool(hw > 4 ? (int)hw - 3 : 1);
+    game_session().pool = &tickPool;
     render_init(hwnd);
+    createBackbuffer(hwnd);
     input_init(hwnd);
 
-    // high-resolution loop
-    LARGE_INTEGER perfFreq, lastTime, curTime;
-    QueryPerformanceFrequency(&perfFreq);
-    QueryPerformanceCounter(&lastTime);
-    double accumulator = 0.0;
-    const double DT = 1.0 / 60.0;
+    // the sim ticks at a fixed 60 Hz on its own thread; this thread paces frames to the
+    // display refresh and draws the newest snapshot, interpolated toward the next tick
+    sim_thread_start(1.0 / 60.0);
+    createFrameTimer();
+    HDC screen = GetDC(hwnd);
+    int refresh = GetDeviceCaps(screen, VREFRESH);
+    ReleaseDC(hwnd, screen);
+    FrameScheduler sched(1.0 / 60.0, 5);
+    sched.set_clock(winNow, winWait, nullptr);
+    sched.set_frame_interval(1.0 / (refresh > 1 ? refresh : 60));
     MSG msg;
     ZeroMemory(&msg, sizeof(msg));
 
     while(game_is_running()){
-        // process messages
-        while(PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)){
-            if(msg.message == WM_QUIT){ game_request_quit(); break; }
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
+        // process messages (painting happens in here too)
+        {
+            PROFILE_ZONE("messages");
+            while(PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)){
+                if(msg.message == WM_QUIT){ game_request_quit(); break; }
+                TranslateMessage(&msg);
+                DispatchMessage(&msg);
+            }
+            input_flush();
         }
         if(!game_is_running()) break;
-        QueryPerformanceCounter(&curTime);
-        double elapsed = (double)(curTime.QuadPart - lastTime.QuadPart) / (double)perfFreq.QuadPart;
-        lastTime = curTime;
-        accumulator += elapsed;
-
-        // fixed update steps
-        while(accumulator >= DT){
-            game_update();
-            accumulator -= DT;
-        }
+        if(!sched.frame_due()){ PROFILE_ZONE("frame_wait"); sched.wait_next_frame(); continue; }
+
+        sched.step(nullptr, nullptr);
 
-        // request redraw
+        // request this frame's redraw (the only one; input messages no longer invalidate)
+        g_frameRequested = true;
         InvalidateRect(hwnd, NULL, FALSE);
-        Sleep(4);
     }
 
     // shutdown
+    sim_thread_stop();
+    game_session().pool = nullptr;
+    game_session().stream.stop_workers();
+    if(profiler_enabled()) profiler_write_chrome_trace(TRACE_PATH);
+    g_recorder.stop();
+    destroyFrameTimer();
+    destroyBackbuffer();
     render_shutdown();
     game_shutdown();
     input_shutdown();
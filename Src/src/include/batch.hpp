@@ -0,0 +1,31 @@
+// include/batch.hpp
+#pragma once
+#include "game.hpp"
+#include <vector>
+
+class ThreadPool;
+
+enum BatchOutcome { OUTCOME_TIMEOUT=0, OUTCOME_WON, OUTCOME_LOST };
+
+struct BatchConfig {
+    int sessions;          // number of independent sessions
+    uint32_t baseSeed;     // session i runs with seed baseSeed + i
+    int maxTicks;          // per-session tick limit
+    GameInputSource input; // shared scripted pilot; must be thread-safe (it gets the tick number)
+    void* inputUser;
+    BatchConfig():sessions(1000),baseSeed(1),maxTicks(60*60),input(nullptr),inputUser(nullptr){}
+};
+
+struct BatchResult {
+    uint32_t seed;
+    int ticks;
+    int score;
+    int resources;
+    int drones;
+    BatchOutcome outcome;
+};
+
+// Runs every session to game over or maxTicks on the pool. Each worker reuses one Session,
+// so after the first session per worker the tick loop does not allocate.
+void batch_run(ThreadPool& pool, const BatchConfig& cfg, std::vector<BatchResult>& out);
+const char* batch_outcome_name(BatchOutcome o);
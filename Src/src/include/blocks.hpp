@@ -0,0 +1,55 @@
+// include/blocks.hpp
+#pragma once
+#include <cstdint>
+
+enum BlockType { BLOCK_EMPTY=0, BLOCK_ARMOR, BLOCK_THRUSTER, BLOCK_CORE, BLOCK_MINER, BLOCK_TYPE_COUNT };
+
+// Everything the game knows about a block type, in one compile-time table shared by placement,
+// salvage, mining, ship mass and both renderers. Add a type here and nowhere else.
+struct BlockInfo {
+    const char* name;
+    int hp;             // hit points when placed (world or ship)
+    int salvage;        // resources for removing one from the world
+    int mineResources;  // resources and score when a miner breaks one; 0 = miners ignore it
+    int mineScore;
+    double mass;        // ship mass; multiples of 1/2 keep the ship's running sums exact
+    uint32_t color;     // 0xRRGGBB, the block's draw material
+};
+
+constexpr BlockInfo BLOCK_INFO[BLOCK_TYPE_COUNT] = {
+    // name        hp  salv  mineR mineS  mass  color
+    { "empty",      0,   0,    0,    0,   0.0, 0x0E0E18 },
+    { "armor",     60,   8,   12,    8,   1.5, 0x786E50 },
+    { "thruster",  30,  12,    0,    0,   1.5, 0xB43C28 },
+    { "core",     100,   4,    0,    0,   3.0, 0xB4B4B4 },
+    { "miner",     20,  10,    0,    0,   1.0, 0x64B4C8 },
+};
+
+constexpr const BlockInfo& block_info(BlockType t){ return BLOCK_INFO[(unsigned)t < BLOCK_TYPE_COUNT ? t : BLOCK_EMPTY]; }
+constexpr bool block_valid_type(unsigned t){ return t < BLOCK_TYPE_COUNT; }
+
+// A world cell in 16 bits: type in the low 4, hp in the high 12. Hp is exact up to
+// BLOCK_HP_MAX and saturates above it; damage floors it at 0. Four times denser than the
+// old {type, int hp} pair, so chunk scans, copies and saves move a quarter of the memory.
+static const int BLOCK_TYPE_BITS = 4;
+static const int BLOCK_HP_MAX = (1 << (16 - BLOCK_TYPE_BITS)) - 1;
+
+struct Block {
+    uint16_t bits;
+
+    Block():bits(0){}
+    Block(BlockType t, int hp){ bits = (uint16_t)t; set_hp(t == BLOCK_EMPTY ? 0 : hp); }
+    // a fresh block of type t at its registry hp
+    static Block of(BlockType t){ return Block(t, block_info(t).hp); }
+
+    BlockType type() const { return (BlockType)(bits & ((1 << BLOCK_TYPE_BITS) - 1)); }
+    int hp() const { return bits >> BLOCK_TYPE_BITS; }
+    bool empty() const { return type() == BLOCK_EMPTY; }
+    void set_hp(int hp){
+        hp = hp < 0 ? 0 : (hp > BLOCK_HP_MAX ? BLOCK_HP_MAX : hp);
+        bits = (uint16_t)((bits & ((1 << BLOCK_TYPE_BITS) - 1)) | (hp << BLOCK_TYPE_BITS));
+    }
+    // true when this takes the last hit point
+    bool damage(int amount){ set_hp(hp() - amount); return hp() == 0; }
+};
+static_assert(sizeof(Block) == 2, "world cells are packed into 16 bits");
@@ -0,0 +1,31 @@
+// include/camera.hpp
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+// World-space camera shared by the render backends: top-left corner in pixels plus the size of
+// the world viewport (window minus HUD).
+struct Camera {
+    double x, y;
+    int viewW, viewH;
+    Camera():x(0),y(0),viewW(0),viewH(0){}
+};
+
+// ease toward centring (px,py), as the renderer always has
+inline void camera_follow(Camera& cam, double px, double py){
+    cam.x += (px - cam.viewW/2.0 - cam.x) * 0.12;
+    cam.y += (py - cam.viewH/2.0 - cam.y) * 0.12;
+}
+
+// integer pixel origin used for all screen positions this frame
+inline int camera_ox(const Camera& cam){ return (int)std::floor(cam.x); }
+inline int camera_oy(const Camera& cam){ return (int)std::floor(cam.y); }
+
+// cells overlapping the viewport (unclamped; may lie outside the world)
+inline void camera_visible_cells(const Camera& cam, int cell, int& r0, int& c0, int& r1, int& c1){
+    int ox = camera_ox(cam), oy = camera_oy(cam);
+    c0 = (int)std::floor((double)ox / cell);
+    r0 = (int)std::floor((double)oy / cell);
+    c1 = (int)std::floor((double)(ox + cam.viewW - 1) / cell);
+    r1 = (int)std::floor((double)(oy + cam.viewH - 1) / cell);
+}
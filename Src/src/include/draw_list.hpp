@@ -0,0 +1,41 @@
+// include/draw_list.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "camera.hpp"
+#include "snapshot.hpp"
+
+// Draw-list stage between game state and a render backend: collects only what the camera can
+// see as screen-space primitives, then sorts them by material so a backend submits each
+// material as one batch (one brush / one color per material per frame).
+// block materials follow BlockType order; their colors come from the block registry
+enum DrawMaterial { MAT_TILE=0, MAT_ARMOR, MAT_THRUSTER, MAT_CORE, MAT_MINER, MAT_DRONE, MAT_SHIP, MAT_COUNT };
+static_assert(MAT_MINER - MAT_ARMOR == BLOCK_MINER - BLOCK_ARMOR && BLOCK_MINER + 1 == BLOCK_TYPE_COUNT, "a material per block type");
+inline int draw_block_material(BlockType t){ return MAT_ARMOR + (t - BLOCK_ARMOR); }
+enum DrawShape { SHAPE_RECT=0, SHAPE_FRAME, SHAPE_TRIANGLE };
+
+struct DrawItem {
+    uint8_t material, shape;
+    int x0, y0, x1, y1;   // rect/frame: half-open box; triangle: first two vertices
+    int x2, y2;           // triangle: third vertex
+};
+
+struct DrawList {
+    std::vector<DrawItem> items;
+    std::vector<DrawItem> scratch;    // sort buffer
+    int batchStart[MAT_COUNT + 1];    // after draw_list_sort(): items of material m are [batchStart[m], batchStart[m+1])
+    int cells;                        // non-empty cells emitted
+    int drones;                       // drones that survived culling
+    void clear(){ items.clear(); cells = 0; drones = 0; }
+};
+
+uint32_t draw_material_color(int material); // 0xRRGGBB
+
+// blocks in cell range [r0,r1] x [c0,c1] as frame + inset fill, positioned so world pixel
+// (ox,oy) lands at (0,0)
+void draw_list_add_cells(DrawList& dl, const WorldGrid& world, int r0, int c0, int r1, int c1, int ox, int oy);
+// player ship, loose debris and the drones overlapping the camera viewport, placed alpha of
+// the way from their previous-tick to their current positions in the snapshot
+void draw_list_add_entities(DrawList& dl, const Camera& cam, const SimSnapshot& snap, double alpha = 1.0);
+// stable counting sort by material; fills batchStart
+void draw_list_sort(DrawList& dl);
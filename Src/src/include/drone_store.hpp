@@ -0,0 +1,45 @@
+// include/drone_store.hpp
+#pragma once
+#include <vector>
+
+struct Drone;
+
+// Structure-of-arrays drone storage: one contiguous array per field so the steering kernel can
+// stream positions and velocities through SIMD lanes. Only live drones are stored; removal
+// swaps the last drone into the freed slot, so indices are not stable across removals.
+struct DroneStore {
+    std::vector<double> x, y, vx, vy, angle, cooldown;
+    std::vector<int> hp;
+    std::vector<double> prevX, prevY; // position at the start of the last tick, for render interpolation
+    // Op journal: every push() (as -1) and remove_swap(i) (as i) since the last clear_ops(), in
+    // call order. Off by default; the state stream (state_stream.hpp) turns it on so viewers
+    // replay the same appends and swap-removes and keep the store's indices. clear() empties it.
+    std::vector<int> ops;
+    bool journaling;
+
+    DroneStore() : journaling(false) {}
+    int size() const { return (int)x.size(); }
+    bool empty() const { return x.empty(); }
+    void clear();
+    void reserve(int n);
+    void push(const Drone& d);
+    Drone get(int i) const;
+    void remove_swap(int i);
+    // swap-removes every drone with hp <= 0
+    void remove_dead();
+    // prevX/prevY = x/y; called at the start of a tick
+    void save_prev();
+    void journal_ops(bool on){ journaling = on; ops.clear(); }
+    void clear_ops(){ ops.clear(); }
+};
+
+// Steers drones [begin,end) at the cruise speed, each toward its own target (targetX/targetY:
+// the next flow-field cell, or the ship), adds the separation push (pushX/pushY, weighted by
+// sepGain; all four arrays indexed like the store), and integrates one tick.
+// drone_steer() uses the widest SIMD path compiled in (AVX, SSE2, or scalar);
+// drone_steer_scalar() is the reference it must match. SIM_FIXED_POINT builds steer with
+// drone_steer_fixed(), the same kernel in Fixed (sim_real.hpp), and no SIMD.
+void drone_steer(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain);
+void drone_steer_scalar(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain);
+void drone_steer_fixed(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain);
+const char* drone_steer_isa();
@@ -0,0 +1,83 @@
+// include/fixed.hpp
+#pragma once
+#include <cstdint>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Q32.32 fixed point, the simulation's number type in SIM_FIXED_POINT builds (sim_real.hpp).
+// Everything here is integer arithmetic with one defined rounding (products toward -inf,
+// quotients toward zero), so results are the same bits on every compiler, flag set and CPU;
+// double is not (libm sin/cos differ between runtimes, compilers may fuse a*b+c). Sums wrap past
+// +-2^31, quotients saturate. sin/cos come from a quarter-wave table built with integer
+// arithmetic, sqrt is the exact floor of the root.
+struct Fixed {
+    int64_t raw;
+
+    constexpr Fixed() : raw(0) {}
+    constexpr explicit Fixed(int v) : raw((int64_t)v * 4294967296ll) {}
+    // nearest Fixed (ties away from zero); exact IEEE operations only, so every compiler
+    // converts a double the same way
+    constexpr explicit Fixed(double v) : raw(round(v * 4294967296.0)) {}
+    static constexpr Fixed from_raw(int64_t r){ Fixed f; f.raw = r; return f; }
+    double to_double() const { return (double)raw * (1.0 / 4294967296.0); }
+
+private:
+    // t - trunc(t) is exact, where adding 0.5 first would round large values
+    static constexpr int64_t round(double t){
+        return (int64_t)t + (t - (double)(int64_t)t >= 0.5 ? 1 : t - (double)(int64_t)t <= -0.5 ? -1 : 0);
+    }
+};
+
+namespace fixed_detail {
+// (a * b) >> 32 of the full 128-bit product; FIXED_NO_INT128 forces the portable version
+#if defined(__SIZEOF_INT128__) && !defined(FIXED_NO_INT128)
+inline int64_t mul(int64_t a, int64_t b){ return (int64_t)(((__int128)a * b) >> 32); }
+#elif defined(_MSC_VER) && defined(_M_X64) && !defined(FIXED_NO_INT128)
+inline int64_t mul(int64_t a, int64_t b){
+    int64_t hi, lo = _mul128(a, b, &hi);
+    return (int64_t)(((uint64_t)lo >> 32) | ((uint64_t)hi << 32));
+}
+#else
+inline int64_t mul(int64_t a, int64_t b){
+    bool neg = (a < 0) != (b < 0);
+    uint64_t ua = a < 0 ? 0 - (uint64_t)a : (uint64_t)a, ub = b < 0 ? 0 - (uint64_t)b : (uint64_t)b;
+    uint64_t a0 = ua & 0xffffffffu, a1 = ua >> 32, b0 = ub & 0xffffffffu, b1 = ub >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffu) + (p10 & 0xffffffffu);
+    uint64_t lo = (p00 & 0xffffffffu) | (mid << 32);
+    uint64_t hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    if(neg){ lo = ~lo + 1; hi = ~hi + (lo == 0 ? 1 : 0); }
+    return (int64_t)((lo >> 32) | (hi << 32));
+}
+#endif
+int64_t div(int64_t a, int64_t b); // (a << 32) / b toward zero, saturated; b == 0 gives +-max
+}
+
+inline Fixed operator+(Fixed a, Fixed b){ return Fixed::from_raw((int64_t)((uint64_t)a.raw + (uint64_t)b.raw)); }
+inline Fixed operator-(Fixed a, Fixed b){ return Fixed::from_raw((int64_t)((uint64_t)a.raw - (uint64_t)b.raw)); }
+inline Fixed operator-(Fixed a){ return Fixed::from_raw((int64_t)(0 - (uint64_t)a.raw)); }
+inline Fixed operator*(Fixed a, Fixed b){ return Fixed::from_raw(fixed_detail::mul(a.raw, b.raw)); }
+inline Fixed operator/(Fixed a, Fixed b){ return Fixed::from_raw(fixed_detail::div(a.raw, b.raw)); }
+inline Fixed operator*(Fixed a, int n){ return Fixed::from_raw((int64_t)((uint64_t)a.raw * (uint64_t)(int64_t)n)); }
+inline Fixed operator*(int n, Fixed a){ return a * n; }
+inline Fixed operator/(Fixed a, int n){ return Fixed::from_raw(a.raw / n); }
+inline Fixed& operator+=(Fixed& a, Fixed b){ return a = a + b; }
+inline Fixed& operator-=(Fixed& a, Fixed b){ return a = a - b; }
+inline Fixed& operator*=(Fixed& a, Fixed b){ return a = a * b; }
+inline bool operator<(Fixed a, Fixed b){ return a.raw < b.raw; }
+inline bool operator>(Fixed a, Fixed b){ return a.raw > b.raw; }
+inline bool operator<=(Fixed a, Fixed b){ return a.raw <= b.raw; }
+inline bool operator>=(Fixed a, Fixed b){ return a.raw >= b.raw; }
+inline bool operator==(Fixed a, Fixed b){ return a.raw == b.raw; }
+inline bool operator!=(Fixed a, Fixed b){ return a.raw != b.raw; }
+
+// sin and cos of angle (radians, any magnitude): quarter-wave table of FIXED_TRIG_SIZE steps,
+// linearly interpolated (error below 2e-8)
+static const int FIXED_TRIG_BITS = 12;
+static const int FIXED_TRIG_SIZE = 1 << FIXED_TRIG_BITS;
+void fixed_sin_cos(Fixed angle, Fixed& s, Fixed& c);
+// floor of the exact root; 0 for v <= 0
+Fixed fixed_sqrt(Fixed v);
+// floor of sqrt(x^2 + y^2) from the exact 128-bit sum, so far-apart points do not overflow
+Fixed fixed_length(Fixed x, Fixed y);
@@ -0,0 +1,89 @@
+// include/flow_field.hpp
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "world_stream.hpp"
+
+// Shared drone pathing: one distance field toward the player's cell over a FLOW_SIZE x
+// FLOW_SIZE window of cells around it, which every drone reads in O(1) (step()), so pathing
+// costs the same for ten drones or fifty thousand. Moves are 8-way with octile costs
+// (FLOW_ORTHO straight, FLOW_DIAG diagonal), diagonals never cut a solid corner, and cells
+// outside the map are solid.
+//
+// The field is repaired rather than recomputed: edits invalidate only the cells whose
+// shortest path ran through them, and the cells that can get closer are relaxed from the
+// edit outward, in distance order. The source moving is a repair too: distances are stored
+// relative to a bias, so raising every cell by the length of the move (still a valid bound:
+// any path to the old source continues to the new one) is one addition, after which only the
+// cells the move brought closer are relaxed. Only the window moving (the player near its
+// edge), an unreachable new source or reset() starts over.
+//
+// Solidity comes from WorldStream::chunk_blocks(), so the field is the same whatever is
+// resident: deterministic like the rest of the tick, and a rebuild after a load matches the
+// field the running session repaired its way to.
+static const int FLOW_SHIFT = 8;
+static const int FLOW_SIZE = 1 << FLOW_SHIFT;   // window side in cells, a whole number of chunks
+static const int FLOW_RECENTER = 64;            // source this close to a window edge moves the window
+static const int FLOW_ORTHO = 2, FLOW_DIAG = 3;
+static const int32_t FLOW_UNREACHED = INT32_MAX;
+
+struct FlowStats {
+    long rebuilds;                  // from scratch: reset, load, window moved
+    long repairs;                   // incremental updates that changed something
+    int lastCells;                  // cells the last update assigned a distance to
+};
+
+class FlowField {
+public:
+    FlowField();
+    // forget the field; the next update() rebuilds it
+    void reset();
+    // world cells written since the last call (w.written(), read before the stream logs and
+    // clears them); only those whose solidity changed reach the next update()
+    void note_writes(const WorldGrid& w, const std::vector<CellPos>& written);
+    // the source is now cell (r,c): applies the noted edits and the move, once per tick
+    void update(const WorldGrid& w, const WorldStream& st, int r, int c);
+
+    bool valid() const { return m_valid; }
+    int source_r() const { return m_srcR; }
+    int source_c() const { return m_srcC; }
+    int window_r() const { return m_r0; }   // top-left cell of the window
+    int window_c() const { return m_c0; }
+    // distance from cell (r,c) to the source in FLOW_ORTHO/FLOW_DIAG units, FLOW_UNREACHED
+    // when solid, walled off or outside the window
+    int32_t distance(int r, int c) const;
+    // the neighbour one step closer to the source; false at the source and wherever
+    // distance() is FLOW_UNREACHED
+    bool step(int r, int c, int& nr, int& nc) const;
+
+    FlowStats stats() const { return m_stats; }
+
+private:
+    int index(int r, int c) const { return (r - m_r0 + 1) * STRIDE + (c - m_c0 + 1); }
+    bool in_window(int r, int c) const { return (unsigned)(r - m_r0) < (unsigned)FLOW_SIZE && (unsigned)(c - m_c0) < (unsigned)FLOW_SIZE; }
+    bool can_step(int from, int k) const;
+    void place_window(const WorldGrid& w, const WorldStream& st, int r, int c);
+    void rebuild();
+    void repair();
+    bool move_source(int src);
+    void propagate();
+
+    // one solid cell of border all round, so neighbour walks need no bounds checks
+    static const int STRIDE = FLOW_SIZE + 2;
+    int m_r0, m_c0;                     // window origin cell
+    int m_srcR, m_srcC, m_src;
+    int32_t m_bias;                     // distance = stored value + bias
+    bool m_valid;
+    std::vector<uint8_t> m_solid;
+    std::vector<int32_t> m_dist;
+    std::vector<uint8_t> m_invalid;
+    std::vector<int> m_dirty;           // cells whose solidity changed since the last update
+    std::vector<int> m_queue;           // scratch: invalidation candidates
+    std::vector<int> m_stale;           // scratch: cells invalidated this update
+    std::vector<std::pair<int32_t,int>> m_seeds;
+    std::vector<int> m_buckets[4];      // Dial's buckets: costs are at most 3, so four cover the frontier
+    std::vector<uint8_t> m_scratchSolid;
+    std::vector<Block> m_chunk;
+    FlowStats m_stats;
+};
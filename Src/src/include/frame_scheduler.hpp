@@ -0,0 +1,65 @@
+// include/frame_scheduler.hpp
+#pragma once
+
+// Fixed-step frame scheduler. Each frame step() adds the elapsed clock time to an accumulator
+// and runs whole ticks out of it, at most maxSteps per frame; time beyond that is dropped
+// rather than carried over, so a slow frame cannot snowball into ever longer catch-up frames.
+// The leftover fraction of a tick is alpha(), which the renderer uses to blend the previous
+// and current tick. The clock and wait are pluggable so a fake clock can drive it headless.
+typedef double (*SchedClockFn)(void* user);              // monotonic time in seconds
+typedef void (*SchedWaitFn)(double seconds, void* user); // block about this long (may return early)
+typedef void (*SchedTickFn)(void* user);
+
+struct FrameStats {
+    int ticks;          // ticks run this frame
+    double frameTime;   // clock time since the previous frame, seconds
+    double dropped;     // time discarded by the step cap this frame, seconds
+    double jitter;      // |frameTime - frame interval|, seconds
+    double alpha;       // interpolation factor handed to the renderer
+};
+
+struct FrameTotals {
+    long frames, ticks;
+    long cappedFrames;  // frames that hit maxSteps
+    double dropped;     // seconds
+    double maxJitter, sumJitter;
+};
+
+// default clock/wait: steady_clock, and a sleep that wakes ~1 ms early and spins the rest
+double sched_default_now(void* user);
+void sched_precise_wait(double seconds, void* user);
+
+class FrameScheduler {
+public:
+    explicit FrameScheduler(double dt = 1.0/60.0, int maxSteps = 5);
+    void set_clock(SchedClockFn now, SchedWaitFn wait, void* user);
+    // target time between frames for wait_next_frame() and the jitter stat (default: dt)
+    void set_frame_interval(double seconds){ m_interval = seconds; }
+    double dt() const { return m_dt; }
+    int max_steps() const { return m_maxSteps; }
+
+    // restart timing at the current clock time with an empty accumulator and zeroed totals
+    void reset();
+    // run this frame's ticks; returns how many ran. With tick == nullptr only frame time and
+    // jitter are recorded (frame pacing for a thread that does not run the ticks itself)
+    int step(SchedTickFn tick, void* user);
+    double alpha() const { return m_last.alpha; }
+    // true once a frame interval has passed since the start of the last step()
+    bool frame_due() const;
+    // wait until then; the wait may return early (e.g. for window messages), so check frame_due()
+    void wait_next_frame();
+
+    const FrameStats& last() const { return m_last; }
+    const FrameTotals& totals() const { return m_totals; }
+
+private:
+    double m_dt, m_interval;
+    int m_maxSteps;
+    SchedClockFn m_now;
+    SchedWaitFn m_wait;
+    void* m_user;
+    double m_prevTime, m_frameStart, m_accum;
+    bool m_started;
+    FrameStats m_last;
+    FrameTotals m_totals;
+};
@@ -0,0 +1,27 @@
+// include/framebuffer.hpp
+#pragma once
+#include <cstdint>
+
+// Caller-owned 32-bit pixel buffer, 0x00RRGGBB per pixel (the layout of a top-down 32bpp
+// Windows DIB). stride is in pixels. All drawing clips to the buffer.
+struct Framebuffer {
+    uint32_t* pixels;
+    int width, height, stride;
+};
+
+struct FbRect { int x0, y0, x1, y1; }; // half-open: [x0,x1) x [y0,y1)
+
+inline uint32_t fb_rgb(int r, int g, int b){ return ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b; }
+
+void fb_clear(Framebuffer& fb, uint32_t color);
+void fb_fill_rect(Framebuffer& fb, int x0, int y0, int x1, int y1, uint32_t color);
+// one color, many rects: the batched path the renderer uses per material
+void fb_fill_rects(Framebuffer& fb, const FbRect* rects, int count, uint32_t color);
+// 1px outline, like GDI FrameRect
+void fb_frame_rect(Framebuffer& fb, int x0, int y0, int x1, int y1, uint32_t color);
+void fb_fill_triangle(Framebuffer& fb, int x0, int y0, int x1, int y1, int x2, int y2, uint32_t color);
+void fb_fill_circle(Framebuffer& fb, int cx, int cy, int radius, uint32_t color);
+// built-in 5x7 font, 6px advance per character at scale 1
+void fb_draw_text(Framebuffer& fb, int x, int y, const char* s, uint32_t color, int scale = 1);
+// binary PPM (P6); returns false if the file cannot be written
+bool fb_write_ppm(const Framebuffer& fb, const char* path);
@@ -1,33 +1,114 @@
 // include/game.hpp
 #pragma once
-#include <windows.h>
+#include <cstdint>
 #include <vector>
+#include "rng.hpp"
+#include "sim_real.hpp"
+#include "world_grid.hpp"
+#include "ship_grid.hpp"
+#include "ship_store.hpp"
+#include "world_stream.hpp"
+#include "flow_field.hpp"
+#include "spatial_hash.hpp"
+#include "drone_store.hpp"
+#include "tick_events.hpp"
 
-enum BlockType { BLOCK_EMPTY=0, BLOCK_ARMOR, BLOCK_THRUSTER, BLOCK_CORE, BLOCK_MINER };
+class ThreadPool;
 
-struct Vec2 { double x,y; Vec2():x(0),y(0){} Vec2(double X,double Y):x(X),y(Y){} double len() const; Vec2 normalized() const; Vec2 operator*(double s) const; Vec2 operator+(const Vec2& o) const; Vec2 operator-(const Vec2& o) const; };
+static const int GRID_CELL = 24;
+// default map size; session_reset() takes any size (storage is sparse, see world_grid.hpp, and
+// generated lazily around the ship, see world_stream.hpp)
+static const int WORLD_COLS = 80;
+static const int WORLD_ROWS = 50;
 
-struct Block { BlockType type; int hp; Block():type(BLOCK_EMPTY),hp(0){} };
+// Ships live in s.ships (see ship_store.hpp): the player's is PLAYER_SHIP and always there,
+// the rest fly themselves (AI ships, session_add_ship()). Each turns about its center of mass;
+// its pos is where its core block's center is.
+static const int PLAYER_SHIP = 0;
 
-struct Ship {
-    int core_r, core_c;
-    double pos_x, pos_y;
-    double angle;
-    Vec2 vel;
-    double angVel;
-    std::vector<std::pair<int,int>> blocks;
-    Ship();
-};
+// A piece cut off a ship when a destroyed block disconnects it from the core goes to s.debris.
+// Its blocks keep their cells relative to the ship's core and pos/angle are where that core
+// would be, so the piece turns about its own center of mass exactly as the ship does. It
+// drifts (no thrust, no collisions) and is gone after DEBRIS_LIFETIME ticks.
+static const int DEBRIS_LIFETIME = 60 * 8;
+static const int DEBRIS_MAX = 256; // the oldest piece goes first beyond this
 
 struct Drone { double x,y; double angle; Vec2 vel; int hp; double cooldown; };
 
-void game_init();
+// one range of one ship's blocks to sweep, and the earliest contact it found
+struct SweepTask { int ship, begin, end; };
+struct SweepHit { SimReal t; int nr, nc; std::vector<CellPos> cells; };
+
+// Per-tick input source, sampled once per tick with the tick number. The simulation is
+// platform-free; the Win32 build wires this to get_input_thrust() from input.cpp, headless
+// tools supply scripted input. nullptr = no thrust.
+typedef Vec2 (*GameInputSource)(int tick, void* user);
+// Called at the end of every tick that ran (paused and finished sessions do not tick), after
+// all phases; replay recording and verification hash the session here. nullptr = none.
+struct Session;
+typedef void (*GameTickHook)(const Session& s, void* user);
+
+// tick phases, in the order a tick runs them. Mining, drones and collisions only read the world
+// (they may run on s.pool) and emit TickEvents; apply makes their changes, in a fixed order,
+// and cuts loose whatever destroyed ship blocks disconnected; debris moves the loose pieces.
+enum GamePhase { PHASE_STREAM=0, PHASE_SHIP_FORCES, PHASE_MINING, PHASE_DRONES, PHASE_COLLISIONS, PHASE_APPLY, PHASE_DEBRIS, PHASE_SPAWN, PHASE_COUNT };
+const char* game_phase_name(int phase);
+
+// One independent game session: all state a tick reads or writes. The game_* functions below
+// drive a process-wide default session; batch tools run as many sessions as they like.
+struct Session {
+    WorldGrid world;
+    WorldStream stream;             // generates/evicts world regions around the ships, logs edits; every
+                                    // ship's reach is resident before a tick reads the world
+    std::vector<StreamFocus> streamFoci; // scratch: every ship's reach, the player's first
+    ShipStore ships;                // PLAYER_SHIP, then AI ships
+    ShipStore debris;               // loose pieces: no throttle, ttl counts down
+    DroneStore drones;
+    FlowField flow;                 // drone pathing toward the ship's core cell, repaired every tick
+    SpatialHash droneHash;          // drone broadphase, rebuilt every tick
+    std::vector<int> droneContacts; // scratch: drones touching the ship this tick
+    std::vector<double> dronePushX, dronePushY; // scratch: separation push per drone
+    std::vector<double> droneTargetX, droneTargetY; // scratch: where each drone steers this tick
+    std::vector<int> minerStart;    // scratch: per ship, its first miner in the concatenated list (ships+1)
+    std::vector<SweepTask> sweepTasks; // scratch: block ranges of the ships that moved
+    std::vector<SweepHit> sweepHits;   // scratch: per task, merged per ship
+    std::vector<int> sweepStart;       // scratch: per ship, its first task (ships+1)
+    std::vector<std::vector<CellPos>> shipContacts; // scratch per worker: cells a ship hit at its earliest contact
+    TickEvents events;              // this tick's world changes, applied by PHASE_APPLY
+    std::vector<CellPos> fragmentCells; // scratch: ShipGrid::detach_after_remove() output
+    std::vector<int> fragmentEnds;
+    ThreadPool* pool;               // runs the read phases in item ranges; nullptr = ticking thread only
+    int resources, score, tickCount;
+    bool paused, gameOver;
+    uint32_t seed;
+    Rng rng;
+    uint64_t checkpointId;          // full save that delta checkpoints are relative to, 0 = none
+    GameInputSource inputSource;
+    void* inputUser;
+    GameTickHook tickHook;
+    void* tickHookUser;
+    Session();
+};
+
+void session_reset(Session& s, uint32_t seed, int rows = WORLD_ROWS, int cols = WORLD_COLS);
+// adds an AI ship made of blocks (core at cell 0,0) with its core at (x,y); returns its index in
+// s.ships. Its autopilot picks a target on its first tick.
+int session_add_ship(Session& s, const ShipGrid& blocks, double x, double y, double angle);
+void session_update(Session& s);
+// same as session_update() but adds the wall time spent in each phase to phaseNs
+void session_update_timed(Session& s, uint64_t phaseNs[PHASE_COUNT]);
+
+Session& game_session();
+void game_set_input_source(GameInputSource src, void* user);
+
+void game_init(uint32_t seed);
 void game_shutdown();
 bool game_is_running();
 void game_request_quit();
 bool game_is_paused();
 bool game_is_over();
 void game_update();
+int game_get_tick();
 
 // accessors for renderer
 int game_get_window_width();
@@ -39,7 +120,13 @@ int game_get_score();
 
 void game_get_player_pos(double &x, double &y);
 double game_get_player_angle();
-const std::vector<Drone>& game_get_drones();
-const Block* game_get_world_ptr(); // pointer to world grid [rows * cols]
+const DroneStore& game_get_drones();
+const WorldGrid& game_get_world(); // iterate occupied chunks with visit_chunks()/chunk()
+// cells whose block type changed since the last game_clear_dirty_cells() (block placement and
+// removal, mining, drone damage, collisions); game_world_generation() changes whenever
+// game_init() replaces the whole world
+const std::vector<CellPos>& game_dirty_cells();
+void game_clear_dirty_cells();
+unsigned game_world_generation();
 int game_world_rows();
 int game_world_cols();
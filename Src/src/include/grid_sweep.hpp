@@ -0,0 +1,39 @@
+// include/grid_sweep.hpp
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include "sim_real.hpp"
+
+// Cell traversal (Amanatides & Woo) of the segment (x0,y0) -> (x1,y1) over square cells of
+// size cell, cell (r,c) covering [c*cell, (c+1)*cell) x [r*cell, (r+1)*cell). Calls
+// fn(r, c, t, nr, nc) for each cell the segment enters after the one it starts in, in order,
+// where t in [0,1] is the fraction of the segment at which it enters and (nr,nc) the normal of
+// the face it crosses (pointing back toward the start). Cost is the number of cells crossed,
+// however long the segment. Stops early when fn returns true (the return value is then true)
+// or once t would exceed tLimit. T is double or Fixed (sim_real.hpp).
+template<class T, class Fn> bool grid_sweep(T x0, T y0, T x1, T y1, int cell, T tLimit, Fn fn){
+    int c = sim_floor(x0 / cell), r = sim_floor(y0 / cell);
+    int cEnd = sim_floor(x1 / cell), rEnd = sim_floor(y1 / cell);
+    T dx = x1 - x0, dy = y1 - y0, zero(0), one(1);
+    int stepC = dx > zero ? 1 : (dx < zero ? -1 : 0), stepR = dy > zero ? 1 : (dy < zero ? -1 : 0);
+    // t at which the segment crosses the next vertical / horizontal cell edge, and per cell
+    T never = sim_huge(dx), tNextC = never, tNextR = never, tDeltaC = never, tDeltaR = never;
+    if(stepC){
+        tDeltaC = std::min(never, T(cell) / sim_abs(dx));
+        tNextC = std::min(never, (stepC > 0 ? T(c + 1) * cell - x0 : x0 - T(c) * cell) / sim_abs(dx));
+    }
+    if(stepR){
+        tDeltaR = std::min(never, T(cell) / sim_abs(dy));
+        tNextR = std::min(never, (stepR > 0 ? T(r + 1) * cell - y0 : y0 - T(r) * cell) / sim_abs(dy));
+    }
+    // the end cell fixes the step count, so rounding in t can never run past it
+    int steps = std::abs(cEnd - c) + std::abs(rEnd - r);
+    for(int k=0;k<steps;k++){
+        T t; int nr = 0, nc = 0;
+        if(tNextC < tNextR){ t = tNextC; c += stepC; tNextC += tDeltaC; nc = -stepC; }
+        else { t = tNextR; r += stepR; tNextR += tDeltaR; nr = -stepR; }
+        if(t > tLimit) return false;
+        if(fn(r, c, t < one ? t : one, nr, nc)) return true;
+    }
+    return false;
+}
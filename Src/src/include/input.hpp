@@ -5,8 +5,17 @@
 
 void input_init(HWND hwnd);
 void input_shutdown();
+// window thread: queues the message as a timestamped event (input_queue.hpp); nothing else
+// changes until the consumer drains the queue
 void input_handle_window_event(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+// window thread, once per message loop pass: queues a pointer move a full queue held back
+void input_flush();
+// consumer (the sim thread, once per tick): applies every queued event to the input state in
+// arrival order. Returns how many; *oldest gets the receipt time of the first of them.
+int input_drain(double* oldest);
+// key and button transitions lost to a full queue (pointer moves are coalesced, not lost)
+unsigned input_dropped_events();
 
-// functions to query input state for game module
+// functions to query input state for game module, as of the last input_drain()
 Vec2 get_input_thrust();
 bool input_is_paused();
@@ -0,0 +1,90 @@
+// include/input_queue.hpp
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Raw input as the window thread received it. time is sched_default_now() at receipt, the
+// same clock the snapshots are stamped with, so latency can be measured against a present.
+enum InputEventKind {
+    INPUT_KEY_DOWN = 0,     // key = virtual key code
+    INPUT_KEY_UP,
+    INPUT_POINTER_DOWN,     // key = button (0 left, 1 right), x/y in window pixels
+    INPUT_POINTER_UP,
+    INPUT_POINTER_MOVE
+};
+
+struct InputEvent {
+    double time;
+    int kind;
+    int key;
+    int x, y;
+};
+
+// Lock-free single-producer/single-consumer ring of input events: the window thread pushes,
+// the sim thread drains everything once at the start of a tick, so every read of the input
+// state within a tick sees the same events. Head and tail live on separate cache lines; each
+// side only ever writes its own index.
+// The consumer keeps level state (keys and buttons held), so a lost up/down would leave it stuck
+// until the next press. Pointer moves therefore stop at MOVE_RESERVE free slots: past that the
+// producer holds the newest one back (later moves replace it, latest position wins) and pushes
+// it ahead of the next event or on flush(). Key and button transitions may use every slot, so
+// a stalled consumer can take at least MOVE_RESERVE / 2 of them after a flood of moves (each may
+// bring its held-back move along); only beyond that is a transition dropped and counted.
+class InputQueue {
+public:
+    static const uint32_t CAPACITY = 4096; // power of two; about a minute of 60 Hz mouse motion
+    static const uint32_t MOVE_RESERVE = 256; // slots only key and button transitions may fill
+
+    InputQueue() : m_head(0), m_tail(0), m_dropped(0), m_coalesced(0), m_hasPending(false) {}
+
+    // --- producer ---
+    // false if a transition was dropped; moves are never refused, only coalesced
+    bool push(const InputEvent& e){
+        if(e.kind == INPUT_POINTER_MOVE){
+            if(m_hasPending) m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            m_pending = e; m_hasPending = true;
+            flush();
+            return true;
+        }
+        // the held-back move happened first, so it goes first (into the reserve if need be)
+        if(m_hasPending && put(m_pending, 0)) m_hasPending = false;
+        if(!m_hasPending && put(e, 0)) return true;
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // pushes the held-back move once there is room; call every so often from the producer.
+    // false while a move is still held back
+    bool flush(){
+        if(m_hasPending && put(m_pending, MOVE_RESERVE)) m_hasPending = false;
+        return !m_hasPending;
+    }
+    // --- consumer ---
+    bool pop(InputEvent& e){
+        uint32_t t = m_tail.load(std::memory_order_relaxed);
+        if(t == m_head.load(std::memory_order_acquire)) return false;
+        e = m_events[t & (CAPACITY - 1)];
+        m_tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    // transitions lost to a full queue so far (any thread)
+    uint32_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    // pointer moves replaced by a newer one while the queue was full (any thread)
+    uint32_t coalesced() const { return m_coalesced.load(std::memory_order_relaxed); }
+
+private:
+    bool put(const InputEvent& e, uint32_t reserve){
+        uint32_t h = m_head.load(std::memory_order_relaxed);
+        if(h - m_tail.load(std::memory_order_acquire) + reserve >= CAPACITY) return false;
+        m_events[h & (CAPACITY - 1)] = e;
+        m_head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    alignas(64) std::atomic<uint32_t> m_head;
+    alignas(64) std::atomic<uint32_t> m_tail;
+    alignas(64) std::atomic<uint32_t> m_dropped;
+    std::atomic<uint32_t> m_coalesced;
+    InputEvent m_pending;   // producer only
+    bool m_hasPending;
+    InputEvent m_events[CAPACITY];
+};
@@ -0,0 +1,62 @@
+// include/net_socket.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minimal stream sockets for the state stream (state_server.hpp). Addresses are
+// "tcp:host:port" (numeric host or a name, e.g. tcp:127.0.0.1:27960) or, on POSIX,
+// "unix:/path" for a Unix domain socket. TCP sockets send without Nagle delay; Winsock is
+// started on first use. Every socket is non-blocking once connected or accepted.
+typedef intptr_t NetSocket;
+static const NetSocket NET_INVALID = -1;
+
+// NET_INVALID on failure. A unix listener replaces a stale socket file at its path.
+NetSocket net_listen(const char* addr);
+// a waiting connection, or NET_INVALID when there is none
+NetSocket net_accept(NetSocket listener);
+// blocks until connected or refused
+NetSocket net_connect(const char* addr);
+void net_close(NetSocket s);
+// closes a listener and removes a unix listener's socket file
+void net_unlisten(NetSocket s, const char* addr);
+// bytes moved, 0 when the socket would block, -1 when it is closed or failed
+long net_send(NetSocket s, const void* p, size_t n);
+long net_recv(NetSocket s, void* p, size_t n);
+// waits up to ms for any of the n sockets to have data (or a connection) to read; false on timeout
+bool net_wait(const NetSocket* socks, int n, int ms);
+
+// Messages over one connection: each goes out as a varint length and its bytes. Sends queue in
+// memory and leave as fast as the socket takes them, so a slow peer never blocks the sender; one
+// more than maxQueued bytes behind is dropped instead of growing the queue without bound.
+class NetLink {
+public:
+    static const size_t MAX_MESSAGE = 64u << 20; // longer incoming lengths close the link
+
+    explicit NetLink(NetSocket s, size_t maxQueued = 16u << 20);
+    ~NetLink();
+    NetLink(const NetLink&) = delete;
+    NetLink& operator=(const NetLink&) = delete;
+
+    bool open() const { return m_sock != NET_INVALID; }
+    void close();
+    NetSocket socket() const { return m_sock; }
+    // queue msg and send what the socket takes now; false if the link is (now) closed
+    bool send(const uint8_t* msg, size_t n);
+    bool send(const std::vector<uint8_t>& msg){ return send(msg.data(), msg.size()); }
+    // send more of the queue; false if the link is closed
+    bool flush();
+    // read what the socket has and pop the next complete message into msg; false if none is
+    // complete yet (or the link is closed: check open())
+    bool receive(std::vector<uint8_t>& msg);
+    size_t queued() const { return m_out.size() - m_outAt; }
+    uint64_t bytes_sent() const { return m_sent; }
+    uint64_t bytes_received() const { return m_received; }
+
+private:
+    NetSocket m_sock;
+    size_t m_maxQueued;
+    std::vector<uint8_t> m_out, m_in;
+    size_t m_outAt, m_inAt;       // consumed prefixes
+    uint64_t m_sent, m_received;
+};
@@ -0,0 +1,59 @@
+// include/profiler.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Scoped hot-path profiler. PROFILE_ZONE("name") times the rest of the enclosing scope and
+// appends {name, start, end} (steady-clock nanoseconds) to the calling thread's ring buffer:
+// no locks, no allocation after a thread's first zone, about two clock reads per zone. Rings
+// keep the newest PROFILE_RING_EVENTS zones per thread and are read without stopping writers
+// (readers skip the slot the writer may be reusing, so they see at most one fewer).
+//
+// Everything is compiled out unless PROFILE_ENABLED is defined: the macros expand to nothing,
+// the stats are empty and export fails, so call sites need no #ifs. Zone and thread names
+// must be string literals (only the pointer is stored).
+static const int PROFILE_RING_EVENTS = 1 << 14;
+
+struct ProfileZoneStats {
+    const char* name;
+    int count;                      // zones completed in the window, all threads
+    double p50Ms, p99Ms, maxMs;
+};
+
+#if defined(PROFILE_ENABLED)
+
+uint64_t profiler_now_ns();
+void profiler_record(const char* name, uint64_t startNs, uint64_t endNs);
+void profiler_thread_name(const char* name);
+
+struct ProfileScope {
+    const char* name;
+    uint64_t start;
+    explicit ProfileScope(const char* n) : name(n), start(profiler_now_ns()) {}
+    ~ProfileScope(){ profiler_record(name, start, profiler_now_ns()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_ZONE(name) ProfileScope PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_THREAD(name) profiler_thread_name(name)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+
+#endif
+
+bool profiler_enabled();
+// p50/p99/max per zone name over the zones that ended in the last windowSec seconds, sorted
+// by name. Reads every thread's ring; safe while they record.
+void profiler_zone_stats(double windowSec, std::vector<ProfileZoneStats>& out);
+// profiler_zone_stats(2 s), recomputed at most every 250 ms: for a HUD redrawn every frame.
+// Call from one thread only.
+const std::vector<ProfileZoneStats>& profiler_rolling_stats();
+// everything still in the rings as Chrome trace-event JSON (chrome://tracing, Perfetto):
+// one complete ("X") event per zone, timestamps in microseconds, one track per thread
+bool profiler_write_chrome_trace(const char* path);
@@ -1,13 +1,20 @@
 // include/render.hpp
 #pragma once
 #include <windows.h>
+#include <string>
 #include <vector>
-#include "game.hpp"
+#include "sim_thread.hpp"
 
 void render_init(HWND hwnd);
 void render_shutdown();
+// force a full world cache rebuild next frame (e.g. after another backend consumed the dirty cells)
+void render_invalidate_cache();
 
-void render_draw_world(HDC hdc);
+// alpha blends ship and drones between the last two ticks (see frame_scheduler.hpp)
+void render_draw_world(HDC hdc, double alpha = 1.0);
+// zoomed-out view in place of render_draw_world: the world summary around the ship at
+// cellsPerPixel map cells per pixel (sim_view_summary(), world_summary.hpp)
+void render_draw_map(HDC hdc, double cellsPerPixel, double alpha = 1.0);
 void render_draw_hud(HDC hdc);
 void render_draw_ui(HDC hdc);
 void render_draw_text(HDC hdc, int x, int y, const char* s, COLORREF color = RGB(255,255,255));
@@ -0,0 +1,17 @@
+// include/render_soft.hpp
+#pragma once
+#include "draw_list.hpp"
+#include "framebuffer.hpp"
+#include "sim_thread.hpp"
+
+// Software backend: the same passes as the GDI renderer in render.hpp, rasterized into a
+// caller-owned Framebuffer. Platform-free, so frames can be profiled and dumped off-Windows.
+// Like the GDI passes it draws the latest sim_view() snapshot; call sim_view_update() first.
+// alpha blends ship and drones between the last two ticks (see frame_scheduler.hpp)
+void render_draw_world(Framebuffer& fb, double alpha = 1.0);
+// zoomed-out view in place of render_draw_world: the world summary around the ship at
+// cellsPerPixel map cells per pixel (sim_view_summary(), world_summary.hpp)
+void render_draw_map(Framebuffer& fb, double cellsPerPixel, double alpha = 1.0);
+void render_draw_hud(Framebuffer& fb);
+void render_draw_ui(Framebuffer& fb);
+void render_draw_text(Framebuffer& fb, int x, int y, const char* s, uint32_t color = 0xFFFFFF, int scale = 1);
@@ -0,0 +1,86 @@
+// include/replay.hpp
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "game.hpp"
+
+// Input recording and deterministic replay. A session is fully determined by its seed, map
+// size and the thrust its input source returned each tick, so a recording is just that: a
+// header, then blocks of per-tick input stored as runs of equal values, plus a 32-bit state
+// hash after every tick. Replays re-run session_update() at full speed and compare hashes,
+// so the first tick that drifts is reported instead of a wrong ending.
+//
+// File: ReplayHeader, then blocks until end of file. Blocks are appended every
+// REPLAY_BLOCK_TICKS ticks and flushed, so a crash loses at most one block.
+static const uint32_t REPLAY_VERSION = 7; // 2: streamed, noise-generated world; 3: ship mass properties; 4: drone flow field; 5: deferred tick events; 6: ship damage and debris; 7: ship and debris pools
+static const int REPLAY_BLOCK_TICKS = 600;
+
+// thrust from firstTick until the next entry's firstTick
+struct ReplayInput { int firstTick; Vec2 thrust; };
+
+struct Replay {
+    uint32_t seed;
+    int rows, cols;
+    int numeric;                      // SIM_NUMERIC of the build that recorded it
+    std::vector<ReplayInput> inputs;  // sorted by firstTick, first one at tick 1
+    std::vector<uint32_t> hashes;     // state hash after tick i+1
+    Replay() : seed(0), rows(0), cols(0), numeric(SIM_NUMERIC) {}
+    int ticks() const { return (int)hashes.size(); }
+};
+
+// Hash of everything a tick evolves: counters, RNG, ship, drones and the cells whose type
+// changed this tick (so it must be taken right after a tick, before clear_changes()).
+uint64_t replay_state_hash(const Session& s);
+
+// Records a session from its first tick. start() wraps s's input source (the wrapped source
+// still drives the session) and installs a tick hook; both run on whichever thread ticks s.
+class ReplayRecorder {
+public:
+    ReplayRecorder();
+    ~ReplayRecorder(){ stop(); }
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    // false if the file cannot be created or s has already ticked (the seed alone would not
+    // reproduce it). Must not be called while another thread ticks s.
+    bool start(Session& s, const char* path);
+    // writes the last partial block and restores s's input source; same threading rule
+    void stop();
+    bool recording() const { return m_file != nullptr; }
+    int ticks() const { return m_ticks; }
+    bool failed() const { return m_failed; } // a write failed; the file ends at the last good block
+
+private:
+    static Vec2 input(int tick, void* user);
+    static void tick(const Session& s, void* user);
+    void flush_block();
+
+    FILE* m_file;
+    Session* m_session;
+    GameInputSource m_inner;
+    void* m_innerUser;
+    int m_ticks, m_blockFirst;
+    Vec2 m_last;                         // thrust of the open run
+    bool m_haveRun, m_failed;
+    std::vector<uint8_t> m_runs;         // encoded runs of the open block
+    std::vector<uint32_t> m_hashes;      // hashes of the open block
+    uint32_t m_runCount;
+    size_t m_runAt;                      // offset of the open run in m_runs
+};
+
+bool replay_load(const char* path, Replay& out);
+
+struct ReplayResult {
+    int ticks;              // ticks simulated
+    int mismatchTick;       // first tick whose hash differs, 0 if none
+    uint32_t expected, actual;
+    double seconds;         // wall time of the simulation loop
+};
+
+// Resets s to the recording's seed and map, then runs its inputs at full speed until the end
+// (or stopTick, if > 0), checking the hash after every tick; a mismatch stops the run there.
+// s keeps its state afterwards, so a bug can be fast-forwarded to and inspected.
+// Returns true if every simulated tick matched; a recording from a build of the other numeric
+// mode (SIM_FIXED_POINT, sim_real.hpp) is not run and fails at tick 1.
+bool replay_run(const Replay& r, Session& s, ReplayResult& res, int stopTick = 0);
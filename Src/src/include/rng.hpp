@@ -0,0 +1,12 @@
+// include/rng.hpp
+#pragma once
+#include <cstdint>
+
+// Small seeded PRNG (xorshift64*) so a whole session is reproducible from its seed.
+struct Rng {
+    uint64_t s;
+    explicit Rng(uint64_t seed = 1){ reseed(seed); }
+    void reseed(uint64_t seed){ s = seed * 0x9E3779B97F4A7C15ull + 0x632BE59BD9B4E019ull; if(!s) s = 1; }
+    uint32_t next(){ s ^= s >> 12; s ^= s << 25; s ^= s >> 27; return (uint32_t)((s * 0x2545F4914F6CDD1Dull) >> 32); }
+    int range(int n){ return (int)(next() % (uint32_t)n); } // same role as rand()%n, n > 0
+};
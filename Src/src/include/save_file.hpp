@@ -0,0 +1,38 @@
+// include/save_file.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game.hpp"
+
+// Binary session snapshots. A full save holds the whole session (counters, RNG state, ships,
+// debris, drones) and the world as run-length encoded chunks; a delta save holds the same small state
+// plus only the world cells written since the full save it is based on, so restoring is
+// "load the full save, apply the newest delta". Everything is 8-byte aligned and
+// little-endian, so a loaded file is decoded in place from a read-only memory mapping.
+// The world is streamed (world_stream.hpp), so both kinds also carry the stream's resident
+// regions and its modification log; only resident chunks are stored, the rest regenerates.
+static const uint32_t SAVE_VERSION = 6; // 3: typed ship blocks with hp; 4: 16-bit world cells; 5: debris; 6: AI ships
+enum SaveKind { SAVE_FULL = 1, SAVE_DELTA = 2 };
+
+struct SaveInfo {
+    uint32_t version, kind;
+    uint64_t id;        // payload checksum; a full save's id is what its deltas refer to
+    uint64_t baseId;    // delta: id of its full save
+    int rows, cols, tick;
+    size_t bytes;
+};
+
+// encode into a buffer; the full save becomes s's delta base (starts touched tracking)
+void save_encode_full(Session& s, std::vector<uint8_t>& out);
+// cells written since the last full save; false if s has no delta base
+bool save_encode_delta(const Session& s, std::vector<uint8_t>& out);
+// decode from memory. A full save replaces s (input source kept) and becomes its delta base;
+// a delta must match s.checkpointId. On failure s is unchanged only if the header is rejected.
+bool save_decode(Session& s, const uint8_t* data, size_t size);
+bool save_read_info(const uint8_t* data, size_t size, SaveInfo& out);
+
+// file wrappers; loads go through a read-only memory mapping
+bool save_write_full(Session& s, const char* path);
+bool save_write_delta(const Session& s, const char* path);
+bool save_load(Session& s, const char* path);
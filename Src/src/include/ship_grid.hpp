@@ -0,0 +1,116 @@
+// include/ship_grid.hpp
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "sim_real.hpp"
+#include "world_grid.hpp"
+
+// Typed block grid of one ship, in cells relative to its core: (0,0) is the core, +c is the
+// ship's right and +r its back (the thrusters push toward -r). Blocks live in parallel arrays
+// so per-tick passes stream through them; removal moves the last block into the hole, so a
+// block's index is only stable until the next remove(), and the role lists are kept in
+// index order.
+//
+// Everything systems ask about the whole ship is kept up to date by add()/remove(): mass,
+// center of mass, moment of inertia, the thruster and miner lists and the thrust torque arm.
+// Nothing is recomputed per tick except the transforms: update_transforms() places every
+// block in the world once, and forces, mining and collisions all read that cache.
+//
+// Blocks hold together through their four edge neighbours and the core (0,0) anchors the
+// ship. Connectivity is never stored; detach_after_remove() re-examines only the region
+// around one removed block (see there).
+
+// blocks may sit at most this many cells from the core in r and c
+static const int SHIP_MAX_EXTENT = 1000;
+
+// mass of one block of each type; the starting ship weighs 10
+double ship_block_mass(BlockType t);
+
+class ShipGrid {
+public:
+    ShipGrid();
+
+    void clear();
+    void reserve(int n);
+    // false if (r,c) is taken, t is BLOCK_EMPTY or r/c are outside +-SHIP_MAX_EXTENT
+    bool add(int r, int c, BlockType t, int hp);
+    // at the type's registry hp
+    bool add(int r, int c, BlockType t){ return add(r, c, t, block_info(t).hp); }
+    bool remove(int r, int c);
+    // index of the block at (r,c), -1 if none
+    int find(int r, int c) const;
+    int size() const { return (int)m_r.size(); }
+
+    int row(int i) const { return m_r[i]; }
+    int col(int i) const { return m_c[i]; }
+    BlockType type(int i) const { return (BlockType)m_type[i]; }
+    int hp(int i) const { return m_hp[i]; }
+    void set_hp(int i, int hp){ m_hp[i] = hp; }
+
+    // block indices by role, ascending, so a grid rebuilt by adding its blocks in index order
+    // (a loaded save) lists them exactly as the original did
+    const std::vector<int>& thrusters() const { return m_thrusters; }
+    const std::vector<int>& miners() const { return m_miners; }
+
+    // mass properties in cell units (lengths in cells, inertia in mass * cells^2, about the
+    // center of mass); each block counts as a uniform unit square. Derived ones are computed
+    // in SimReal from the exact sums
+    double mass() const { return m_mass; }
+    double com_r() const { return sim_to_double(comR()); }
+    double com_c() const { return sim_to_double(comC()); }
+    double inertia() const;
+    // Every thruster pushes toward -r with the same force F; their total torque about the
+    // center of mass is F * thrust_arm() (cells, positive turns +angle).
+    double thrust_arm() const;
+    // largest |r| or |c| of any block: the ship fits in a circle of extent() * 1.5 + 1 cells
+    int extent() const;
+
+    // Transform cache: world position (px) and world cell of every block for a ship whose
+    // core sits at (x,y) turned by angle, with cell px per grid cell. One sin/cos per call,
+    // computed in SimReal. Valid until the ship moves or a block is added or removed.
+    void update_transforms(double x, double y, double angle, int cell);
+    double world_x(int i) const { return m_wx[i]; }
+    double world_y(int i) const { return m_wy[i]; }
+    int world_r(int i) const { return m_wr[i]; }
+    int world_c(int i) const { return m_wc[i]; }
+
+    // Call after remove(r,c): appends every block that no longer reaches the core through its
+    // neighbours to `cells`, one fragment after another, each fragment's end offset to `ends`,
+    // and returns the number of fragments. The blocks stay in the grid, which must have been
+    // connected before the removal (every grid the game builds is). One search starts at
+    // each neighbour of (r,c) and they advance in lockstep: searches that meet merge, one that
+    // runs out of blocks has walked a whole fragment, and once a single search is left open it
+    // holds the core and stops. The work is a few times the size of the fragments cut off, so a
+    // removal that cuts nothing costs about the same on any ship; only a ring that is cut on one
+    // side walks until its two ends meet.
+    int detach_after_remove(int r, int c, std::vector<CellPos>& cells, std::vector<int>& ends);
+
+private:
+    static uint32_t key(int r, int c){ return ((uint32_t)(uint16_t)r << 16) | (uint16_t)c; }
+    SimReal comR() const { return m_mass > 0 ? SimReal(m_sumR) / SimReal(m_mass) : SimReal(0); }
+    SimReal comC() const { return m_mass > 0 ? SimReal(m_sumC) / SimReal(m_mass) : SimReal(0); }
+    std::vector<int>* roleList(BlockType t);
+    void account(int i, double sign);
+
+    std::vector<int16_t> m_r, m_c;
+    std::vector<uint8_t> m_type;
+    std::vector<int> m_hp;
+    std::unordered_map<uint32_t, int> m_index; // key(r,c) -> block
+    std::vector<int> m_thrusters, m_miners;
+
+    // running sums over all blocks: mass, mass-weighted position, mass-weighted r^2 + c^2
+    double m_mass, m_sumR, m_sumC, m_sumSq;
+    double m_thrustSumC;                      // sum of thruster columns
+    mutable int m_extent;                     // -1 = recompute on next extent()
+
+    std::vector<double> m_wx, m_wy;
+    std::vector<int> m_wr, m_wc;
+
+    // detach_after_remove() scratch: per-block visit stamp and owning search, one queue per
+    // search (every block it ever reached, so a finished fragment is its queues)
+    std::vector<uint32_t> m_seen;
+    std::vector<uint8_t> m_owner;
+    uint32_t m_stamp;
+    std::vector<int> m_queue[4];
+};
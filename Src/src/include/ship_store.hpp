@@ -0,0 +1,35 @@
+// include/ship_store.hpp
+#pragma once
+#include <vector>
+#include "ship_grid.hpp"
+
+// Ships as an entity pool: one contiguous array per component, indexed by entity, so a system
+// streams only the components it uses and splits the pool into index ranges for the worker
+// threads. Removal swaps the last entity into the freed slot (like DroneStore), so indices are
+// not stable across removals. The same pool holds debris: bodies nothing steers, with a ttl.
+struct ShipStore {
+    // transform: pos is the core block's center (px); the body turns about its center of mass
+    std::vector<double> x, y, angle;
+    std::vector<double> prevX, prevY, prevAngle; // at the start of the last tick (render interpolation)
+    std::vector<int> coreR, coreC;               // world cell of the core
+    // velocity: px/tick and rad/s
+    std::vector<double> vx, vy, angVel;
+    // blocks, with their mass properties, thruster and miner lists and world transforms
+    std::vector<ShipGrid> grid;
+    // control: thruster throttle for this tick (the player's from the input source, AI ships'
+    // from the autopilot) and the point the autopilot is flying to
+    std::vector<double> throttle;
+    std::vector<double> targetX, targetY;
+    // ticks left, -1 = no limit
+    std::vector<int> ttl;
+
+    int size() const { return (int)x.size(); }
+    bool empty() const { return x.empty(); }
+    void clear();
+    void reserve(int n);
+    // a body at rest with no blocks, no throttle, its target where it is and no ttl; returns its index
+    int add(double px, double py, double a);
+    void remove_swap(int i);
+    // prevX/prevY/prevAngle = x/y/angle; called at the start of a tick
+    void save_prev();
+};
@@ -0,0 +1,51 @@
+// include/sim_real.hpp
+#pragma once
+#include <cmath>
+#include "fixed.hpp"
+
+// SimReal is the number type ticks compute in: poses and velocities, forces, block transforms,
+// sweeps and drone steering. double by default; a build with SIM_FIXED_POINT makes it Fixed,
+// whose results are the same bits from every compiler, flag set and CPU, so replays and state
+// hashes carry across builds. State stays stored as double either way (a Fixed converts to
+// one and back deterministically), so saves, snapshots and rendering do not change.
+#ifdef SIM_FIXED_POINT
+typedef Fixed SimReal;
+static const int SIM_NUMERIC = 1; // recorded in replays: a replay only verifies in its own mode
+#else
+typedef double SimReal;
+static const int SIM_NUMERIC = 0;
+#endif
+
+inline double sim_to_double(double v){ return v; }
+inline double sim_to_double(Fixed v){ return v.to_double(); }
+inline void sim_sin_cos(double a, double& s, double& c){ s = std::sin(a); c = std::cos(a); }
+inline void sim_sin_cos(Fixed a, Fixed& s, Fixed& c){ fixed_sin_cos(a, s, c); }
+inline double sim_sqrt(double v){ return std::sqrt(v); }
+inline Fixed sim_sqrt(Fixed v){ return fixed_sqrt(v); }
+inline double sim_length(double x, double y){ return std::sqrt(x*x + y*y); }
+inline Fixed sim_length(Fixed x, Fixed y){ return fixed_length(x, y); }
+inline double sim_abs(double v){ return std::fabs(v); }
+inline Fixed sim_abs(Fixed v){ return v.raw < 0 ? -v : v; }
+// floor and truncation to int (shifts of negative values are arithmetic on every compiler we
+// build with, and required to be from C++20)
+inline int sim_floor(double v){ return (int)std::floor(v); }
+inline int sim_floor(Fixed v){ return (int)(v.raw >> 32); }
+inline int sim_trunc(double v){ return (int)v; }
+inline int sim_trunc(Fixed v){ return (int)(v.raw / 4294967296ll); }
+// "never" for sweep times (which stay within a few ticks): Fixed keeps room to add to it
+inline double sim_huge(double){ return HUGE_VAL; }
+inline Fixed sim_huge(Fixed){ return Fixed(1 << 28); }
+
+template<class T> struct Vec2T {
+    T x, y;
+    Vec2T() : x(0), y(0) {}
+    Vec2T(T X, T Y) : x(X), y(Y) {}
+    T len() const { return sim_length(x, y); }
+    Vec2T normalized() const { T l = len(); return l > T(1e-9) ? Vec2T(x/l, y/l) : Vec2T(); }
+    Vec2T operator*(T s) const { return Vec2T(x*s, y*s); }
+    Vec2T operator+(const Vec2T& o) const { return Vec2T(x+o.x, y+o.y); }
+    Vec2T operator-(const Vec2T& o) const { return Vec2T(x-o.x, y-o.y); }
+    Vec2T& operator+=(const Vec2T& o){ x+=o.x; y+=o.y; return *this; }
+};
+typedef Vec2T<double> Vec2;     // input, drones' stored state, everything outside a tick
+typedef Vec2T<SimReal> SimVec2; // inside a tick
@@ -0,0 +1,41 @@
+// include/sim_thread.hpp
+#pragma once
+#include "snapshot.hpp"
+
+// Runs game_update() for the default session on its own thread at a fixed tick rate and
+// publishes a SimSnapshot after every tick. The render thread reads only snapshots and a
+// mirror of the world (sim_view_*), so a slow paint never stalls the tick and the tick never
+// waits for a paint. game_init() must not be called while the thread runs.
+void sim_thread_start(double dt = 1.0/60.0);
+void sim_thread_stop();
+bool sim_thread_running();
+// --- sim thread, from the input source during a tick ---
+// the tick consumed input received at `time` (sched_default_now clock); reaches the renderer
+// as SimSnapshot::inputTime
+void sim_thread_note_input(double time);
+
+// --- render thread ---
+// take the newest snapshot and patch the mirror world with its cell changes; without a sim
+// thread this captures the default session directly (headless tools, single-threaded runs).
+// Returns true if anything new arrived.
+bool sim_view_update();
+const SimSnapshot& sim_view();
+const WorldGrid& sim_view_world();
+// mip pyramid of sim_view_world() (world_summary.hpp), for the minimap and map view
+const WorldSummary& sim_view_summary();
+// mirror cells whose block type changed since the last sim_view_clear_dirty_cells()
+const std::vector<CellPos>& sim_view_dirty_cells();
+void sim_view_clear_dirty_cells();
+unsigned sim_view_generation();
+// how far the clock has moved past the newest snapshot, in ticks, clamped to [0,1]
+double sim_view_alpha();
+
+// Input latency, receipt to present: call right after the frame showing sim_view() is
+// presented. The first present of a snapshot reflecting new input records now - inputTime.
+struct InputLatencyStats {
+    long count;                 // samples ever recorded
+    double p50Ms, p99Ms, maxMs; // over the newest INPUT_LATENCY_SAMPLES
+};
+static const int INPUT_LATENCY_SAMPLES = 256;
+void sim_view_note_present(double now);
+const InputLatencyStats& sim_view_input_latency();
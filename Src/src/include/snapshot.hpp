@@ -0,0 +1,97 @@
+// include/snapshot.hpp
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "game.hpp"
+#include "world_summary.hpp"
+
+// A world cell's new block type, as an absolute value: applying a change twice, or applying an
+// older change before a newer one, still ends at the newest state.
+struct CellChange { int r, c; BlockType type; };
+
+// Immutable copy of what the renderer needs from one tick. Owned by a SnapshotChannel; the
+// vectors keep their capacity from one use of a buffer to the next.
+struct SimSnapshot {
+    uint64_t seq;               // publish counter, 0 = never published
+    int tick;
+    double time, dt;            // clock time of publish (sched_default_now) and tick length
+    double shipX, shipY, shipAngle;
+    double shipPrevX, shipPrevY, shipPrevAngle;
+    std::vector<double> droneX, droneY, dronePrevX, dronePrevY;
+    std::vector<double> hullX, hullY, hullPrevX, hullPrevY; // centers of mass of AI ships, then loose pieces
+    std::vector<int> hullBlocks;
+    std::vector<CellChange> cells; // every change since the last snapshot the reader took
+    int resources, score;
+    bool paused, gameOver;
+    unsigned worldGeneration;
+    double inputTime;           // receipt time of the oldest input event no snapshot the reader took reflected yet, 0 = none
+    SimSnapshot():seq(0),tick(0),time(0),dt(0),shipX(0),shipY(0),shipAngle(0),shipPrevX(0),shipPrevY(0),
+        shipPrevAngle(0),resources(0),score(0),paused(false),gameOver(false),worldGeneration(0),inputTime(0){}
+};
+
+// everything but cells/seq/time/inputTime
+void snapshot_capture(SimSnapshot& out, const Session& s, unsigned worldGeneration);
+
+inline void snapshot_ship_lerp(const SimSnapshot& s, double alpha, double& x, double& y){
+    x = s.shipPrevX + (s.shipX - s.shipPrevX) * alpha;
+    y = s.shipPrevY + (s.shipY - s.shipPrevY) * alpha;
+}
+
+// Lock-free triple buffer between one writer (the sim thread) and one reader (the renderer).
+// The writer fills back() and publish()es it; the reader acquire()s the newest published
+// buffer into front(). Neither side ever waits: the three buffers are only ever swapped by
+// one atomic exchange on the shared middle slot, so each side always owns a buffer to itself.
+// A reader that is slower than the writer skips snapshots, so cell changes are carried
+// forward until the writer sees that a snapshot holding them was taken.
+class SnapshotChannel {
+public:
+    SnapshotChannel();
+    // --- writer thread ---
+    SimSnapshot& back(){ return m_buf[m_back]; }
+    // record the current types of the given cells for the next publish()
+    void note_changes(const WorldGrid& world, const std::vector<CellPos>& cells);
+    // a tick consumed input received at `time`; carried like cell changes until a snapshot
+    // reflecting it is taken
+    void note_input(double time);
+    void publish();
+    // --- reader thread ---
+    // true if a newer snapshot was taken into front()
+    bool acquire();
+    const SimSnapshot& front() const { return m_buf[m_front]; }
+
+private:
+    static const unsigned FRESH = 4; // middle slot holds a snapshot the reader has not taken
+
+    SimSnapshot m_buf[3];
+    std::atomic<unsigned> m_middle;
+    int m_back, m_front;
+    // writer only
+    uint64_t m_seq;
+    std::vector<CellChange> m_pending; // changes not yet known to have reached the reader
+    size_t m_lastLen;                  // leading pending entries the last published snapshot carried
+    size_t m_compactAt;
+    double m_inputPending;             // oldest input not yet known to have reached the reader
+    double m_inputNew;                 // oldest input noted since the last publish
+};
+
+// Reader-side mirror of the world, patched from snapshot cell changes so the renderer never
+// touches the live world the sim thread is writing. Cells whose type changed show up in
+// world().changes() until clear_dirty(). summary() keeps the mirror's mip pyramid for the
+// minimap and map view, updated with every change it applies.
+class SnapshotView {
+public:
+    SnapshotView():m_generation(0){}
+    // full copy; only while nothing is writing `live`
+    void sync(const WorldGrid& live, unsigned generation);
+    void apply(const SimSnapshot& s);
+    const WorldGrid& world() const { return m_world; }
+    const WorldSummary& summary() const { return m_summary; }
+    unsigned generation() const { return m_generation; }
+    void clear_dirty(){ m_world.clear_changes(); }
+
+private:
+    WorldGrid m_world;
+    WorldSummary m_summary;
+    unsigned m_generation;
+};
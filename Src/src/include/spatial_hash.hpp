@@ -0,0 +1,98 @@
+// include/spatial_hash.hpp
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "sim_real.hpp"
+
+// Uniform-grid broadphase over points. build() re-buckets every point with a counting sort
+// (O(n), no allocation once the buffers have grown), so it is simply rebuilt each tick.
+// Radius queries visit only the buckets overlapping the query box, i.e. cost tracks the
+// number of nearby points. Cells are hashed into a power-of-two bucket table, so the map can
+// be any size; bucket collisions are filtered by the exact distance test.
+class SpatialHash {
+public:
+    explicit SpatialHash(double cellSize = 24.0) : m_cell(cellSize), m_inv(1.0 / cellSize), m_mask(0) {}
+    void set_cell_size(double cellSize){ m_cell = cellSize; m_inv = 1.0 / cellSize; }
+    double cell_size() const { return m_cell; }
+
+    // pos(i, x, y) writes the position of item i
+    template<class PosFn> void build(int count, PosFn pos);
+    int size() const { return (int)m_items.size(); }
+
+    // calls fn(item, dx, dy, dist2) for every item with dist2 < r*r, where (dx,dy) is the item
+    // position minus (x,y), all SimReal. Visit order is bucket order, not item order.
+    template<class Fn> void query_radius(double x, double y, double r, Fn fn) const;
+    // appends matching item indices to out (unsorted)
+    void collect_radius(double x, double y, double r, std::vector<int>& out) const {
+        query_radius(x, y, r, [&](int i, SimReal, SimReal, SimReal){ out.push_back(i); });
+    }
+
+private:
+    int cell_of(double v) const { return (int)std::floor(v * m_inv); }
+    uint32_t bucket(int cx, int cy) const { return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u) & m_mask; }
+
+    double m_cell, m_inv;
+    uint32_t m_mask;
+    std::vector<uint32_t> m_start;   // bucket -> first slot (size buckets+1)
+    std::vector<uint32_t> m_bucketOf;// item -> bucket (scratch for the sort)
+    std::vector<int> m_items;        // slot -> item index, grouped by bucket
+    std::vector<SimReal> m_x, m_y;   // slot -> position, so queries stream contiguous memory
+    std::vector<int> m_cx, m_cy;     // slot -> cell, to skip other cells sharing a bucket
+};
+
+template<class PosFn> void SpatialHash::build(int count, PosFn pos){
+    uint32_t buckets = 16;
+    while(buckets < (uint32_t)count * 2) buckets <<= 1;
+    m_mask = buckets - 1;
+    m_start.assign(buckets + 1, 0);
+    m_bucketOf.resize(count);
+    m_items.resize(count);
+    m_x.resize(count); m_y.resize(count);
+    m_cx.resize(count); m_cy.resize(count);
+
+    // count, prefix-sum, scatter
+    for(int i=0;i<count;i++){
+        double x, y; pos(i, x, y);
+        uint32_t b = bucket(cell_of(x), cell_of(y));
+        m_bucketOf[i] = b;
+        m_start[b + 1]++;
+    }
+    for(uint32_t b=0;b<buckets;b++) m_start[b + 1] += m_start[b];
+    for(int i=0;i<count;i++){
+        uint32_t slot = m_start[m_bucketOf[i]]++;
+        double x, y; pos(i, x, y);
+        m_items[slot] = i; m_x[slot] = SimReal(x); m_y[slot] = SimReal(y);
+        m_cx[slot] = cell_of(x); m_cy[slot] = cell_of(y);
+    }
+    // scatter advanced every start to its bucket's end; shift back
+    for(uint32_t b=buckets;b>0;b--) m_start[b] = m_start[b - 1];
+    m_start[0] = 0;
+}
+
+template<class Fn> void SpatialHash::query_radius(double x, double y, double r, Fn fn) const {
+    if(m_items.empty()) return;
+    int cx0 = cell_of(x - r), cx1 = cell_of(x + r);
+    int cy0 = cell_of(y - r), cy1 = cell_of(y + r);
+    SimReal qx(x), qy(y), qr(r), r2 = qr * qr;
+    // a query box wider than the table would revisit buckets; fall back to a full scan. Far
+    // items are dropped before squaring: their squares would overflow a Fixed
+    if((uint64_t)(cx1 - cx0 + 1) * (uint64_t)(cy1 - cy0 + 1) > (uint64_t)m_mask + 1){
+        for(size_t k=0;k<m_items.size();k++){
+            SimReal dx = m_x[k] - qx, dy = m_y[k] - qy;
+            if(!(sim_abs(dx) < qr && sim_abs(dy) < qr)) continue;
+            SimReal d2 = dx*dx + dy*dy;
+            if(d2 < r2) fn(m_items[k], dx, dy, d2);
+        }
+        return;
+    }
+    for(int cy=cy0; cy<=cy1; cy++) for(int cx=cx0; cx<=cx1; cx++){
+        uint32_t b = bucket(cx, cy);
+        for(uint32_t k=m_start[b]; k<m_start[b + 1]; k++){
+            // the same bucket can serve several hashed cells; only count it from its own cell
+            if(m_cx[k] != cx || m_cy[k] != cy) continue;
+            SimReal dx = m_x[k] - qx, dy = m_y[k] - qy, d2 = dx*dx + dy*dy;
+            if(d2 < r2) fn(m_items[k], dx, dy, d2);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+// src/batch.cpp
+#include "batch.hpp"
+#include "thread_pool.hpp"
+#include <memory>
+
+const char* batch_outcome_name(BatchOutcome o){
+    switch(o){ case OUTCOME_WON: return "won"; case OUTCOME_LOST: return "lost"; default: return "timeout"; }
+}
+
+void batch_run(ThreadPool& pool, const BatchConfig& cfg, std::vector<BatchResult>& out){
+    out.resize(cfg.sessions > 0 ? cfg.sessions : 0);
+    // one Session per worker, reused for every session it runs so its pools stay warm
+    std::vector<std::unique_ptr<Session>> perWorker(pool.size());
+    for(auto &s : perWorker) s.reset(new Session());
+
+    pool.parallel_for(cfg.sessions, [&](int i, int worker){
+        Session &s = *perWorker[worker];
+        s.inputSource = cfg.input; s.inputUser = cfg.inputUser;
+        session_reset(s, cfg.baseSeed + (uint32_t)i);
+        while(!s.gameOver && s.tickCount < cfg.maxTicks) session_update(s);
+
+        BatchResult &r = out[i];
+        r.seed = s.seed; r.ticks = s.tickCount; r.score = s.score; r.resources = s.resources;
+        r.drones = (int)s.drones.size();
+        r.outcome = !s.gameOver ? OUTCOME_TIMEOUT : (s.resources >= 300 ? OUTCOME_WON : OUTCOME_LOST);
+    });
+}
@@ -0,0 +1,83 @@
+// src/draw_list.cpp
+#include "draw_list.hpp"
+#include <algorithm>
+#include <cmath>
+
+uint32_t draw_material_color(int material){
+    static const uint32_t colors[MAT_COUNT] = {
+        BLOCK_INFO[BLOCK_EMPTY].color, // tile
+        BLOCK_INFO[BLOCK_ARMOR].color,
+        BLOCK_INFO[BLOCK_THRUSTER].color,
+        BLOCK_INFO[BLOCK_CORE].color,
+        BLOCK_INFO[BLOCK_MINER].color,
+        0xB4505A, // drone
+        0xDCC83C, // ship
+    };
+    return (material >= 0 && material < MAT_COUNT) ? colors[material] : 0xB4B4B4;
+}
+
+static void addRect(DrawList& dl, int material, int shape, int x0, int y0, int x1, int y1){
+    DrawItem it; it.material = (uint8_t)material; it.shape = (uint8_t)shape;
+    it.x0 = x0; it.y0 = y0; it.x1 = x1; it.y1 = y1; it.x2 = 0; it.y2 = 0;
+    dl.items.push_back(it);
+}
+
+void draw_list_add_cells(DrawList& dl, const WorldGrid& world, int r0, int c0, int r1, int c1, int ox, int oy){
+    world.visit_chunks(r0, c0, r1, c1, [&](const Chunk &ch){
+        int lr0 = std::max(r0 - ch.row0(), 0), lr1 = std::min(r1 - ch.row0(), CHUNK_SIZE-1);
+        int lc0 = std::max(c0 - ch.col0(), 0), lc1 = std::min(c1 - ch.col0(), CHUNK_SIZE-1);
+        for(int lr=lr0; lr<=lr1; lr++) for(int lc=lc0; lc<=lc1; lc++){
+            const Block &b = ch.at(lr, lc);
+            if(b.empty()) continue;
+            int sx = (ch.col0()+lc)*GRID_CELL - ox, sy = (ch.row0()+lr)*GRID_CELL - oy;
+            int mat = draw_block_material(b.type());
+            addRect(dl, mat, SHAPE_FRAME, sx, sy, sx+GRID_CELL, sy+GRID_CELL);
+            addRect(dl, mat, SHAPE_RECT, sx+3, sy+3, sx+GRID_CELL-3, sy+GRID_CELL-3);
+            dl.cells++;
+        }
+    });
+}
+
+void draw_list_add_entities(DrawList& dl, const Camera& cam, const SimSnapshot& snap, double alpha){
+    int ox = camera_ox(cam), oy = camera_oy(cam);
+    double px, py; snapshot_ship_lerp(snap, alpha, px, py);
+    int sx = (int)(px - cam.x), sy = (int)(py - cam.y);
+    DrawItem ship; ship.material = MAT_SHIP; ship.shape = SHAPE_TRIANGLE;
+    ship.x0 = sx; ship.y0 = sy - 12; ship.x1 = sx - 10; ship.y1 = sy + 12; ship.x2 = sx + 10; ship.y2 = sy + 12;
+    dl.items.push_back(ship);
+
+    // AI ships and debris pieces are frames about as wide as a square of their blocks, around
+    // their center of mass
+    for(size_t k=0;k<snap.hullX.size();k++){
+        double x = snap.hullPrevX[k] + (snap.hullX[k] - snap.hullPrevX[k]) * alpha;
+        double y = snap.hullPrevY[k] + (snap.hullY[k] - snap.hullPrevY[k]) * alpha;
+        int half = (int)(ceil(sqrt((double)snap.hullBlocks[k])) * GRID_CELL / 2);
+        if(x + half < ox || x - half >= ox + cam.viewW || y + half < oy || y - half >= oy + cam.viewH) continue;
+        int dx = (int)(x - cam.x), dy = (int)(y - cam.y);
+        addRect(dl, MAT_SHIP, SHAPE_FRAME, dx-half, dy-half, dx+half, dy+half);
+    }
+
+    // drones are 16px squares; cull against the viewport in world space
+    double minX = ox - 8, minY = oy - 8, maxX = ox + cam.viewW + 8, maxY = oy + cam.viewH + 8;
+    int n = (int)snap.droneX.size();
+    for(int i=0;i<n;i++){
+        double x = snap.dronePrevX[i] + (snap.droneX[i] - snap.dronePrevX[i]) * alpha;
+        double y = snap.dronePrevY[i] + (snap.droneY[i] - snap.dronePrevY[i]) * alpha;
+        if(x < minX || x >= maxX || y < minY || y >= maxY) continue;
+        int dx = (int)(x - cam.x), dy = (int)(y - cam.y);
+        addRect(dl, MAT_DRONE, SHAPE_RECT, dx-8, dy-8, dx+8, dy+8);
+        dl.drones++;
+    }
+}
+
+void draw_list_sort(DrawList& dl){
+    int counts[MAT_COUNT] = {0};
+    for(const DrawItem &it : dl.items) counts[it.material]++;
+    dl.batchStart[0] = 0;
+    for(int m=0;m<MAT_COUNT;m++) dl.batchStart[m+1] = dl.batchStart[m] + counts[m];
+    int next[MAT_COUNT];
+    for(int m=0;m<MAT_COUNT;m++) next[m] = dl.batchStart[m];
+    dl.scratch.resize(dl.items.size());
+    for(const DrawItem &it : dl.items) dl.scratch[next[it.material]++] = it;
+    dl.items.swap(dl.scratch);
+}
@@ -0,0 +1,156 @@
+// src/drone_store.cpp
+#include "drone_store.hpp"
+#include "game.hpp"
+#include "sim_real.hpp"
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define DRONE_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DRONE_SIMD_SSE2 1
+#endif
+
+static const double DRONE_SPEED = 40.0;
+static const double DRONE_STEER = 0.06;
+
+void DroneStore::clear(){
+    x.clear(); y.clear(); vx.clear(); vy.clear(); angle.clear(); cooldown.clear(); hp.clear();
+    prevX.clear(); prevY.clear();
+    ops.clear();
+}
+
+void DroneStore::reserve(int n){
+    x.reserve(n); y.reserve(n); vx.reserve(n); vy.reserve(n); angle.reserve(n); cooldown.reserve(n); hp.reserve(n);
+    prevX.reserve(n); prevY.reserve(n);
+}
+
+void DroneStore::push(const Drone& d){
+    x.push_back(d.x); y.push_back(d.y); vx.push_back(d.vel.x); vy.push_back(d.vel.y);
+    angle.push_back(d.angle); cooldown.push_back(d.cooldown); hp.push_back(d.hp);
+    prevX.push_back(d.x); prevY.push_back(d.y);
+    if(journaling) ops.push_back(-1);
+}
+
+Drone DroneStore::get(int i) const {
+    Drone d; d.x = x[i]; d.y = y[i]; d.vel = Vec2(vx[i], vy[i]); d.angle = angle[i]; d.cooldown = cooldown[i]; d.hp = hp[i];
+    return d;
+}
+
+void DroneStore::remove_swap(int i){
+    if(journaling) ops.push_back(i);
+    int last = size() - 1;
+    if(i != last){
+        x[i] = x[last]; y[i] = y[last]; vx[i] = vx[last]; vy[i] = vy[last];
+        angle[i] = angle[last]; cooldown[i] = cooldown[last]; hp[i] = hp[last];
+        prevX[i] = prevX[last]; prevY[i] = prevY[last];
+    }
+    x.pop_back(); y.pop_back(); vx.pop_back(); vy.pop_back(); angle.pop_back(); cooldown.pop_back(); hp.pop_back();
+    prevX.pop_back(); prevY.pop_back();
+}
+
+void DroneStore::remove_dead(){
+    for(int i=size()-1;i>=0;i--) if(hp[i] <= 0) remove_swap(i);
+}
+
+void DroneStore::save_prev(){
+    prevX = x; prevY = y;
+}
+
+// Same operation order as the old Vec2 code (normalized(), * speed, (desired - vel) * 0.06,
+// vel * (1/60) * 60) so the SIMD paths, which use correctly rounded sqrt/div, match the double
+// instantiation bit for bit unless the compiler contracts the scalar code into FMAs.
+template<class T> static void steerAs(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain){
+    double *X = d.x.data(), *Y = d.y.data(), *VX = d.vx.data(), *VY = d.vy.data();
+    const T speed(DRONE_SPEED), steer(DRONE_STEER), gain(sepGain), eps(1e-9), dt(1.0/60.0), sixty(60.0);
+    for(int i=begin;i<end;i++){
+        T x(X[i]), y(Y[i]), vx(VX[i]), vy(VY[i]);
+        T dx = T(targetX[i]) - x, dy = T(targetY[i]) - y;
+        T l = sim_length(dx, dy);
+        T nx(0), ny(0);
+        if(l > eps){ nx = dx / l; ny = dy / l; }
+        T desX = nx * speed + T(pushX[i]) * gain;
+        T desY = ny * speed + T(pushY[i]) * gain;
+        vx = vx + (desX - vx) * steer;
+        vy = vy + (desY - vy) * steer;
+        x += vx * dt * sixty;
+        y += vy * dt * sixty;
+        X[i] = sim_to_double(x); Y[i] = sim_to_double(y);
+        VX[i] = sim_to_double(vx); VY[i] = sim_to_double(vy);
+    }
+}
+
+void drone_steer_scalar(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain){
+    steerAs<double>(d, begin, end, targetX, targetY, pushX, pushY, sepGain);
+}
+
+void drone_steer_fixed(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain){
+    steerAs<Fixed>(d, begin, end, targetX, targetY, pushX, pushY, sepGain);
+}
+
+#if defined(SIM_FIXED_POINT)
+void drone_steer(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain){
+    drone_steer_fixed(d, begin, end, targetX, targetY, pushX, pushY, sepGain);
+}
+const char* drone_steer_isa(){ return "fixed"; }
+#elif defined(DRONE_SIMD_AVX)
+void drone_steer(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain){
+    double *X = d.x.data(), *Y = d.y.data(), *VX = d.vx.data(), *VY = d.vy.data();
+    const __m256d speed = _mm256_set1_pd(DRONE_SPEED), gain = _mm256_set1_pd(sepGain);
+    const __m256d steer = _mm256_set1_pd(DRONE_STEER), eps = _mm256_set1_pd(1e-9);
+    const __m256d dt = _mm256_set1_pd(1.0/60.0), sixty = _mm256_set1_pd(60.0);
+    int i = begin;
+    for(; i + 4 <= end; i += 4){
+        __m256d x = _mm256_loadu_pd(X + i), y = _mm256_loadu_pd(Y + i);
+        __m256d vx = _mm256_loadu_pd(VX + i), vy = _mm256_loadu_pd(VY + i);
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(targetX + i), x), dy = _mm256_sub_pd(_mm256_loadu_pd(targetY + i), y);
+        __m256d l = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+        __m256d ok = _mm256_cmp_pd(l, eps, _CMP_GT_OQ);
+        __m256d nx = _mm256_and_pd(_mm256_div_pd(dx, l), ok);
+        __m256d ny = _mm256_and_pd(_mm256_div_pd(dy, l), ok);
+        __m256d desX = _mm256_add_pd(_mm256_mul_pd(nx, speed), _mm256_mul_pd(_mm256_loadu_pd(pushX + i), gain));
+        __m256d desY = _mm256_add_pd(_mm256_mul_pd(ny, speed), _mm256_mul_pd(_mm256_loadu_pd(pushY + i), gain));
+        vx = _mm256_add_pd(vx, _mm256_mul_pd(_mm256_sub_pd(desX, vx), steer));
+        vy = _mm256_add_pd(vy, _mm256_mul_pd(_mm256_sub_pd(desY, vy), steer));
+        x = _mm256_add_pd(x, _mm256_mul_pd(_mm256_mul_pd(vx, dt), sixty));
+        y = _mm256_add_pd(y, _mm256_mul_pd(_mm256_mul_pd(vy, dt), sixty));
+        _mm256_storeu_pd(X + i, x); _mm256_storeu_pd(Y + i, y);
+        _mm256_storeu_pd(VX + i, vx); _mm256_storeu_pd(VY + i, vy);
+    }
+    drone_steer_scalar(d, i, end, targetX, targetY, pushX, pushY, sepGain);
+}
+const char* drone_steer_isa(){ return "avx"; }
+#elif defined(DRONE_SIMD_SSE2)
+void drone_steer(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain){
+    double *X = d.x.data(), *Y = d.y.data(), *VX = d.vx.data(), *VY = d.vy.data();
+    const __m128d speed = _mm_set1_pd(DRONE_SPEED), gain = _mm_set1_pd(sepGain);
+    const __m128d steer = _mm_set1_pd(DRONE_STEER), eps = _mm_set1_pd(1e-9);
+    const __m128d dt = _mm_set1_pd(1.0/60.0), sixty = _mm_set1_pd(60.0);
+    int i = begin;
+    for(; i + 2 <= end; i += 2){
+        __m128d x = _mm_loadu_pd(X + i), y = _mm_loadu_pd(Y + i);
+        __m128d vx = _mm_loadu_pd(VX + i), vy = _mm_loadu_pd(VY + i);
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(targetX + i), x), dy = _mm_sub_pd(_mm_loadu_pd(targetY + i), y);
+        __m128d l = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+        __m128d ok = _mm_cmpgt_pd(l, eps);
+        __m128d nx = _mm_and_pd(_mm_div_pd(dx, l), ok);
+        __m128d ny = _mm_and_pd(_mm_div_pd(dy, l), ok);
+        __m128d desX = _mm_add_pd(_mm_mul_pd(nx, speed), _mm_mul_pd(_mm_loadu_pd(pushX + i), gain));
+        __m128d desY = _mm_add_pd(_mm_mul_pd(ny, speed), _mm_mul_pd(_mm_loadu_pd(pushY + i), gain));
+        vx = _mm_add_pd(vx, _mm_mul_pd(_mm_sub_pd(desX, vx), steer));
+        vy = _mm_add_pd(vy, _mm_mul_pd(_mm_sub_pd(desY, vy), steer));
+        x = _mm_add_pd(x, _mm_mul_pd(_mm_mul_pd(vx, dt), sixty));
+        y = _mm_add_pd(y, _mm_mul_pd(_mm_mul_pd(vy, dt), sixty));
+        _mm_storeu_pd(X + i, x); _mm_storeu_pd(Y + i, y);
+        _mm_storeu_pd(VX + i, vx); _mm_storeu_pd(VY + i, vy);
+    }
+    drone_steer_scalar(d, i, end, targetX, targetY, pushX, pushY, sepGain);
+}
+const char* drone_steer_isa(){ return "sse2"; }
+#else
+void drone_steer(DroneStore& d, int begin, int end, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double sepGain){
+    drone_steer_scalar(d, begin, end, targetX, targetY, pushX, pushY, sepGain);
+}
+const char* drone_steer_isa(){ return "scalar"; }
+#endif
@@ -0,0 +1,130 @@
+// src/fixed.cpp
+#include "fixed.hpp"
+#include <cmath>
+
+static const int64_t FIXED_MAX = INT64_MAX, FIXED_MIN = INT64_MIN;
+
+// unsigned 64 x 64 -> 128 from 32-bit halves
+static void mulWide(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo){
+    uint64_t a0 = a & 0xffffffffu, a1 = a >> 32, b0 = b & 0xffffffffu, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffu) + (p10 & 0xffffffffu);
+    lo = (p00 & 0xffffffffu) | (mid << 32);
+    hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+static bool lessWide(uint64_t ah, uint64_t al, uint64_t bh, uint64_t bl){ return ah != bh ? ah < bh : al < bl; }
+
+// floor of the square root of hi:lo. The FPU only seeds it: the root is corrected against exact
+// 128-bit squares, so the result is the same whatever the seed
+static uint64_t isqrtWide(uint64_t hi, uint64_t lo){
+    if(hi == 0 && lo == 0) return 0;
+    double g = std::sqrt((double)hi * 18446744073709551616.0 + (double)lo);
+    uint64_t r = g >= 18446744073709551615.0 ? 0xffffffffffffffffull : (uint64_t)g;
+    uint64_t sh, sl;
+    for(;;){ // r*r > n: too big
+        mulWide(r, r, sh, sl);
+        if(!lessWide(hi, lo, sh, sl)) break;
+        r--;
+    }
+    while(r != 0xffffffffffffffffull){ // (r+1)^2 <= n: too small
+        mulWide(r + 1, r + 1, sh, sl);
+        if(lessWide(hi, lo, sh, sl)) break;
+        r++;
+    }
+    return r;
+}
+
+int64_t fixed_detail::div(int64_t a, int64_t b){
+    if(b == 0) return a >= 0 ? FIXED_MAX : FIXED_MIN;
+    bool neg = (a < 0) != (b < 0);
+    uint64_t ua = a < 0 ? 0 - (uint64_t)a : (uint64_t)a, ub = b < 0 ? 0 - (uint64_t)b : (uint64_t)b;
+    // |a| << 32 over |b|, toward zero
+    uint64_t q;
+#if defined(__SIZEOF_INT128__) && !defined(FIXED_NO_INT128)
+    unsigned __int128 wide = ((unsigned __int128)ua << 32) / ub;
+    if(wide > (unsigned __int128)FIXED_MAX + neg) return neg ? FIXED_MIN : FIXED_MAX;
+    q = (uint64_t)wide;
+#elif defined(_MSC_VER) && defined(_M_X64) && !defined(FIXED_NO_INT128)
+    if((ua >> 32) >= ub) return neg ? FIXED_MIN : FIXED_MAX; // the quotient needs 64+ bits
+    uint64_t rem;
+    q = _udiv128(ua >> 32, ua << 32, ub, &rem);
+    if(q > (uint64_t)FIXED_MAX + neg) return neg ? FIXED_MIN : FIXED_MAX;
+#else
+    uint64_t nh = ua >> 32, nl = ua << 32, rem = 0, qh = 0;
+    q = 0;
+    for(int bit=127;bit>=0;bit--){ // restoring division; rem < ub <= 2^63 never overflows
+        rem = rem << 1 | ((bit >= 64 ? nh >> (bit - 64) : nl >> bit) & 1);
+        qh = qh << 1 | q >> 63; q <<= 1;
+        if(rem >= ub){ rem -= ub; q |= 1; }
+    }
+    if(qh != 0 || q > (uint64_t)FIXED_MAX + neg) return neg ? FIXED_MIN : FIXED_MAX;
+#endif
+    return neg ? (int64_t)(0 - q) : (int64_t)q;
+}
+
+// sin over one quarter turn at FIXED_TRIG_SIZE + 1 points, from a Taylor series summed in
+// Q3.61 integers, so the table is the same bits wherever it is built
+struct SinTable {
+    int64_t v[FIXED_TRIG_SIZE + 1];
+    SinTable(){
+        const uint64_t HALF_PI = 3622009729038561421ull; // pi/2 in Q3.61
+        for(int i=0;i<=FIXED_TRIG_SIZE;i++){
+            uint64_t h, l;
+            mulWide(HALF_PI, (uint64_t)i, h, l);
+            uint64_t x = (h << (64 - FIXED_TRIG_BITS)) | (l >> FIXED_TRIG_BITS);
+            mulWide(x, x, h, l);
+            uint64_t x2 = (h << 3) | (l >> 61);
+            // terms x^(2k+1)/(2k+1)! fall below 2^-61 by k = 11
+            uint64_t term = x, sum = x;
+            for(int k=1;k<=11;k++){
+                mulWide(term, x2, h, l);
+                term = ((h << 3) | (l >> 61)) / (uint64_t)((2 * k) * (2 * k + 1));
+                if(k & 1) sum -= term; else sum += term;
+            }
+            v[i] = (int64_t)((sum + (1ull << 28)) >> 29);
+        }
+    }
+};
+
+void fixed_sin_cos(Fixed angle, Fixed& s, Fixed& c){
+    static const SinTable table;
+    const int64_t *T = table.v;
+    // turns in Q32 from radians: (angle * 2^64/2pi) >> 64, of which only the fraction matters
+    const uint64_t INV_TWO_PI = 2935890503282001226ull; // 1/(2pi) in Q0.64
+    uint64_t ua = angle.raw < 0 ? 0 - (uint64_t)angle.raw : (uint64_t)angle.raw, h, l;
+    mulWide(ua, INV_TWO_PI, h, l);
+    uint32_t phase = (uint32_t)h;
+    if(angle.raw < 0) phase = 0 - phase - (l != 0 ? 1 : 0); // floor of the negated product
+    const int FRAC_BITS = 30 - FIXED_TRIG_BITS;
+    uint32_t quadrant = phase >> 30, p = phase & 0x3fffffffu;
+    int idx = (int)(p >> FRAC_BITS);
+    int64_t frac = p & ((1u << FRAC_BITS) - 1);
+    // within the quarter: sin rising from T[idx], cos falling from T[SIZE - idx]
+    int64_t sq = T[idx], cq = T[FIXED_TRIG_SIZE - idx];
+    sq += (T[idx + 1] - sq) * frac >> FRAC_BITS;
+    cq += (T[FIXED_TRIG_SIZE - idx - 1] - cq) * frac >> FRAC_BITS;
+    switch(quadrant){
+    case 0: s = Fixed::from_raw(sq); c = Fixed::from_raw(cq); break;
+    case 1: s = Fixed::from_raw(cq); c = Fixed::from_raw(-sq); break;
+    case 2: s = Fixed::from_raw(-sq); c = Fixed::from_raw(-cq); break;
+    default: s = Fixed::from_raw(-cq); c = Fixed::from_raw(sq); break;
+    }
+}
+
+Fixed fixed_sqrt(Fixed v){
+    if(v.raw <= 0) return Fixed();
+    // sqrt(raw * 2^32) is the root in Q32
+    return Fixed::from_raw((int64_t)isqrtWide((uint64_t)v.raw >> 32, (uint64_t)v.raw << 32));
+}
+
+Fixed fixed_length(Fixed x, Fixed y){
+    uint64_t ux = x.raw < 0 ? 0 - (uint64_t)x.raw : (uint64_t)x.raw, uy = y.raw < 0 ? 0 - (uint64_t)y.raw : (uint64_t)y.raw;
+    uint64_t xh, xl, yh, yl;
+    mulWide(ux, ux, xh, xl);
+    mulWide(uy, uy, yh, yl);
+    uint64_t lo = xl + yl, hi = xh + yh + (lo < xl ? 1 : 0);
+    // both squares are below 2^126, so the sum fits; the root can pass the Fixed range
+    uint64_t r = isqrtWide(hi, lo);
+    return Fixed::from_raw(r > (uint64_t)FIXED_MAX ? FIXED_MAX : (int64_t)r);
+}
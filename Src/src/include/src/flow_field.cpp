@@ -0,0 +1,222 @@
+// src/flow_field.cpp
+#include "flow_field.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+
+static const int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+static const int WINDOW_CHUNKS = FLOW_SIZE >> CHUNK_SHIFT;
+static const int ROW = FLOW_SIZE + 2; // FlowField::STRIDE
+
+// neighbour k: index offset, cost, the opposite direction, row/column step, and for diagonals
+// the two orthogonal cells the move passes between
+static const int OFF[8] = { -ROW, ROW, -1, 1, -ROW - 1, -ROW + 1, ROW - 1, ROW + 1 };
+static const int COST[8] = { FLOW_ORTHO, FLOW_ORTHO, FLOW_ORTHO, FLOW_ORTHO, FLOW_DIAG, FLOW_DIAG, FLOW_DIAG, FLOW_DIAG };
+static const int OPP[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+static const int DR[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+static const int DC[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+static const int CORNER_R[8] = { 0, 0, 0, 0, -ROW, -ROW, ROW, ROW };
+static const int CORNER_C[8] = { 0, 0, 0, 0, -1, 1, -1, 1 };
+
+FlowField::FlowField(){
+    m_r0 = 0; m_c0 = 0;
+    m_srcR = 0; m_srcC = 0; m_src = 0;
+    m_bias = 0;
+    m_valid = false;
+    m_stats.rebuilds = 0; m_stats.repairs = 0; m_stats.lastCells = 0;
+}
+
+void FlowField::reset(){
+    m_valid = false;
+    m_dirty.clear();
+}
+
+bool FlowField::can_step(int from, int k) const {
+    if(m_solid[from + OFF[k]]) return false;
+    return k < 4 || (!m_solid[from + CORNER_R[k]] && !m_solid[from + CORNER_C[k]]);
+}
+
+void FlowField::note_writes(const WorldGrid& w, const std::vector<CellPos>& written){
+    if(!m_valid) return;
+    for(const CellPos &p : written){
+        if(!in_window(p.r, p.c)) continue;
+        int i = index(p.r, p.c);
+        uint8_t solid = !w.in_grid(p.r, p.c) || !w.get(p.r, p.c).empty();
+        if(solid == m_solid[i]) continue;
+        m_solid[i] = solid;
+        m_dirty.push_back(i);
+    }
+}
+
+// Chunk-aligned window with (r,c) near its middle. Chunks the old window already held are
+// copied (it is kept current by note_writes), the rest come from the stream.
+void FlowField::place_window(const WorldGrid& w, const WorldStream& st, int r, int c){
+    int r0 = ((r - FLOW_SIZE / 2 + CHUNK_SIZE / 2) >> CHUNK_SHIFT) << CHUNK_SHIFT;
+    int c0 = ((c - FLOW_SIZE / 2 + CHUNK_SIZE / 2) >> CHUNK_SHIFT) << CHUNK_SHIFT;
+    m_scratchSolid.assign(ROW * ROW, 1);
+    m_chunk.resize(CHUNK_CELLS);
+    for(int i=0;i<WINDOW_CHUNKS;i++) for(int j=0;j<WINDOW_CHUNKS;j++){
+        int cr0 = r0 + (i << CHUNK_SHIFT), cc0 = c0 + (j << CHUNK_SHIFT);
+        uint8_t *dst = &m_scratchSolid[(cr0 - r0 + 1) * ROW + (cc0 - c0 + 1)];
+        if(m_valid && in_window(cr0, cc0) && in_window(cr0 + CHUNK_MASK, cc0 + CHUNK_MASK)){
+            const uint8_t *src = &m_solid[index(cr0, cc0)];
+            for(int k=0;k<CHUNK_SIZE;k++) std::copy(src + k * ROW, src + k * ROW + CHUNK_SIZE, dst + k * ROW);
+            continue;
+        }
+        if(cr0 >= w.rows() || cc0 >= w.cols() || cr0 + CHUNK_SIZE <= 0 || cc0 + CHUNK_SIZE <= 0) continue; // off the map: solid
+        st.chunk_blocks(w, cr0 >> CHUNK_SHIFT, cc0 >> CHUNK_SHIFT, m_chunk.data());
+        for(int k=0;k<CHUNK_CELLS;k++){
+            int lr = k >> CHUNK_SHIFT, lc = k & CHUNK_MASK;
+            dst[lr * ROW + lc] = !w.in_grid(cr0 + lr, cc0 + lc) || !m_chunk[k].empty();
+        }
+    }
+    m_solid.swap(m_scratchSolid);
+    m_r0 = r0; m_c0 = c0;
+    m_dist.assign(ROW * ROW, FLOW_UNREACHED);
+    m_invalid.assign(ROW * ROW, 0);
+}
+
+// Dial's algorithm from m_seeds ({stored distance, cell}, any order): cells are settled in
+// distance order, so each is expanded once per value it finally keeps
+void FlowField::propagate(){
+    std::sort(m_seeds.begin(), m_seeds.end());
+    size_t si = 0;
+    long pending = 0;
+    int cells = 0;
+    int32_t d = m_seeds.empty() ? 0 : m_seeds[0].first;
+    while(si < m_seeds.size() || pending > 0){
+        if(pending == 0 && m_seeds[si].first > d) d = m_seeds[si].first;
+        for(; si < m_seeds.size() && m_seeds[si].first == d; si++){ m_buckets[d & 3].push_back(m_seeds[si].second); pending++; }
+        std::vector<int> &b = m_buckets[d & 3];
+        for(size_t q=0;q<b.size();q++){
+            int c = b[q];
+            if(m_dist[c] != d) continue; // lowered again after it was queued
+            cells++;
+            if(m_solid[c] && c != m_src) continue;
+            for(int k=0;k<8;k++){
+                int n = c + OFF[k];
+                int32_t nd = d + COST[k];
+                if(nd < m_dist[n] && can_step(c, k)){ m_dist[n] = nd; m_buckets[nd & 3].push_back(n); pending++; }
+            }
+        }
+        pending -= (long)b.size();
+        b.clear();
+        d++;
+    }
+    m_seeds.clear();
+    m_stats.lastCells += cells;
+}
+
+void FlowField::rebuild(){
+    std::fill(m_dist.begin(), m_dist.end(), FLOW_UNREACHED);
+    m_bias = 0;
+    m_dist[m_src] = 0;
+    m_seeds.clear();
+    m_seeds.push_back(std::make_pair(0, m_src));
+    m_stats.lastCells = 0;
+    propagate();
+    m_dirty.clear();
+    m_valid = true;
+    m_stats.rebuilds++;
+}
+
+// Source fixed, m_dirty changed solidity. A cell keeps its distance while some valid
+// neighbour still leads to it at that distance; otherwise it is invalidated and its dependents
+// (neighbours exactly one step further) are checked in turn. Then the invalidated cells and
+// everything around the edits take the best their neighbours offer and propagate.
+void FlowField::repair(){
+    m_queue.clear(); m_stale.clear(); m_seeds.clear();
+    for(int i : m_dirty){
+        m_queue.push_back(i);
+        for(int k=0;k<8;k++) m_queue.push_back(i + OFF[k]);
+    }
+    for(size_t q=0;q<m_queue.size();q++){
+        int c = m_queue[q];
+        if(m_invalid[c] || m_dist[c] == FLOW_UNREACHED || c == m_src) continue;
+        bool supported = false;
+        if(!m_solid[c]) for(int k=0;k<8 && !supported;k++){
+            int n = c + OFF[k];
+            supported = !m_invalid[n] && m_dist[n] != FLOW_UNREACHED && m_dist[n] + COST[k] == m_dist[c]
+                && (!m_solid[n] || n == m_src) && can_step(n, OPP[k]);
+        }
+        if(supported) continue;
+        m_invalid[c] = 1;
+        m_stale.push_back(c);
+        for(int k=0;k<8;k++){
+            int n = c + OFF[k];
+            if(!m_invalid[n] && m_dist[n] != FLOW_UNREACHED && m_dist[n] == m_dist[c] + COST[k]) m_queue.push_back(n);
+        }
+    }
+    for(int c : m_stale){ m_dist[c] = FLOW_UNREACHED; m_invalid[c] = 0; }
+
+    auto reseed = [&](int c){
+        if(m_solid[c] && c != m_src) return;
+        int32_t best = m_dist[c];
+        for(int k=0;k<8;k++){
+            int n = c + OFF[k];
+            if(m_dist[n] == FLOW_UNREACHED || (m_solid[n] && n != m_src) || !can_step(n, OPP[k])) continue;
+            best = std::min(best, m_dist[n] + COST[k]);
+        }
+        if(best < m_dist[c]){ m_dist[c] = best; m_seeds.push_back(std::make_pair(best, c)); }
+    };
+    for(int c : m_stale) reseed(c);
+    for(int i : m_dirty){
+        reseed(i);
+        for(int k=0;k<8;k++) reseed(i + OFF[k]);
+    }
+    propagate();
+}
+
+// Every cell's distance to the old source plus the old source's distance to the new one is
+// the length of a real path, so raising the bias by that much leaves a field of valid upper
+// bounds; relaxing from the new source then lowers exactly the cells the move brought closer.
+// Not when the old source was solid: paths through it were only allowed while it was the source.
+bool FlowField::move_source(int src){
+    if(m_dist[src] == FLOW_UNREACHED || m_solid[m_src]) return false;
+    m_bias += m_dist[src] + m_bias;
+    m_src = src;
+    m_dist[src] = -m_bias;
+    m_seeds.clear();
+    m_seeds.push_back(std::make_pair(m_dist[src], src));
+    propagate();
+    return true;
+}
+
+void FlowField::update(const WorldGrid& w, const WorldStream& st, int r, int c){
+    PROFILE_ZONE("flow_field");
+    bool inside = m_valid && r - m_r0 >= FLOW_RECENTER && m_r0 + FLOW_SIZE - 1 - r >= FLOW_RECENTER
+        && c - m_c0 >= FLOW_RECENTER && m_c0 + FLOW_SIZE - 1 - c >= FLOW_RECENTER;
+    if(!inside){
+        place_window(w, st, r, c);
+        m_srcR = r; m_srcC = c; m_src = index(r, c);
+        rebuild();
+        return;
+    }
+    int src = index(r, c);
+    if(m_dirty.empty() && src == m_src){ m_stats.lastCells = 0; return; }
+    m_stats.lastCells = 0;
+    if(!m_dirty.empty()){ repair(); m_dirty.clear(); }
+    m_srcR = r; m_srcC = c;
+    if(src != m_src && !move_source(src)){ m_src = src; rebuild(); return; }
+    m_stats.repairs++;
+}
+
+int32_t FlowField::distance(int r, int c) const {
+    if(!m_valid || !in_window(r, c)) return FLOW_UNREACHED;
+    int32_t d = m_dist[index(r, c)];
+    return d == FLOW_UNREACHED ? FLOW_UNREACHED : d + m_bias;
+}
+
+bool FlowField::step(int r, int c, int& nr, int& nc) const {
+    if(!m_valid || !in_window(r, c)) return false;
+    int i = index(r, c);
+    int32_t best = m_dist[i];
+    if(best == FLOW_UNREACHED || i == m_src) return false;
+    int bk = -1;
+    for(int k=0;k<8;k++){
+        int n = i + OFF[k];
+        if(m_dist[n] < best && can_step(i, k)){ best = m_dist[n]; bk = k; }
+    }
+    if(bk < 0) return false;
+    nr = r + DR[bk]; nc = c + DC[bk];
+    return true;
+}
@@ -0,0 +1,80 @@
+// src/frame_scheduler.cpp
+#include "frame_scheduler.hpp"
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+double sched_default_now(void*){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void sched_precise_wait(double seconds, void*){
+    if(seconds <= 0) return;
+    double until = sched_default_now(nullptr) + seconds;
+    // OS sleeps overshoot by up to a scheduler quantum: sleep short, then yield-spin to the deadline
+    if(seconds > 0.002) std::this_thread::sleep_for(std::chrono::duration<double>(seconds - 0.0015));
+    while(sched_default_now(nullptr) < until) std::this_thread::yield();
+}
+
+FrameScheduler::FrameScheduler(double dt, int maxSteps){
+    m_dt = dt; m_interval = dt;
+    m_maxSteps = maxSteps > 0 ? maxSteps : 1;
+    m_now = sched_default_now; m_wait = sched_precise_wait; m_user = nullptr;
+    reset();
+}
+
+void FrameScheduler::set_clock(SchedClockFn now, SchedWaitFn wait, void* user){
+    m_now = now; m_wait = wait; m_user = user;
+    reset();
+}
+
+void FrameScheduler::reset(){
+    m_started = false;
+    m_prevTime = m_frameStart = 0;
+    m_accum = 0;
+    m_last = FrameStats();
+    m_last.alpha = 1.0;
+    m_totals = FrameTotals();
+}
+
+int FrameScheduler::step(SchedTickFn tick, void* user){
+    double now = m_now(m_user);
+    if(!m_started){ m_prevTime = now; m_started = true; }
+    FrameStats st = FrameStats();
+    st.frameTime = now - m_prevTime;
+    m_prevTime = now;
+    m_frameStart = now;
+    if(tick) m_accum += st.frameTime;
+
+    while(m_accum >= m_dt && st.ticks < m_maxSteps){
+        tick(user);
+        m_accum -= m_dt;
+        st.ticks++;
+    }
+    if(m_accum >= m_dt){
+        // over the cap: keep the fractional tick so alpha stays continuous, drop whole ticks
+        st.dropped = std::floor(m_accum / m_dt) * m_dt;
+        m_accum -= st.dropped;
+        m_totals.cappedFrames++;
+    }
+    st.alpha = m_accum / m_dt;
+    // the first frame has no previous frame to measure against
+    st.jitter = m_totals.frames > 0 ? std::fabs(st.frameTime - m_interval) : 0;
+
+    m_totals.frames++;
+    m_totals.ticks += st.ticks;
+    m_totals.dropped += st.dropped;
+    m_totals.sumJitter += st.jitter;
+    if(st.jitter > m_totals.maxJitter) m_totals.maxJitter = st.jitter;
+    m_last = st;
+    return st.ticks;
+}
+
+bool FrameScheduler::frame_due() const {
+    return !m_started || m_now(m_user) >= m_frameStart + m_interval;
+}
+
+void FrameScheduler::wait_next_frame(){
+    double left = m_frameStart + m_interval - m_now(m_user);
+    if(left > 0) m_wait(left, m_user);
+}
@@ -0,0 +1,117 @@
+// src/framebuffer.cpp
+#include "framebuffer.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+void fb_clear(Framebuffer& fb, uint32_t color){
+    fb_fill_rect(fb, 0, 0, fb.width, fb.height, color);
+}
+
+void fb_fill_rect(Framebuffer& fb, int x0, int y0, int x1, int y1, uint32_t color){
+    x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+    x1 = std::min(x1, fb.width); y1 = std::min(y1, fb.height);
+    if(x0 >= x1 || y0 >= y1) return;
+    for(int y=y0;y<y1;y++){
+        uint32_t* row = fb.pixels + (size_t)y * fb.stride;
+        std::fill(row + x0, row + x1, color);
+    }
+}
+
+void fb_fill_rects(Framebuffer& fb, const FbRect* rects, int count, uint32_t color){
+    for(int i=0;i<count;i++) fb_fill_rect(fb, rects[i].x0, rects[i].y0, rects[i].x1, rects[i].y1, color);
+}
+
+void fb_frame_rect(Framebuffer& fb, int x0, int y0, int x1, int y1, uint32_t color){
+    if(x0 >= x1 || y0 >= y1) return;
+    fb_fill_rect(fb, x0, y0, x1, y0+1, color);
+    fb_fill_rect(fb, x0, y1-1, x1, y1, color);
+    fb_fill_rect(fb, x0, y0+1, x0+1, y1-1, color);
+    fb_fill_rect(fb, x1-1, y0+1, x1, y1-1, color);
+}
+
+void fb_fill_triangle(Framebuffer& fb, int x0, int y0, int x1, int y1, int x2, int y2, uint32_t color){
+    // scanline fill: for each row, intersect the three edges and fill between the extremes
+    int ymin = std::max(std::min(y0, std::min(y1, y2)), 0);
+    int ymax = std::min(std::max(y0, std::max(y1, y2)), fb.height - 1);
+    const int xs[3] = { x0, x1, x2 }, ys[3] = { y0, y1, y2 };
+    for(int y=ymin;y<=ymax;y++){
+        double lo = 1e30, hi = -1e30;
+        double yc = y + 0.5;
+        for(int e=0;e<3;e++){
+            int ax = xs[e], ay = ys[e], bx = xs[(e+1)%3], by = ys[(e+1)%3];
+            if(ay == by) continue;
+            if((yc < std::min(ay, by)) || (yc > std::max(ay, by))) continue;
+            double x = ax + (yc - ay) * (double)(bx - ax) / (double)(by - ay);
+            lo = std::min(lo, x); hi = std::max(hi, x);
+        }
+        if(lo <= hi) fb_fill_rect(fb, (int)(lo + 0.5), y, (int)(hi + 0.5), y+1, color);
+    }
+}
+
+void fb_fill_circle(Framebuffer& fb, int cx, int cy, int radius, uint32_t color){
+    for(int dy=-radius; dy<=radius; dy++){
+        int span = 0;
+        while((span+1)*(span+1) + dy*dy <= radius*radius) span++;
+        fb_fill_rect(fb, cx - span, cy + dy, cx + span + 1, cy + dy + 1, color);
+    }
+}
+
+// classic 5x7 font, ASCII 0x20..0x7E, one byte per column, bit 0 = top row
+static const unsigned char FONT5X7[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00},{0x00,0x00,0x5F,0x00,0x00},{0x00,0x07,0x00,0x07,0x00},{0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12},{0x23,0x13,0x08,0x64,0x62},{0x36,0x49,0x55,0x22,0x50},{0x00,0x05,0x03,0x00,0x00},
+    {0x00,0x1C,0x22,0x41,0x00},{0x00,0x41,0x22,0x1C,0x00},{0x14,0x08,0x3E,0x08,0x14},{0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x50,0x30,0x00,0x00},{0x08,0x08,0x08,0x08,0x08},{0x00,0x60,0x60,0x00,0x00},{0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E},{0x00,0x42,0x7F,0x40,0x00},{0x42,0x61,0x51,0x49,0x46},{0x21,0x41,0x45,0x4B,0x31},
+    {0x18,0x14,0x12,0x7F,0x10},{0x27,0x45,0x45,0x45,0x39},{0x3C,0x4A,0x49,0x49,0x30},{0x01,0x71,0x09,0x05,0x03},
+    {0x36,0x49,0x49,0x49,0x36},{0x06,0x49,0x49,0x29,0x1E},{0x00,0x36,0x36,0x00,0x00},{0x00,0x56,0x36,0x00,0x00},
+    {0x08,0x14,0x22,0x41,0x00},{0x14,0x14,0x14,0x14,0x14},{0x00,0x41,0x22,0x14,0x08},{0x02,0x01,0x51,0x09,0x06},
+    {0x32,0x49,0x79,0x41,0x3E},{0x7E,0x11,0x11,0x11,0x7E},{0x7F,0x49,0x49,0x49,0x36},{0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x22,0x1C},{0x7F,0x49,0x49,0x49,0x41},{0x7F,0x09,0x09,0x09,0x01},{0x3E,0x41,0x49,0x49,0x7A},
+    {0x7F,0x08,0x08,0x08,0x7F},{0x00,0x41,0x7F,0x41,0x00},{0x20,0x40,0x41,0x3F,0x01},{0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40},{0x7F,0x02,0x0C,0x02,0x7F},{0x7F,0x04,0x08,0x10,0x7F},{0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06},{0x3E,0x41,0x51,0x21,0x5E},{0x7F,0x09,0x19,0x29,0x46},{0x46,0x49,0x49,0x49,0x31},
+    {0x01,0x01,0x7F,0x01,0x01},{0x3F,0x40,0x40,0x40,0x3F},{0x1F,0x20,0x40,0x20,0x1F},{0x3F,0x40,0x38,0x40,0x3F},
+    {0x63,0x14,0x08,0x14,0x63},{0x07,0x08,0x70,0x08,0x07},{0x61,0x51,0x49,0x45,0x43},{0x00,0x7F,0x41,0x41,0x00},
+    {0x02,0x04,0x08,0x10,0x20},{0x00,0x41,0x41,0x7F,0x00},{0x04,0x02,0x01,0x02,0x04},{0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x01,0x02,0x04,0x00},{0x20,0x54,0x54,0x54,0x78},{0x7F,0x48,0x44,0x44,0x38},{0x38,0x44,0x44,0x44,0x20},
+    {0x38,0x44,0x44,0x48,0x7F},{0x38,0x54,0x54,0x54,0x18},{0x08,0x7E,0x09,0x01,0x02},{0x0C,0x52,0x52,0x52,0x3E},
+    {0x7F,0x08,0x04,0x04,0x78},{0x00,0x44,0x7D,0x40,0x00},{0x20,0x40,0x44,0x3D,0x00},{0x7F,0x10,0x28,0x44,0x00},
+    {0x00,0x41,0x7F,0x40,0x00},{0x7C,0x04,0x18,0x04,0x78},{0x7C,0x08,0x04,0x04,0x78},{0x38,0x44,0x44,0x44,0x38},
+    {0x7C,0x14,0x14,0x14,0x08},{0x08,0x14,0x14,0x18,0x7C},{0x7C,0x08,0x04,0x04,0x08},{0x48,0x54,0x54,0x54,0x20},
+    {0x04,0x3F,0x44,0x40,0x20},{0x3C,0x40,0x40,0x20,0x7C},{0x1C,0x20,0x40,0x20,0x1C},{0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44},{0x0C,0x50,0x50,0x50,0x3C},{0x44,0x64,0x54,0x4C,0x44},{0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x7F,0x00,0x00},{0x00,0x41,0x36,0x08,0x00},{0x08,0x04,0x08,0x10,0x08},
+};
+
+void fb_draw_text(Framebuffer& fb, int x, int y, const char* s, uint32_t color, int scale){
+    for(; *s; s++, x += 6*scale){
+        unsigned char ch = (unsigned char)*s;
+        if(ch < 0x20 || ch > 0x7E) ch = '?';
+        const unsigned char* glyph = FONT5X7[ch - 0x20];
+        for(int col=0;col<5;col++) for(int row=0;row<7;row++){
+            if(glyph[col] & (1 << row))
+                fb_fill_rect(fb, x + col*scale, y + row*scale, x + (col+1)*scale, y + (row+1)*scale, color);
+        }
+    }
+}
+
+bool fb_write_ppm(const Framebuffer& fb, const char* path){
+    FILE* f = fopen(path, "wb");
+    if(!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", fb.width, fb.height);
+    std::vector<unsigned char> row((size_t)fb.width * 3);
+    for(int y=0;y<fb.height;y++){
+        const uint32_t* src = fb.pixels + (size_t)y * fb.stride;
+        for(int x=0;x<fb.width;x++){
+            row[x*3+0] = (unsigned char)(src[x] >> 16);
+            row[x*3+1] = (unsigned char)(src[x] >> 8);
+            row[x*3+2] = (unsigned char)src[x];
+        }
+        fwrite(row.data(), 1, row.size(), f);
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
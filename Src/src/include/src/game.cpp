@@ -1,265 +1,670 @@
 // src/game.cpp
 #include "game.hpp"
+#include "rng.hpp"
+#include "grid_sweep.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
 #include <cmath>
-#include <cstdlib>
-#include <ctime>
+#include <chrono>
 #include <algorithm>
 
 static const int WINDOW_W = 1280;
 static const int WINDOW_H = 720;
 static const int HUD_WIDTH = 260;
-static const int GRID_CELL = 24;
-static const int WORLD_COLS = 80;
-static const int WORLD_ROWS = 50;
 
-using namespace std;
+// drone storage is reserved up front so steady-state ticks never reallocate
+static const size_t DRONE_RESERVE = 256;
 
-// simple Vec2 impl
-double Vec2::len() const { return sqrt(x*x + y*y); }
-Vec2 Vec2::normalized() const { double l = len(); return l>1e-9 ? Vec2(x/l,y/l) : Vec2(0,0); }
-Vec2 Vec2::operator*(double s) const { return Vec2(x*s, y*s); }
-Vec2 Vec2::operator+(const Vec2& o) const { return Vec2(x+o.x, y+o.y); }
-Vec2 Vec2::operator-(const Vec2& o) const { return Vec2(x-o.x, y-o.y); }
+using namespace std;
 
-Ship::Ship(){ core_r=0; core_c=0; pos_x=0; pos_y=0; angle=0; vel=Vec2(); angVel=0; }
+Session::Session(){
+    resources = 0; score = 0; tickCount = 0;
+    paused = false; gameOver = false;
+    seed = 1; inputSource = nullptr; inputUser = nullptr;
+    tickHook = nullptr; tickHookUser = nullptr;
+    checkpointId = 0;
+    pool = nullptr;
+}
 
 static bool g_running = true;
-static bool g_paused = false;
-static bool g_gameOver = false;
-static int tickCount = 0;
-
-static Block g_world[WORLD_ROWS][WORLD_COLS];
-static Ship g_ship;
-static int g_resources = 0;
-static int g_score = 0;
-static std::vector<Drone> g_drones;
-
-// Forward helpers
-inline bool inGrid(int r,int c){ return r>=0 && r<WORLD_ROWS && c>=0 && c<WORLD_COLS; }
-static Vec2 rotateLocal(int grOffsetR, int grOffsetC, double angleRad){
-    double localX = grOffsetC * GRID_CELL;
-    double localY = grOffsetR * GRID_CELL;
-    double s = sin(angleRad), c = cos(angleRad);
-    double rx = localX * c - localY * s;
-    double ry = localX * s + localY * c;
-    return Vec2(rx, ry);
+static Session g_session;
+// cell changes of the default session not yet consumed by the renderer
+static std::vector<CellPos> g_dirtyCells;
+static unsigned g_worldGeneration = 0;
+
+static void flushDirtyCells(){
+    const std::vector<CellPos> &ch = g_session.world.changes();
+    g_dirtyCells.insert(g_dirtyCells.end(), ch.begin(), ch.end());
+    g_session.world.clear_changes();
+    // regions streamed in or out change cells too, without being world changes
+    const std::vector<CellPos> &st = g_session.stream.streamed();
+    g_dirtyCells.insert(g_dirtyCells.end(), st.begin(), st.end());
+    g_session.stream.clear_streamed();
 }
 
-void resetWorld(){
-    for(int r=0;r<WORLD_ROWS;r++) for(int c=0;c<WORLD_COLS;c++){ g_world[r][c].type = BLOCK_EMPTY; g_world[r][c].hp = 0; }
-    srand((unsigned)time(NULL));
-    for(int i=0;i<40;i++){
-        int ar = rand() % WORLD_ROWS;
-        int ac = rand() % (WORLD_COLS - 20) + 10;
-        int size = rand() % 6 + 3;
-        for(int dr=-size; dr<=size; dr++) for(int dc=-size; dc<=size; dc++){
-            int rr = ar + dr; int cc = ac + dc;
-            if(inGrid(rr,cc) && rand()%100 < 60){
-                g_world[rr][cc].type = BLOCK_ARMOR;
-                g_world[rr][cc].hp = 40 + rand()%40;
-            }
-        }
-    }
+// Ticks compute in SimReal (sim_real.hpp) from the stored doubles and store their results back
+static SimVec2 shipVel(const ShipStore& sh, int i){ return SimVec2(SimReal(sh.vx[i]), SimReal(sh.vy[i])); }
 
-    int start_c = 10, start_r = WORLD_ROWS/2;
-    g_ship.blocks.clear();
-    g_ship.core_r = start_r; g_ship.core_c = start_c;
-    g_ship.pos_x = start_c * GRID_CELL + GRID_CELL/2;
-    g_ship.pos_y = start_r * GRID_CELL + GRID_CELL/2;
-    g_ship.angle = 0; g_ship.vel = Vec2(); g_ship.angVel = 0;
-    g_ship.blocks.push_back({0,0});
-    g_ship.blocks.push_back({0,1}); g_ship.blocks.push_back({0,-1});
-    g_ship.blocks.push_back({1,0}); g_ship.blocks.push_back({-1,0});
-    g_ship.blocks.push_back({1,1}); // thruster
-    g_ship.blocks.push_back({-1,0}); // miner
-
-    for(auto &off : g_ship.blocks){
-        int rr = g_ship.core_r + off.first;
-        int cc = g_ship.core_c + off.second;
-        if(inGrid(rr,cc)){ g_world[rr][cc].type = BLOCK_EMPTY; g_world[rr][cc].hp = 0; }
-    }
+// cells around ship i's core a tick can touch: the ship turned any way, the margin around it
+// and one tick of movement
+static int shipReach(const ShipStore& sh, int i){
+    return STREAM_SIM_MARGIN + sh.grid[i].extent() * 3 / 2 + 1 + sim_trunc(shipVel(sh, i).len() / GRID_CELL) + 1;
+}
+
+static void placeShip(Session& s, int i);
+
+void session_reset(Session& s, uint32_t seed, int rows, int cols){
+    s.seed = seed;
+    s.paused = false;
+    s.world.reset(rows, cols);
+    s.rng.reseed(seed);
+    // the asteroid field is generated lazily from the seed, so this costs the same at any map
+    // size; the generator keeps the start area clear
+    WorldGenParams gen = worldgen_default(seed, rows, cols);
+    s.stream.reset(s.world, gen);
 
-    g_resources = 60;
-    g_score = 0;
-    tickCount = 0;
-    g_gameOver = false;
-    g_drones.clear();
+    ShipStore& sh = s.ships;
+    sh.clear();
+    sh.add(gen.startC * GRID_CELL + GRID_CELL/2, gen.startR * GRID_CELL + GRID_CELL/2, 0);
+    ShipGrid& g = sh.grid[PLAYER_SHIP];
+    g.add(0, 0, BLOCK_CORE);
+    g.add(0, 1, BLOCK_ARMOR); g.add(0, -1, BLOCK_ARMOR);
+    g.add(1, 0, BLOCK_ARMOR);
+    g.add(1, 1, BLOCK_THRUSTER);
+    g.add(-1, 0, BLOCK_MINER);
+    placeShip(s, PLAYER_SHIP);
+    s.stream.update(s.world, sh.coreR[PLAYER_SHIP], sh.coreC[PLAYER_SHIP], shipReach(sh, PLAYER_SHIP));
+
+    s.resources = 60;
+    s.world.clear_changes(); // generation is not an incremental change
+    s.checkpointId = 0;
+    s.score = 0;
+    s.tickCount = 0;
+    s.gameOver = false;
+    s.debris.clear();
+    s.debris.reserve(DEBRIS_MAX);
+    s.drones.clear();
+    s.drones.reserve(DRONE_RESERVE);
+    s.droneContacts.reserve(DRONE_RESERVE);
+    s.dronePushX.reserve(DRONE_RESERVE); s.dronePushY.reserve(DRONE_RESERVE);
+    s.droneTargetX.reserve(DRONE_RESERVE); s.droneTargetY.reserve(DRONE_RESERVE);
+    s.flow.reset();
     for(int i=0;i<8;i++){
-        Drone d; d.x = (WORLD_COLS - 8 - rand()%10) * GRID_CELL; d.y = (5 + rand()%(WORLD_ROWS-10)) * GRID_CELL;
-        d.hp = 40 + rand()%60; d.angle = 0; d.vel = Vec2(); d.cooldown = 0; g_drones.push_back(d);
+        Drone d; d.x = (cols - 8 - s.rng.range(10)) * GRID_CELL; d.y = (5 + s.rng.range(rows-10)) * GRID_CELL;
+        d.hp = 40 + s.rng.range(60); d.angle = 0; d.vel = Vec2(); d.cooldown = 0; s.drones.push(d);
     }
 }
 
-void game_init(){
-    resetWorld();
+int session_add_ship(Session& s, const ShipGrid& blocks, double x, double y, double angle){
+    int i = s.ships.add(x, y, angle);
+    s.ships.grid[i] = blocks;
+    placeShip(s, i);
+    return i;
+}
+
+void game_init(uint32_t seed){
+    g_session.stream.report_streamed(true);
+    session_reset(g_session, seed);
+    g_session.stream.clear_streamed();
+    g_dirtyCells.clear();
+    g_worldGeneration++;
     g_running = true;
 }
 void game_shutdown(){ g_running = false; }
 bool game_is_running(){ return g_running; }
 void game_request_quit(){ g_running = false; }
-bool game_is_paused(){ return g_paused; }
-bool game_is_over(){ return g_gameOver; }
+bool game_is_paused(){ return g_session.paused; }
+bool game_is_over(){ return g_session.gameOver; }
+Session& game_session(){ return g_session; }
+void game_set_input_source(GameInputSource src, void* user){ g_session.inputSource = src; g_session.inputUser = user; }
+int game_get_tick(){ return g_session.tickCount; }
 
 int game_get_window_width(){ return WINDOW_W; }
 int game_get_window_height(){ return WINDOW_H; }
 int game_get_hud_width(){ return HUD_WIDTH; }
 
-int game_get_resources(){ return g_resources; }
-int game_get_score(){ return g_score; }
+int game_get_resources(){ return g_session.resources; }
+int game_get_score(){ return g_session.score; }
 
-void game_get_player_pos(double &x, double &y){ x = g_ship.pos_x; y = g_ship.pos_y; }
-double game_get_player_angle(){ return g_ship.angle; }
-const std::vector<Drone>& game_get_drones(){ return g_drones; }
-const Block* game_get_world_ptr(){ return &g_world[0][0]; }
-int game_world_rows(){ return WORLD_ROWS; }
-int game_world_cols(){ return WORLD_COLS; }
+void game_get_player_pos(double &x, double &y){ x = g_session.ships.x[PLAYER_SHIP]; y = g_session.ships.y[PLAYER_SHIP]; }
+double game_get_player_angle(){ return g_session.ships.angle[PLAYER_SHIP]; }
+const DroneStore& game_get_drones(){ return g_session.drones; }
+const WorldGrid& game_get_world(){ return g_session.world; }
+int game_world_rows(){ return g_session.world.rows(); }
+int game_world_cols(){ return g_session.world.cols(); }
 
 // modifications: place/remove world functions used by input/render
 bool placeBlockAtWorld(int r,int c, BlockType type){
-    if(!inGrid(r,c)) return false;
-    if(g_world[r][c].type != BLOCK_EMPTY) return false;
-    g_world[r][c].type = type; g_world[r][c].hp = (type==BLOCK_ARMOR?60: (type==BLOCK_THRUSTER?30:20));
+    Session& s = g_session;
+    if(!s.world.in_grid(r,c)) return false;
+    if(!s.world.get(r,c).empty()) return false;
+    s.world.set(r, c, Block::of(type));
+    flushDirtyCells();
     return true;
 }
 bool removeBlockAtWorld(int r,int c){
-    if(!inGrid(r,c)) return false;
-    if(g_world[r][c].type == BLOCK_EMPTY) return false;
-    int gain = 0;
-    switch(g_world[r][c].type){ case BLOCK_ARMOR: gain=8; break; case BLOCK_THRUSTER: gain=12; break; case BLOCK_MINER: gain=10; break; default: gain=4; break; }
-    g_resources += gain; g_world[r][c].type = BLOCK_EMPTY; g_world[r][c].hp = 0; return true;
+    Session& s = g_session;
+    const Block &b = s.world.get(r,c);
+    if(b.empty()) return false;
+    s.resources += block_info(b.type()).salvage; s.world.clear(r,c); flushDirtyCells(); return true;
 }
 
 // Internal update helpers
-void applyShipForces(){
-    Vec2 totalForce(0,0); double totalTorque = 0.0;
-    // Simple AI-less forces: thruster present at offset (1,1)
-    // For input-derived thrust we rely on input module to set flags via global accessible functions
-    Vec2 thrustInput = get_input_thrust(); // declared in input.hpp
-    double userMag = thrustInput.len();
-    if(userMag > 1.0) thrustInput = thrustInput.normalized();
-
-    for(auto &off : g_ship.blocks){
-        bool isThruster = (off.first==1 && off.second==1);
-        if(isThruster){
-            Vec2 localDir(0,-1);
-            double sA = sin(g_ship.angle), cA = cos(g_ship.angle);
-            Vec2 worldDir(localDir.x * cA - localDir.y * sA, localDir.x * sA + localDir.y * cA);
-            Vec2 f = worldDir * (40.0 * userMag);
-            totalForce += f;
-            Vec2 offsetWorld = rotateLocal(off.first, off.second, g_ship.angle);
-            double torque = offsetWorld.x * f.y - offsetWorld.y * f.x;
-            totalTorque += torque * 0.001;
-        }
+
+// Runs fn(begin, end, worker) over [0,count) in ranges of batch items, spread over s.pool when
+// the session has one. Range bounds depend only on count, so anything merged per range comes
+// out the same at any thread count.
+static const int SHIP_RANGE = 16;
+static const int MINER_RANGE = 64;
+static const int DRONE_RANGE = 1024;
+static const int BLOCK_RANGE = 256;
+
+template<class Fn> static void forRanges(Session& s, int count, int batch, Fn fn){
+    int ranges = (count + batch - 1) / batch;
+    if(!s.pool || ranges <= 1){
+        for(int k=0;k<ranges;k++) fn(k * batch, std::min(count, (k + 1) * batch), 0);
+        return;
     }
+    s.pool->parallel_for(ranges, [&](int k, int worker){ fn(k * batch, std::min(count, (k + 1) * batch), worker); });
+}
 
-    Vec2 drag = g_ship.vel * -0.6;
+// the world must be resident wherever this tick can reach: every ship's blocks and the drones
+// touching the player's, around wherever the ships move to. Only the player's ship prefetches,
+// but AI ships get their reach generated inline, so what a tick reads never depends on when a
+// stream worker finished.
+static void streamWorld(Session& s){
+    PROFILE_ZONE("stream");
+    s.flow.note_writes(s.world, s.world.written()); // the stream clears them
+    const ShipStore& sh = s.ships;
+    s.streamFoci.resize(sh.size());
+    for(int i=0;i<sh.size();i++){ StreamFocus f = { sh.coreR[i], sh.coreC[i], shipReach(sh, i) }; s.streamFoci[i] = f; }
+    s.stream.update(s.world, s.streamFoci.data(), (int)s.streamFoci.size());
+}
+
+// core cell and block transforms for ship i's current pose
+static void placeShip(Session& s, int i){
+    ShipStore& sh = s.ships;
+    int newCoreC = sim_trunc(SimReal(sh.x[i]) / GRID_CELL);
+    int newCoreR = sim_trunc(SimReal(sh.y[i]) / GRID_CELL);
+    sh.coreC[i] = std::max(0, std::min(s.world.cols()-1,newCoreC));
+    sh.coreR[i] = std::max(0, std::min(s.world.rows()-1,newCoreR));
+    sh.grid[i].update_transforms(sh.x[i], sh.y[i], sh.angle[i], GRID_CELL);
+}
+
+// AI ships fly at their target: full throttle while it is ahead, a little otherwise so their
+// thrusters' arm turns them, and a new target up to AI_ROAM cells away (inside the map) once
+// they are within AI_ARRIVE of it. Targets come from the seed, the tick and the ship, so
+// ships need no shared rng and the pool can be split across threads.
+static const SimReal AI_ARRIVE(GRID_CELL * 4.0);
+static const int AI_ROAM = 40;
+static const SimReal AI_FACING(0.9);        // cos of the angle off target still taken as ahead
+static const double AI_TURN_THROTTLE = 0.3;
+
+static void autopilot(Session& s, int i){
+    ShipStore& sh = s.ships;
+    SimReal x(sh.x[i]), y(sh.y[i]);
+    SimReal dx = SimReal(sh.targetX[i]) - x, dy = SimReal(sh.targetY[i]) - y;
+    // compared as a length, not squared: a ship knocked far off its target would overflow a Fixed
+    SimReal dist = sim_length(dx, dy);
+    if(dist < AI_ARRIVE){
+        Rng rng(((uint64_t)s.seed << 32) ^ ((uint64_t)i << 20) ^ (uint64_t)s.tickCount);
+        double maxX = s.world.cols() * GRID_CELL, maxY = s.world.rows() * GRID_CELL;
+        sh.targetX[i] = std::max(0.0, std::min(maxX, sim_to_double(x + SimReal((rng.range(2 * AI_ROAM + 1) - AI_ROAM) * GRID_CELL))));
+        sh.targetY[i] = std::max(0.0, std::min(maxY, sim_to_double(y + SimReal((rng.range(2 * AI_ROAM + 1) - AI_ROAM) * GRID_CELL))));
+        sh.throttle[i] = AI_TURN_THROTTLE;
+        return;
+    }
+    SimReal sA, cA;
+    sim_sin_cos(SimReal(sh.angle[i]), sA, cA);
+    SimReal facing = (sA * dx - cA * dy) / dist;
+    sh.throttle[i] = facing > AI_FACING ? 1.0 : AI_TURN_THROTTLE;
+}
+
+// Thrusters all push along the ship's forward axis (-r), so with the grid's incremental thrust
+// arm the whole ship's force and torque cost the same however many thrusters it has. The
+// center of mass moves with vel and the ship turns about it.
+static const SimReal THRUST_FORCE(40.0);
+static const SimReal SHIP_DRAG(-0.6);
+static const SimReal SHIP_SPIN_DAMPING(0.98);
+static const SimReal TICK_SECONDS(1.0/60.0);
+
+static void integrateShip(Session& s, int i){
+    ShipStore& sh = s.ships;
+    const ShipGrid& g = sh.grid[i];
+    SimReal sA, cA;
+    sim_sin_cos(SimReal(sh.angle[i]), sA, cA);
+    SimReal thrust = THRUST_FORCE * SimReal(sh.throttle[i]);
+    SimVec2 totalForce = SimVec2(sA, -cA) * (thrust * (int)g.thrusters().size());
+    SimReal totalTorque = thrust * SimReal(g.thrust_arm()) * GRID_CELL;
+
+    SimReal mass(g.mass() > 0 ? g.mass() : 1.0);
+    SimReal inertia = SimReal(g.inertia()) * GRID_CELL * GRID_CELL;
+    SimVec2 vel = shipVel(sh, i);
+    SimReal angVel(sh.angVel[i]), zero(0);
+    SimVec2 drag = vel * SHIP_DRAG;
     totalForce += drag;
-    Vec2 acceleration = totalForce * (1.0 / 10.0);
-    g_ship.vel = g_ship.vel + acceleration * (1.0/60.0);
-    g_ship.pos_x += g_ship.vel.x * (1.0/60.0) * 60.0;
-    g_ship.pos_y += g_ship.vel.y * (1.0/60.0) * 60.0;
-    g_ship.angVel += totalTorque * (1.0/60.0);
-    g_ship.angVel *= 0.98;
-    g_ship.angle += g_ship.angVel * (1.0/60.0);
-
-    if(fabs(g_ship.vel.x) < 1e-3) g_ship.vel.x = 0;
-    if(fabs(g_ship.vel.y) < 1e-3) g_ship.vel.y = 0;
-    if(fabs(g_ship.angVel) < 1e-4) g_ship.angVel = 0;
-
-    int newCoreC = (int)(g_ship.pos_x / GRID_CELL);
-    int newCoreR = (int)(g_ship.pos_y / GRID_CELL);
-    g_ship.core_c = std::max(0, std::min(WORLD_COLS-1,newCoreC));
-    g_ship.core_r = std::max(0, std::min(WORLD_ROWS-1,newCoreR));
+    SimVec2 acceleration = totalForce * (SimReal(1) / mass);
+    vel = vel + acceleration * TICK_SECONDS;
+    if(inertia > zero) angVel += totalTorque / inertia * TICK_SECONDS;
+    angVel *= SHIP_SPIN_DAMPING;
+
+    if(sim_abs(vel.x) < SimReal(1e-3)) vel.x = zero;
+    if(sim_abs(vel.y) < SimReal(1e-3)) vel.y = zero;
+    if(sim_abs(angVel) < SimReal(1e-4)) angVel = zero;
+    sh.vx[i] = sim_to_double(vel.x); sh.vy[i] = sim_to_double(vel.y); sh.angVel[i] = sim_to_double(angVel);
+
+    // move the center of mass, turn, and put the core back where the turn leaves it
+    SimReal comX = SimReal(g.com_c()) * GRID_CELL, comY = SimReal(g.com_r()) * GRID_CELL;
+    SimReal cx = SimReal(sh.x[i]) + comX * cA - comY * sA + vel.x;
+    SimReal cy = SimReal(sh.y[i]) + comX * sA + comY * cA + vel.y;
+    SimReal angle = SimReal(sh.angle[i]) + angVel * TICK_SECONDS;
+    SimReal sB, cB;
+    sim_sin_cos(angle, sB, cB);
+    sh.angle[i] = sim_to_double(angle);
+    sh.x[i] = sim_to_double(cx - (comX * cB - comY * sB));
+    sh.y[i] = sim_to_double(cy - (comX * sB + comY * cB));
+
+    // later phases read block positions from here (collisions may move the ship back)
+    placeShip(s, i);
 }
 
-void shipMining(){
-    for(auto &off : g_ship.blocks){
-        bool isMiner = (off.first==-1 && off.second==0);
-        if(!isMiner) continue;
-        Vec2 local = rotateLocal(off.first, off.second, g_ship.angle);
-        double wx = g_ship.pos_x + local.x;
-        double wy = g_ship.pos_y + local.y;
-        int gr = (int)(wy / GRID_CELL);
-        int gc = (int)(wx / GRID_CELL);
-        if(inGrid(gr,gc) && g_world[gr][gc].type == BLOCK_ARMOR){
-            g_world[gr][gc].hp -= 1 + (rand()%3);
-            if(g_world[gr][gc].hp <= 0){
-                g_world[gr][gc].type = BLOCK_EMPTY; g_world[gr][gc].hp = 0; g_resources += 12; g_score += 8;
-            }
+static void applyShipForces(Session& s){
+    PROFILE_ZONE("ship_forces");
+    // Input is sampled once per tick from the session's injected source, on the ticking thread
+    Vec2 thrustInput = s.inputSource ? s.inputSource(s.tickCount, s.inputUser) : Vec2();
+    s.ships.throttle[PLAYER_SHIP] = sim_to_double(SimVec2(SimReal(thrustInput.x), SimReal(thrustInput.y)).len());
+    // every ship reads and writes only its own components
+    forRanges(s, s.ships.size(), SHIP_RANGE, [&](int begin, int end, int){
+        for(int i=begin;i<end;i++){
+            if(i != PLAYER_SHIP) autopilot(s, i);
+            integrateShip(s, i);
         }
-    }
+    });
+}
+
+// miners over armor emit TICK_MINE; the damage roll happens when it is applied, in miner order.
+// Miners are numbered across ships (the player's first), so their ranges split the fleet
+// wherever its miners are.
+static void shipMining(Session& s){
+    PROFILE_ZONE("mining");
+    const ShipStore& sh = s.ships;
+    int n = sh.size();
+    s.minerStart.resize(n + 1);
+    s.minerStart[0] = 0;
+    for(int i=0;i<n;i++) s.minerStart[i + 1] = s.minerStart[i] + (int)sh.grid[i].miners().size();
+    forRanges(s, s.minerStart[n], MINER_RANGE, [&](int begin, int end, int worker){
+        int ship = (int)(std::upper_bound(s.minerStart.begin(), s.minerStart.end(), begin) - s.minerStart.begin()) - 1;
+        for(int k=begin;k<end;k++){
+            while(k >= s.minerStart[ship + 1]) ship++;
+            const ShipGrid& g = sh.grid[ship];
+            int i = g.miners()[k - s.minerStart[ship]], gr = g.world_r(i), gc = g.world_c(i);
+            if(block_info(s.world.get(gr, gc).type()).mineResources > 0) s.events.emit(worker, tick_event_order(PHASE_MINING, k), TICK_MINE, gr, gc, 0, 0, ship);
+        }
+    });
 }
 
-void drones_update(){
-    for(auto &d : g_drones){
-        if(d.hp <= 0) continue;
-        Vec2 playerPos(g_ship.pos_x, g_ship.pos_y);
-        Vec2 dir = playerPos - Vec2(d.x,d.y);
-        double dist = dir.len();
-        dir = dir.normalized();
-        double speed = 40.0;
-        Vec2 desired = dir * speed;
-        d.vel = d.vel + (desired - d.vel) * 0.06;
-        d.x += d.vel.x * (1.0/60.0) * 60.0;
-        d.y += d.vel.y * (1.0/60.0) * 60.0;
-
-        if(dist < GRID_CELL*2.0){
-            int br = (int)(d.y / GRID_CELL);
-            int bc = (int)(d.x / GRID_CELL);
-            if(inGrid(br,bc) && g_world[br][bc].type != BLOCK_EMPTY){
-                g_world[br][bc].hp -= 6;
-                if(g_world[br][bc].hp <= 0){ g_world[br][bc].type = BLOCK_EMPTY; g_world[br][bc].hp = 0; g_resources += 6; }
+// drones closer than DRONE_SEPARATION steer apart (they are drawn 16px wide); any drone that
+// starts the tick within DRONE_CONTACT of the player's core or over one of its blocks attacks it
+static const double DRONE_SEPARATION = 16.0;
+static const double DRONE_SEPARATION_GAIN = 20.0;
+static const double DRONE_CONTACT = GRID_CELL * 2.0;
+static const int DRONE_HULL_DAMAGE = 6;
+static const double DRONE_FIRE_INTERVAL = 0.5; // s of contact between shots at a hull block
+
+static void drones_update(Session& s){
+    PROFILE_ZONE("drones");
+    DroneStore &drones = s.drones;
+    const ShipStore &sh = s.ships;
+    const int P = PLAYER_SHIP;
+    int n = drones.size();
+    // broadphase over start-of-tick positions, so steering does not depend on update order
+    s.droneHash.build(n, [&](int i, double &x, double &y){ x = drones.x[i]; y = drones.y[i]; });
+
+    // one shared field, sampled per drone: the center of the next cell on the way, or the ship
+    // itself from its own cell and wherever the field does not reach
+    s.flow.note_writes(s.world, s.world.written());
+    s.flow.update(s.world, s.stream, sh.coreR[P], sh.coreC[P]);
+
+    // every drone reads start-of-tick positions and writes only its own slots, so the ranges
+    // run in parallel; steering moves drones, so it waits for all of them
+    s.dronePushX.resize(n); s.dronePushY.resize(n);
+    s.droneTargetX.resize(n); s.droneTargetY.resize(n);
+    forRanges(s, n, DRONE_RANGE, [&](int begin, int end, int){
+        for(int i=begin;i<end;i++){
+            SimReal pushX(0), pushY(0), sep(DRONE_SEPARATION);
+            s.droneHash.query_radius(drones.x[i], drones.y[i], DRONE_SEPARATION, [&](int j, SimReal dx, SimReal dy, SimReal d2){
+                // 1e-12 is 0 in Fixed, so drones on the same spot are caught by the second test
+                if(j == i || d2 < SimReal(1e-12) || d2 == SimReal(0)) return;
+                SimReal dl = sim_sqrt(d2);
+                SimReal w = (sep - dl) / sep;
+                pushX += (-dx / dl) * w; pushY += (-dy / dl) * w;
+            });
+            s.dronePushX[i] = sim_to_double(pushX); s.dronePushY[i] = sim_to_double(pushY);
+            int nr, nc;
+            if(s.flow.step(sim_trunc(SimReal(drones.y[i]) / GRID_CELL), sim_trunc(SimReal(drones.x[i]) / GRID_CELL), nr, nc)){
+                s.droneTargetX[i] = nc * GRID_CELL + GRID_CELL * 0.5;
+                s.droneTargetY[i] = nr * GRID_CELL + GRID_CELL * 0.5;
             } else {
-                g_ship.vel = g_ship.vel + (g_ship.pos_x - d.x > 0 ? Vec2(2,0) : Vec2(-2,0));
-                g_score -= 2;
+                s.droneTargetX[i] = sh.x[P]; s.droneTargetY[i] = sh.y[P];
+            }
+        }
+    });
+    forRanges(s, n, DRONE_RANGE, [&](int begin, int end, int){
+        drone_steer(drones, begin, end, s.droneTargetX.data(), s.droneTargetY.data(), s.dronePushX.data(), s.dronePushY.data(), DRONE_SEPARATION_GAIN);
+    });
+
+    // ship contacts come from one radius query over the whole ship instead of a distance test
+    // per drone. Each hits the world block under the drone or, over open space, the hull: a
+    // shove and, once per DRONE_FIRE_INTERVAL of contact, a shot at the ship block under it
+    // unless that is the core, which anchors the ship and is never destroyed. A contact writes
+    // only its own drone's slots, so the ranges run in parallel; applied in drone order.
+    const ShipGrid &g = sh.grid[P];
+    SimReal px(sh.x[P]), py(sh.y[P]), contact(DRONE_CONTACT), half(0.5), zero(0);
+    double reach = std::max(DRONE_CONTACT, (g.extent() * 1.5 + 1.0) * GRID_CELL);
+    SimReal sA, cA;
+    sim_sin_cos(SimReal(sh.angle[P]), sA, cA);
+    s.droneContacts.clear();
+    s.droneHash.collect_radius(sh.x[P], sh.y[P], reach, s.droneContacts);
+    forRanges(s, (int)s.droneContacts.size(), DRONE_RANGE, [&](int begin, int end, int worker){
+        for(int k=begin;k<end;k++){
+            int i = s.droneContacts[k];
+            // the ship cell under the drone: its offset from the core turned into the ship's frame
+            SimReal x(drones.x[i]), y(drones.y[i]);
+            SimReal dx = x - px, dy = y - py;
+            int lc = sim_floor((dx * cA + dy * sA) / GRID_CELL + half);
+            int lr = sim_floor((dy * cA - dx * sA) / GRID_CELL + half);
+            int block = g.find(lr, lc);
+            if(block < 0 && dx * dx + dy * dy > contact * contact) continue;
+            int br = sim_trunc(y / GRID_CELL);
+            int bc = sim_trunc(x / GRID_CELL);
+            uint64_t order = tick_event_order(PHASE_DRONES, i);
+            if(!s.world.get(br, bc).empty()) s.events.emit(worker, order, TICK_DAMAGE, br, bc, 6, 6);
+            else {
+                s.events.emit(worker, order, TICK_SHIP_HIT, br, bc, px - x > zero ? 2 : -2, 0, P);
+                drones.cooldown[i] = sim_to_double(SimReal(drones.cooldown[i]) - TICK_SECONDS);
+                if(block >= 0 && g.type(block) != BLOCK_CORE && drones.cooldown[i] <= 0){
+                    s.events.emit(worker, tick_event_order(PHASE_DRONES, i, 1), TICK_SHIP_DAMAGE, lr, lc, DRONE_HULL_DAMAGE, 0, P);
+                    drones.cooldown[i] = DRONE_FIRE_INTERVAL;
+                }
             }
-            d.hp -= 4;
+            drones.hp[i] -= 4;
         }
+    });
+    drones.remove_dead();
+}
+
+// Swept collision: over a tick every block moves along the straight segment from where the
+// tick started to where applyShipForces put it. Each segment's cells are walked in order and
+// the earliest solid cell any block enters is the contact; the ship goes back to just before
+// that moment and the contact is resolved once: the velocity into the face is reflected with
+// COLLISION_RESTITUTION (or the spin, when turning alone caused it) and the cells hit at that
+// instant take damage (TICK_DAMAGE). Nothing tunnels at any speed, the cost is the cells crossed, and a
+// cell a block already overlaps when the tick starts is never a contact, so resting ships do
+// not bounce in place. Ships only collide with the world, not with each other.
+static const SimReal COLLISION_RESTITUTION(0.3);
+static const int COLLISION_DAMAGE = 8;
+static const SimReal CONTACT_BACKOFF(1e-6); // of the tick, so blocks stop short of the face
+static const int CONTACT_BITS = 24;         // contacts per ship in an order key; the ship is above them
+
+// one task's blocks from where the tick started to where they are now
+static void sweepBlocks(Session& s, const SweepTask& task, SweepHit& h){
+    const ShipStore& sh = s.ships;
+    const ShipGrid& g = sh.grid[task.ship];
+    SimReal px(sh.prevX[task.ship]), py(sh.prevY[task.ship]), sA, cA;
+    sim_sin_cos(SimReal(sh.prevAngle[task.ship]), sA, cA);
+    sA = sA * GRID_CELL; cA = cA * GRID_CELL;
+    h.t = SimReal(2); h.nr = 0; h.nc = 0; h.cells.clear();
+    for(int i=task.begin;i<task.end;i++){
+        SimReal col(g.col(i)), row(g.row(i));
+        SimReal x0 = px + col * cA - row * sA;
+        SimReal y0 = py + col * sA + row * cA;
+        grid_sweep(x0, y0, SimReal(g.world_x(i)), SimReal(g.world_y(i)), GRID_CELL, h.t, [&](int r, int c, SimReal t, int nr, int nc){
+            if(s.world.get(r, c).empty()) return false;
+            if(t < h.t){ h.t = t; h.nr = nr; h.nc = nc; h.cells.clear(); }
+            bool seen = false;
+            for(const CellPos &p : h.cells) if(p.r == r && p.c == c) seen = true;
+            if(!seen) h.cells.push_back({ r, c });
+            return true;
+        });
     }
-    g_drones.erase(std::remove_if(g_drones.begin(), g_drones.end(), [](const Drone &d){ return d.hp <= 0; }), g_drones.end());
 }
 
-void world_collisions(){
-    for(auto &off : g_ship.blocks){
-        Vec2 local = rotateLocal(off.first, off.second, g_ship.angle);
-        double wx = g_ship.pos_x + local.x;
-        double wy = g_ship.pos_y + local.y;
-        int gr = (int)(wy / GRID_CELL);
-        int gc = (int)(wx / GRID_CELL);
-        if(inGrid(gr,gc) && g_world[gr][gc].type != BLOCK_EMPTY){
-            g_ship.vel = g_ship.vel * -0.3;
-            g_world[gr][gc].hp -= 8;
-            if(g_world[gr][gc].hp <= 0){ g_world[gr][gc].type = BLOCK_EMPTY; g_world[gr][gc].hp = 0; g_resources += 6; }
+// ship i's tasks merged in range order, which matches one sweep over all its blocks, and the
+// earliest contact resolved
+static void resolveContact(Session& s, int i, int worker){
+    ShipStore& sh = s.ships;
+    std::vector<CellPos> &contacts = s.shipContacts[worker];
+    SimReal tHit(2); int hitR = 0, hitC = 0;
+    contacts.clear();
+    for(int k=s.sweepStart[i];k<s.sweepStart[i + 1];k++){
+        const SweepHit &h = s.sweepHits[k];
+        if(h.cells.empty() || h.t > tHit) continue;
+        if(h.t < tHit){ tHit = h.t; hitR = h.nr; hitC = h.nc; contacts.clear(); }
+        for(const CellPos &q : h.cells){
+            bool seen = false;
+            for(const CellPos &p : contacts) if(p.r == q.r && p.c == q.c) seen = true;
+            if(!seen) contacts.push_back(q);
         }
     }
+    if(contacts.empty()) return;
+
+    SimReal t = std::max(SimReal(0), tHit - CONTACT_BACKOFF);
+    SimReal x0(sh.prevX[i]), y0(sh.prevY[i]), a0(sh.prevAngle[i]);
+    sh.x[i] = sim_to_double(x0 + (SimReal(sh.x[i]) - x0) * t);
+    sh.y[i] = sim_to_double(y0 + (SimReal(sh.y[i]) - y0) * t);
+    sh.angle[i] = sim_to_double(a0 + (SimReal(sh.angle[i]) - a0) * t);
+    SimVec2 vel = shipVel(sh, i);
+    SimReal vn = vel.x * hitC + vel.y * hitR;
+    if(vn < SimReal(0)){
+        vel = vel - SimVec2(SimReal(hitC), SimReal(hitR)) * (vn * (SimReal(1) + COLLISION_RESTITUTION));
+        sh.vx[i] = sim_to_double(vel.x); sh.vy[i] = sim_to_double(vel.y);
+    } else sh.angVel[i] = sim_to_double(SimReal(sh.angVel[i]) * -COLLISION_RESTITUTION);
+    placeShip(s, i);
+
+    // the player's ship salvages what it breaks; AI ships only break it
+    int reward = i == PLAYER_SHIP ? 6 : 0;
+    for(size_t k=0;k<contacts.size();k++)
+        s.events.emit(worker, tick_event_order(PHASE_COLLISIONS, (uint64_t)i << CONTACT_BITS | k), TICK_DAMAGE, contacts[k].r, contacts[k].c, COLLISION_DAMAGE, reward, i);
 }
 
-void game_update(){
-    if(g_paused || g_gameOver) return;
-    tickCount++;
-    // inputs are handled in input.cpp and stored in module; apply forces using that input
-    applyShipForces();
-    shipMining();
-    drones_update();
-    world_collisions();
-
-    if(tickCount % (60 * 6) == 0){
-        if(rand()%100 < 40){
-            Drone d; d.x = (WORLD_COLS - 4) * GRID_CELL; d.y = (rand() % WORLD_ROWS) * GRID_CELL; d.hp = 50;
-            g_drones.push_back(d);
+static void world_collisions(Session& s){
+    PROFILE_ZONE("collisions");
+    const ShipStore& sh = s.ships;
+    int n = sh.size();
+    // every ship that moved is swept in ranges of its blocks, so one big ship splits across
+    // workers as well as many small ones do; task bounds depend only on the ships
+    s.sweepTasks.clear();
+    s.sweepStart.resize(n + 1);
+    for(int i=0;i<n;i++){
+        s.sweepStart[i] = (int)s.sweepTasks.size();
+        if(sh.x[i] == sh.prevX[i] && sh.y[i] == sh.prevY[i] && sh.angle[i] == sh.prevAngle[i]) continue;
+        int blocks = sh.grid[i].size();
+        for(int b=0;b<blocks;b+=BLOCK_RANGE) s.sweepTasks.push_back({ i, b, std::min(blocks, b + BLOCK_RANGE) });
+    }
+    s.sweepStart[n] = (int)s.sweepTasks.size();
+    if(s.sweepTasks.empty()) return;
+    s.sweepHits.resize(s.sweepTasks.size());
+    forRanges(s, (int)s.sweepTasks.size(), 1, [&](int begin, int end, int){
+        for(int k=begin;k<end;k++) sweepBlocks(s, s.sweepTasks[k], s.sweepHits[k]);
+    });
+    s.shipContacts.resize(s.pool ? s.pool->size() : 1);
+    forRanges(s, n, SHIP_RANGE, [&](int begin, int end, int worker){
+        for(int i=begin;i<end;i++) if(s.sweepStart[i] < s.sweepStart[i + 1]) resolveContact(s, i, worker);
+    });
+}
+
+// Blocks that removing cell (r,c) of ship i disconnected from its core leave it, one debris
+// piece per fragment, moving as the ship's rigid body did at the fragment's center of mass
+// plus a small push away from the ship.
+static const SimReal DEBRIS_PUSH(0.5); // px/tick
+
+static void cutLoose(Session& s, int ship, int r, int c){
+    ShipStore& sh = s.ships;
+    ShipStore& db = s.debris;
+    ShipGrid& g = sh.grid[ship];
+    s.fragmentCells.clear(); s.fragmentEnds.clear();
+    int fragments = g.detach_after_remove(r, c, s.fragmentCells, s.fragmentEnds);
+    SimReal sA, cA, comR(g.com_r()), comC(g.com_c());
+    sim_sin_cos(SimReal(sh.angle[ship]), sA, cA);
+    int begin = 0;
+    for(int f=0;f<fragments;f++){
+        if(db.size() >= DEBRIS_MAX){
+            // the oldest piece: fewest ticks left
+            int oldest = 0;
+            for(int k=1;k<db.size();k++) if(db.ttl[k] < db.ttl[oldest]) oldest = k;
+            db.remove_swap(oldest);
         }
+        int d = db.add(sh.x[ship], sh.y[ship], sh.angle[ship]);
+        ShipGrid &dg = db.grid[d];
+        int end = s.fragmentEnds[f];
+        dg.reserve(end - begin);
+        for(int k=begin;k<end;k++){
+            const CellPos &p = s.fragmentCells[k];
+            int i = g.find(p.r, p.c);
+            dg.add(p.r, p.c, g.type(i), g.hp(i));
+        }
+        begin = end;
+        // the fragment's center of mass relative to the ship's, in world px
+        SimReal dr = SimReal(dg.com_r()) - comR, dc = SimReal(dg.com_c()) - comC;
+        SimReal ox = (dc * cA - dr * sA) * GRID_CELL, oy = (dc * sA + dr * cA) * GRID_CELL;
+        db.prevX[d] = sh.prevX[ship]; db.prevY[d] = sh.prevY[ship]; db.prevAngle[d] = sh.prevAngle[ship];
+        SimVec2 vel = shipVel(sh, ship) + SimVec2(-oy, ox) * (SimReal(sh.angVel[ship]) / 60) + SimVec2(ox, oy).normalized() * DEBRIS_PUSH;
+        db.vx[d] = sim_to_double(vel.x); db.vy[d] = sim_to_double(vel.y);
+        db.angVel[d] = sh.angVel[ship];
+        db.ttl[d] = DEBRIS_LIFETIME;
     }
+    for(const CellPos &p : s.fragmentCells) g.remove(p.r, p.c);
+}
+
+// a drone's shove is sized for the starting ship; lighter and heavier ships take it by mass
+static const SimReal DRONE_SHOVE_MASS(10.0);
 
-    if(g_resources >= 300){ g_gameOver = true; g_paused = true; }
-    if(g_ship.vel.len() < 0.01 && tickCount > 60*50 && g_drones.size() > 20){ g_gameOver = true; }
+// the read phases' events, in order: phase, then miner / drone / ship and contact. Each sees
+// what the ones before it did (a block already broken takes no more damage).
+static void applyEvents(Session& s){
+    PROFILE_ZONE("apply");
+    ShipStore &sh = s.ships;
+    for(const TickEvent &e : s.events.merge()){
+        if(e.kind == TICK_SHIP_HIT){
+            SimReal mass(sh.grid[e.ship].mass() > 0 ? sh.grid[e.ship].mass() : 1.0);
+            SimVec2 vel = shipVel(sh, e.ship) + SimVec2(SimReal(e.amount) * DRONE_SHOVE_MASS / mass, SimReal(0));
+            sh.vx[e.ship] = sim_to_double(vel.x); sh.vy[e.ship] = sim_to_double(vel.y);
+            s.score -= 2;
+            continue;
+        }
+        if(e.kind == TICK_SHIP_DAMAGE){
+            ShipGrid &g = sh.grid[e.ship];
+            int i = g.find(e.r, e.c);
+            if(i < 0) continue; // destroyed or cut loose earlier this tick
+            if(g.hp(i) > e.amount){ g.set_hp(i, g.hp(i) - e.amount); continue; }
+            g.remove(e.r, e.c);
+            cutLoose(s, e.ship, e.r, e.c);
+            continue;
+        }
+        Block *b = s.world.find(e.r, e.c);
+        if(!b || b->empty()) continue;
+        if(e.kind == TICK_MINE){
+            const BlockInfo &info = block_info(b->type());
+            if(info.mineResources == 0) continue;
+            if(b->damage(1 + s.rng.range(3))){
+                s.world.clear(e.r, e.c);
+                if(e.ship == PLAYER_SHIP){ s.resources += info.mineResources; s.score += info.mineScore; }
+            }
+        } else {
+            if(b->damage(e.amount)){ s.world.clear(e.r, e.c); s.resources += e.reward; }
+        }
+    }
 }
 
-// Simple world accessors for renderer & input
-const Block* game_get_world_ptr(){ return &g_world[0][0]; }
-const std::vector<Drone>& game_get_drones(){ return g_drones; }
-void game_get_player_pos(double &x, double &y){ x = g_ship.pos_x; y = g_ship.pos_y; }
-double game_get_player_angle(){ return g_ship.angle; }
+// loose pieces drift like a ship without thrust: the center of mass moves with vel, the piece
+// turns about it, and both slow a little every tick. Each piece moves on its own, so the pool
+// splits across workers; expired pieces are swapped out afterwards.
+static const SimReal DEBRIS_DRAG(0.995);
+
+static void moveDebris(Session& s){
+    PROFILE_ZONE("debris");
+    ShipStore &db = s.debris;
+    forRanges(s, db.size(), SHIP_RANGE, [&](int begin, int end, int){
+        for(int k=begin;k<end;k++){
+            if(--db.ttl[k] <= 0) continue;
+            const ShipGrid &g = db.grid[k];
+            SimReal comX = SimReal(g.com_c()) * GRID_CELL, comY = SimReal(g.com_r()) * GRID_CELL;
+            SimReal vx(db.vx[k]), vy(db.vy[k]), angVel(db.angVel[k]), sA, cA, sB, cB;
+            sim_sin_cos(SimReal(db.angle[k]), sA, cA);
+            SimReal cx = SimReal(db.x[k]) + comX * cA - comY * sA + vx;
+            SimReal cy = SimReal(db.y[k]) + comX * sA + comY * cA + vy;
+            SimReal angle = SimReal(db.angle[k]) + angVel * TICK_SECONDS;
+            sim_sin_cos(angle, sB, cB);
+            db.angle[k] = sim_to_double(angle);
+            db.x[k] = sim_to_double(cx - (comX * cB - comY * sB));
+            db.y[k] = sim_to_double(cy - (comX * sB + comY * cB));
+            db.vx[k] = sim_to_double(vx * DEBRIS_DRAG); db.vy[k] = sim_to_double(vy * DEBRIS_DRAG);
+            db.angVel[k] = sim_to_double(angVel * DEBRIS_DRAG);
+        }
+    });
+    for(int k=db.size()-1;k>=0;k--) if(db.ttl[k] <= 0) db.remove_swap(k);
+}
+
+static void spawnDrones(Session& s){
+    PROFILE_ZONE("spawn");
+    if(s.tickCount % (60 * 6) == 0){
+        if(s.rng.range(100) < 40){
+            Drone d; d.x = (s.world.cols() - 4) * GRID_CELL; d.y = s.rng.range(s.world.rows()) * GRID_CELL; d.hp = 50;
+            d.angle = 0; d.cooldown = 0;
+            s.drones.push(d);
+        }
+    }
+}
+
+static void checkEndConditions(Session& s){
+    if(s.resources >= 300){ s.gameOver = true; s.paused = true; }
+    if(shipVel(s.ships, PLAYER_SHIP).len() < SimReal(0.01) && s.tickCount > 60*50 && s.drones.size() > 20){ s.gameOver = true; }
+}
+
+// previous-tick transforms for render interpolation; saved even when paused so a frozen
+// session renders still instead of blending toward a tick that never comes
+static void savePrevState(Session& s){
+    s.ships.save_prev();
+    s.debris.save_prev();
+    s.drones.save_prev();
+}
+
+// the tick phases in GamePhase order; both update entry points run this one table
+static void (*const PHASES[PHASE_COUNT])(Session&) = { streamWorld, applyShipForces, shipMining, drones_update, world_collisions, applyEvents, moveDebris, spawnDrones };
+
+// one tick; phaseNs (nullptr = untimed) gets the wall time of each phase added
+static void runTick(Session& s, uint64_t* phaseNs){
+    typedef std::chrono::steady_clock clk;
+    savePrevState(s);
+    if(s.paused || s.gameOver) return;
+    PROFILE_ZONE("tick");
+    s.world.clear_changes(); // after a tick, world.changes() lists that tick's changes
+    s.events.begin(s.pool ? s.pool->size() : 1);
+    s.tickCount++;
+    for(int p=0;p<PHASE_COUNT;p++){
+        if(!phaseNs){ PHASES[p](s); continue; }
+        clk::time_point t0 = clk::now();
+        PHASES[p](s);
+        phaseNs[p] += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(clk::now() - t0).count();
+    }
+    checkEndConditions(s);
+    if(s.tickHook) s.tickHook(s, s.tickHookUser);
+}
+
+void session_update(Session& s){ runTick(s, nullptr); }
+
+void session_update_timed(Session& s, uint64_t phaseNs[PHASE_COUNT]){ runTick(s, phaseNs); }
+
+const char* game_phase_name(int phase){
+    static const char* names[PHASE_COUNT] = { "stream", "ship_forces", "mining", "drones", "collisions", "apply", "debris", "spawn" };
+    return (phase >= 0 && phase < PHASE_COUNT) ? names[phase] : "?";
+}
+
+void game_update(){
+    session_update(g_session);
+    flushDirtyCells();
+}
 
-// Input & utility hooks provided by input.cpp (declared in input.hpp)
-extern Vec2 get_input_thrust();
-extern bool input_is_paused();
+const std::vector<CellPos>& game_dirty_cells(){ return g_dirtyCells; }
+void game_clear_dirty_cells(){ g_dirtyCells.clear(); }
+unsigned game_world_generation(){ return g_worldGeneration; }
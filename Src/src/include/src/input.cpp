@@ -1,7 +1,14 @@
 // src/input.cpp
 #include "input.hpp"
+#include "frame_scheduler.hpp"
+#include "input_queue.hpp"
+#include <cmath>
 #include <cstring>
 
+// Window messages become timestamped events on g_queue (window thread); input_drain() applies
+// them to the state below on the consuming thread, which is then the only one touching it.
+static InputQueue g_queue;
+
 static bool keysDown[256] = {0};
 static POINT mousePos = {0,0};
 static bool mouseLeftDown = false;
@@ -24,12 +31,14 @@ Vec2 get_input_thrust(){
     return dir;
 }
 bool input_is_paused(){ return keysDown['P'] || keysDown['p']; }
+unsigned input_dropped_events(){ return g_queue.dropped(); }
 
-void input_handle_window_event(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam){
-    switch(msg){
-        case WM_LBUTTONDOWN:
+static void applyEvent(const InputEvent& e){
+    switch(e.kind){
+        case INPUT_POINTER_DOWN:
+            mousePos.x = e.x; mousePos.y = e.y;
+            if(e.key == 1){ mouseRightDown = true; break; }
             mouseLeftDown = true;
-            mousePos.x = LOWORD(lParam); mousePos.y = HIWORD(lParam);
             {
                 int dx = mousePos.x - joystickCenter.x;
                 int dy = mousePos.y - joystickCenter.y;
@@ -42,17 +51,12 @@ void input_handle_window_event(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam
                 }
             }
             break;
-        case WM_LBUTTONUP:
+        case INPUT_POINTER_UP:
+            if(e.key == 1){ mouseRightDown = false; break; }
             mouseLeftDown = false; usingJoystick = false; joystickX=joystickY=0;
             break;
-        case WM_RBUTTONDOWN:
-            mouseRightDown = true; SetCapture(hwnd);
-            break;
-        case WM_RBUTTONUP:
-            mouseRightDown = false; ReleaseCapture();
-            break;
-        case WM_MOUSEMOVE:
-            mousePos.x = LOWORD(lParam); mousePos.y = HIWORD(lParam);
+        case INPUT_POINTER_MOVE:
+            mousePos.x = e.x; mousePos.y = e.y;
             if(usingJoystick && mouseLeftDown){
                 int dx = mousePos.x - joystickCenter.x;
                 int dy = mousePos.y - joystickCenter.y;
@@ -62,13 +66,49 @@ void input_handle_window_event(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam
                 if(len > 1.0){ joystickX/=len; joystickY/=len; }
             }
             break;
+        case INPUT_KEY_DOWN:
+            keysDown[e.key & 0xFF] = true;
+            break;
+        case INPUT_KEY_UP:
+            keysDown[e.key & 0xFF] = false;
+            break;
+        default: break;
+    }
+}
+
+int input_drain(double* oldest){
+    InputEvent e;
+    int n = 0;
+    while(g_queue.pop(e)){
+        if(n == 0 && oldest) *oldest = e.time;
+        applyEvent(e);
+        n++;
+    }
+    return n;
+}
+
+void input_handle_window_event(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam){
+    InputEvent e;
+    e.time = sched_default_now(nullptr);
+    e.key = 0;
+    e.x = (short)LOWORD(lParam); e.y = (short)HIWORD(lParam);
+    switch(msg){
+        case WM_LBUTTONDOWN: e.kind = INPUT_POINTER_DOWN; break;
+        case WM_LBUTTONUP:   e.kind = INPUT_POINTER_UP; break;
+        // capture belongs to the window's thread, so it is taken here rather than on drain
+        case WM_RBUTTONDOWN: e.kind = INPUT_POINTER_DOWN; e.key = 1; SetCapture(hwnd); break;
+        case WM_RBUTTONUP:   e.kind = INPUT_POINTER_UP; e.key = 1; ReleaseCapture(); break;
+        case WM_MOUSEMOVE:   e.kind = INPUT_POINTER_MOVE; break;
         case WM_KEYDOWN:
-            keysDown[wParam & 0xFF] = true;
             if(wParam == VK_ESCAPE) PostQuitMessage(0);
+            e.kind = INPUT_KEY_DOWN; e.key = (int)(wParam & 0xFF); e.x = e.y = 0;
             break;
         case WM_KEYUP:
-            keysDown[wParam & 0xFF] = false;
+            e.kind = INPUT_KEY_UP; e.key = (int)(wParam & 0xFF); e.x = e.y = 0;
             break;
-        default: break;
+        default: return;
     }
+    g_queue.push(e);
 }
+
+void input_flush(){ g_queue.flush(); }
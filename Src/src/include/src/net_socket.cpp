@@ -0,0 +1,249 @@
+// src/net_socket.cpp
+#include "net_socket.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#endif
+typedef SOCKET RawSocket;
+static const int SEND_FLAGS = 0;
+static bool wouldBlock(){ return WSAGetLastError() == WSAEWOULDBLOCK; }
+static void closeRaw(RawSocket s){ closesocket(s); }
+static void setNonBlocking(RawSocket s){ u_long on = 1; ioctlsocket(s, FIONBIO, &on); }
+static bool startup(){
+    static bool started = false;
+    if(!started){ WSADATA wsa; started = WSAStartup(MAKEWORD(2, 2), &wsa) == 0; }
+    return started;
+}
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int RawSocket;
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL; // a closed peer is an error return, not SIGPIPE
+#else
+static const int SEND_FLAGS = 0;
+#endif
+static bool wouldBlock(){ return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+static void closeRaw(RawSocket s){ ::close(s); }
+static void setNonBlocking(RawSocket s){ fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK); }
+static bool startup(){ return true; }
+#endif
+
+static RawSocket raw(NetSocket s){ return (RawSocket)s; }
+
+// tcp:host:port -> host, port; unix:path -> path (isUnix)
+static bool parseAddr(const char* addr, std::string& host, std::string& port, bool& isUnix){
+    std::string a = addr ? addr : "";
+    isUnix = a.compare(0, 5, "unix:") == 0;
+    if(isUnix){ host = a.substr(5); return !host.empty(); }
+    if(a.compare(0, 4, "tcp:") == 0) a = a.substr(4);
+    size_t colon = a.rfind(':');
+    if(colon == std::string::npos || colon + 1 == a.size()) return false;
+    host = a.substr(0, colon); port = a.substr(colon + 1);
+    if(host.empty()) host = "127.0.0.1";
+    return true;
+}
+
+static void tuneTcp(RawSocket s){
+    int on = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&on, sizeof(on));
+}
+
+// socket bound (listen) or connected to addr
+static NetSocket openAddr(const char* addr, bool listen){
+    std::string host, port;
+    bool isUnix;
+    if(!startup() || !parseAddr(addr, host, port, isUnix)) return NET_INVALID;
+#ifdef _WIN32
+    if(isUnix) return NET_INVALID;
+#else
+    if(isUnix){
+        sockaddr_un sa; memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        if(host.size() >= sizeof(sa.sun_path)) return NET_INVALID;
+        memcpy(sa.sun_path, host.c_str(), host.size());
+        RawSocket s = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(s < 0) return NET_INVALID;
+        if(listen){
+            unlink(host.c_str());
+            if(bind(s, (sockaddr*)&sa, sizeof(sa)) != 0 || ::listen(s, 16) != 0){ closeRaw(s); return NET_INVALID; }
+            setNonBlocking(s);
+        }else{
+            if(connect(s, (sockaddr*)&sa, sizeof(sa)) != 0){ closeRaw(s); return NET_INVALID; }
+            setNonBlocking(s);
+        }
+        return (NetSocket)s;
+    }
+#endif
+    addrinfo hints, *res = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listen ? AI_PASSIVE : 0;
+    if(getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return NET_INVALID;
+    NetSocket out = NET_INVALID;
+    for(addrinfo *ai = res; ai && out == NET_INVALID; ai = ai->ai_next){
+        RawSocket s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+#ifdef _WIN32
+        if(s == INVALID_SOCKET) continue;
+#else
+        if(s < 0) continue;
+#endif
+        bool ok;
+        if(listen){
+            int on = 1;
+            setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&on, sizeof(on));
+            ok = bind(s, ai->ai_addr, (int)ai->ai_addrlen) == 0 && ::listen(s, 16) == 0;
+        }else{
+            ok = connect(s, ai->ai_addr, (int)ai->ai_addrlen) == 0;
+            if(ok) tuneTcp(s);
+        }
+        if(!ok){ closeRaw(s); continue; }
+        setNonBlocking(s);
+        out = (NetSocket)s;
+    }
+    freeaddrinfo(res);
+    return out;
+}
+
+NetSocket net_listen(const char* addr){ return openAddr(addr, true); }
+NetSocket net_connect(const char* addr){ return openAddr(addr, false); }
+
+NetSocket net_accept(NetSocket listener){
+    if(listener == NET_INVALID) return NET_INVALID;
+    RawSocket s = accept(raw(listener), nullptr, nullptr);
+#ifdef _WIN32
+    if(s == INVALID_SOCKET) return NET_INVALID;
+#else
+    if(s < 0) return NET_INVALID;
+#endif
+    setNonBlocking(s);
+    tuneTcp(s); // fails harmlessly on a unix socket
+    return (NetSocket)s;
+}
+
+void net_close(NetSocket s){ if(s != NET_INVALID) closeRaw(raw(s)); }
+
+void net_unlisten(NetSocket s, const char* addr){
+    net_close(s);
+#ifndef _WIN32
+    std::string host, port;
+    bool isUnix;
+    if(s != NET_INVALID && parseAddr(addr, host, port, isUnix) && isUnix) unlink(host.c_str());
+#else
+    (void)addr;
+#endif
+}
+
+long net_send(NetSocket s, const void* p, size_t n){
+    if(s == NET_INVALID) return -1;
+    if(n == 0) return 0;
+    long r = (long)send(raw(s), (const char*)p, (int)(n > (1u << 30) ? (1u << 30) : n), SEND_FLAGS);
+    if(r < 0) return wouldBlock() ? 0 : -1;
+    return r;
+}
+
+long net_recv(NetSocket s, void* p, size_t n){
+    if(s == NET_INVALID) return -1;
+    long r = (long)recv(raw(s), (char*)p, (int)(n > (1u << 30) ? (1u << 30) : n), 0);
+    if(r == 0) return -1; // orderly shutdown
+    if(r < 0) return wouldBlock() ? 0 : -1;
+    return r;
+}
+
+bool net_wait(const NetSocket* socks, int n, int ms){
+    if(n <= 0) return false;
+#ifdef _WIN32
+    std::vector<WSAPOLLFD> fds(n);
+    for(int i=0;i<n;i++){ fds[i].fd = raw(socks[i]); fds[i].events = POLLRDNORM; fds[i].revents = 0; }
+    return WSAPoll(fds.data(), (ULONG)n, ms) > 0;
+#else
+    std::vector<pollfd> fds(n);
+    for(int i=0;i<n;i++){ fds[i].fd = raw(socks[i]); fds[i].events = POLLIN; fds[i].revents = 0; }
+    return poll(fds.data(), (nfds_t)n, ms) > 0;
+#endif
+}
+
+NetLink::NetLink(NetSocket s, size_t maxQueued){
+    m_sock = s;
+    m_maxQueued = maxQueued;
+    m_outAt = 0; m_inAt = 0;
+    m_sent = 0; m_received = 0;
+}
+
+NetLink::~NetLink(){ close(); }
+
+void NetLink::close(){
+    net_close(m_sock);
+    m_sock = NET_INVALID;
+    m_out.clear(); m_in.clear();
+    m_outAt = 0; m_inAt = 0;
+}
+
+bool NetLink::send(const uint8_t* msg, size_t n){
+    if(!open()) return false;
+    if(queued() + n + 10 > m_maxQueued){ close(); return false; }
+    if(m_outAt > 0 && m_outAt * 2 >= m_out.size()){ // drop what has gone out before growing
+        m_out.erase(m_out.begin(), m_out.begin() + m_outAt);
+        m_outAt = 0;
+    }
+    uint64_t v = n;
+    while(v >= 0x80){ m_out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    m_out.push_back((uint8_t)v);
+    m_out.insert(m_out.end(), msg, msg + n);
+    return flush();
+}
+
+bool NetLink::flush(){
+    if(!open()) return false;
+    while(m_outAt < m_out.size()){
+        long r = net_send(m_sock, m_out.data() + m_outAt, m_out.size() - m_outAt);
+        if(r < 0){ close(); return false; }
+        if(r == 0) break;
+        m_outAt += (size_t)r; m_sent += (uint64_t)r;
+    }
+    if(m_outAt == m_out.size()){ m_out.clear(); m_outAt = 0; }
+    return true;
+}
+
+bool NetLink::receive(std::vector<uint8_t>& msg){
+    if(!open()) return false;
+    // a complete message already buffered goes first; read only when there is none
+    for(;;){
+        size_t at = m_inAt;
+        uint64_t len = 0;
+        bool have = false;
+        for(int shift=0; at < m_in.size() && shift < 64; shift += 7){
+            uint8_t b = m_in[at++];
+            len |= (uint64_t)(b & 0x7f) << shift;
+            if(!(b & 0x80)){ have = true; break; }
+        }
+        if((!have && at - m_inAt >= 10) || (have && len > MAX_MESSAGE)){ close(); return false; }
+        if(have && m_in.size() - at >= len){
+            msg.assign(m_in.begin() + at, m_in.begin() + at + (size_t)len);
+            m_inAt = at + (size_t)len;
+            if(m_inAt == m_in.size()){ m_in.clear(); m_inAt = 0; }
+            return true;
+        }
+        if(m_inAt > 0){ m_in.erase(m_in.begin(), m_in.begin() + m_inAt); m_inAt = 0; }
+        uint8_t buf[16384];
+        long r = net_recv(m_sock, buf, sizeof(buf));
+        if(r < 0){ close(); return false; }
+        if(r == 0) return false;
+        m_in.insert(m_in.end(), buf, buf + r);
+        m_received += (uint64_t)r;
+    }
+}
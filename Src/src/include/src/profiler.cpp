@@ -0,0 +1,168 @@
+// src/profiler.cpp
+#include "profiler.hpp"
+
+#if defined(PROFILE_ENABLED)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+static const uint64_t RING_MASK = PROFILE_RING_EVENTS - 1;
+static const uint64_t ROLLING_REFRESH_NS = 250000000ull;
+static const double ROLLING_WINDOW_SEC = 2.0;
+
+struct ProfileEvent { const char* name; uint64_t start, end; };
+
+// A ring slot. Readers may copy a slot while its owner rewrites it, so every field is atomic
+// (relaxed: x86 compiles these to plain moves) and torn copies are discarded, not raced on.
+struct ProfileSlot { std::atomic<const char*> name; std::atomic<uint64_t> start, end; };
+
+// One thread's zones, seqlock style. The owner is the only writer: a release fence, the slot
+// fields, then head advanced with release. Readers copy slots, fence with acquire and re-read
+// head, dropping any slot the writer may have started to reuse in the meantime.
+struct ProfileRing {
+    std::atomic<uint64_t> head;         // zones ever recorded; slot = index & RING_MASK
+    std::atomic<const char*> name;
+    int tid;
+    ProfileSlot events[PROFILE_RING_EVENTS];
+};
+
+static std::mutex g_ringsMutex;
+static std::vector<ProfileRing*> g_rings; // never freed, so a finished thread's zones still export
+static thread_local ProfileRing* t_ring = nullptr;
+
+static ProfileRing* threadRing(){
+    if(!t_ring){
+        ProfileRing *r = new ProfileRing();
+        r->head.store(0); r->name.store(nullptr);
+        std::lock_guard<std::mutex> lock(g_ringsMutex);
+        r->tid = (int)g_rings.size() + 1;
+        g_rings.push_back(r);
+        t_ring = r;
+    }
+    return t_ring;
+}
+
+uint64_t profiler_now_ns(){
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void profiler_record(const char* name, uint64_t startNs, uint64_t endNs){
+    ProfileRing *r = threadRing();
+    uint64_t h = r->head.load(std::memory_order_relaxed);
+    ProfileSlot &e = r->events[h & RING_MASK];
+    // a reader that sees any of these stores also sees head >= h, so it knows the slot is reused
+    std::atomic_thread_fence(std::memory_order_release);
+    e.name.store(name, std::memory_order_relaxed);
+    e.start.store(startNs, std::memory_order_relaxed);
+    e.end.store(endNs, std::memory_order_relaxed);
+    r->head.store(h + 1, std::memory_order_release);
+}
+
+void profiler_thread_name(const char* name){ threadRing()->name.store(name, std::memory_order_relaxed); }
+
+bool profiler_enabled(){ return true; }
+
+// Appends the ring's zones that ended at or after sinceNs, newest first. Zones end in order
+// on their thread, so the walk stops at the first older one.
+static void readRing(ProfileRing& r, uint64_t sinceNs, std::vector<ProfileEvent>& out){
+    uint64_t h = r.head.load(std::memory_order_acquire);
+    uint64_t first = h > PROFILE_RING_EVENTS ? h - PROFILE_RING_EVENTS : 0;
+    size_t base = out.size();
+    for(uint64_t i=h;i>first;i--){
+        const ProfileSlot &slot = r.events[(i - 1) & RING_MASK];
+        ProfileEvent e;
+        e.name = slot.name.load(std::memory_order_relaxed);
+        e.start = slot.start.load(std::memory_order_relaxed);
+        e.end = slot.end.load(std::memory_order_relaxed);
+        if(e.end < sinceNs) break;
+        out.push_back(e);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t h2 = r.head.load(std::memory_order_relaxed);
+    // out[base + k] came from index h-1-k; the writer may be rewriting index h2's slot, so
+    // indices up to h2 - ring size may have been reused
+    uint64_t safe = h2 + 1 > PROFILE_RING_EVENTS ? h2 + 1 - PROFILE_RING_EVENTS : 0;
+    size_t keep = safe >= h ? 0 : (size_t)std::min<uint64_t>(out.size() - base, h - safe);
+    out.resize(base + keep);
+}
+
+static std::vector<ProfileRing*> ringList(){
+    std::lock_guard<std::mutex> lock(g_ringsMutex);
+    return g_rings;
+}
+
+void profiler_zone_stats(double windowSec, std::vector<ProfileZoneStats>& out){
+    out.clear();
+    uint64_t now = profiler_now_ns(), window = (uint64_t)(windowSec * 1e9);
+    uint64_t since = now > window ? now - window : 0;
+    std::vector<ProfileEvent> events;
+    for(ProfileRing *r : ringList()) readRing(*r, since, events);
+    // group by name (equal literals in different files may have different addresses), each
+    // group ordered by duration for the percentiles
+    std::sort(events.begin(), events.end(), [](const ProfileEvent& a, const ProfileEvent& b){
+        int c = strcmp(a.name, b.name);
+        return c != 0 ? c < 0 : a.end - a.start < b.end - b.start;
+    });
+    for(size_t i=0;i<events.size();){
+        size_t j = i;
+        while(j < events.size() && strcmp(events[j].name, events[i].name) == 0) j++;
+        size_t n = j - i;
+        ProfileZoneStats z;
+        z.name = events[i].name; z.count = (int)n;
+        z.p50Ms = (events[i + (n - 1) * 50 / 100].end - events[i + (n - 1) * 50 / 100].start) * 1e-6;
+        z.p99Ms = (events[i + (n - 1) * 99 / 100].end - events[i + (n - 1) * 99 / 100].start) * 1e-6;
+        z.maxMs = (events[j - 1].end - events[j - 1].start) * 1e-6;
+        out.push_back(z);
+        i = j;
+    }
+}
+
+const std::vector<ProfileZoneStats>& profiler_rolling_stats(){
+    static std::vector<ProfileZoneStats> stats;
+    static uint64_t last = 0;
+    uint64_t now = profiler_now_ns();
+    if(last == 0 || now - last >= ROLLING_REFRESH_NS){
+        profiler_zone_stats(ROLLING_WINDOW_SEC, stats);
+        last = now;
+    }
+    return stats;
+}
+
+bool profiler_write_chrome_trace(const char* path){
+    FILE *f = fopen(path, "wb");
+    if(!f) return false;
+    std::vector<ProfileRing*> rings = ringList();
+    std::vector<std::vector<ProfileEvent>> perRing(rings.size());
+    uint64_t t0 = UINT64_MAX;
+    for(size_t k=0;k<rings.size();k++){
+        readRing(*rings[k], 0, perRing[k]);
+        for(const ProfileEvent &e : perRing[k]) t0 = std::min(t0, e.start);
+    }
+    fprintf(f, "{\"traceEvents\":[\n");
+    bool first = true;
+    for(size_t k=0;k<rings.size();k++){
+        const char *name = rings[k]->name.load(std::memory_order_relaxed);
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",\n", rings[k]->tid, name ? name : "thread");
+        first = false;
+        // readRing lists newest first; traces read more naturally in time order
+        for(auto it = perRing[k].rbegin(); it != perRing[k].rend(); ++it)
+            fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                it->name, rings[k]->tid, (it->start - t0) * 1e-3, (it->end - it->start) * 1e-3);
+    }
+    fprintf(f, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    bool ok = !ferror(f);
+    return fclose(f) == 0 && ok;
+}
+
+#else
+
+bool profiler_enabled(){ return false; }
+void profiler_zone_stats(double, std::vector<ProfileZoneStats>& out){ out.clear(); }
+const std::vector<ProfileZoneStats>& profiler_rolling_stats(){ static std::vector<ProfileZoneStats> none; return none; }
+bool profiler_write_chrome_trace(const char*){ return false; }
+
+#endif
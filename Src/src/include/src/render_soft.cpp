@@ -0,0 +1,158 @@
+// src/render_soft.cpp
+#include "render_soft.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+static Camera g_cam;
+static DrawList g_drawList;
+static double g_worldMs = 0;
+// cells the last world or map pass showed, [r0,r1) x [c0,c1): the minimap frames them
+static double g_viewR0 = 0, g_viewC0 = 0, g_viewR1 = 0, g_viewC1 = 0;
+static const uint32_t SPACE_COLOR = 0x0A0A1C;
+static const int MINIMAP_TOP = 252, MINIMAP_MAX_H = 160;
+
+void render_draw_text(Framebuffer& fb, int x, int y, const char* s, uint32_t color, int scale){
+    fb_draw_text(fb, x, y, s, color, scale);
+}
+
+// one pass per material: every item of a material is drawn with the same color
+static void submitDrawList(Framebuffer& fb, const DrawList& dl){
+    for(int m=0;m<MAT_COUNT;m++){
+        uint32_t color = draw_material_color(m);
+        for(int i=dl.batchStart[m]; i<dl.batchStart[m+1]; i++){
+            const DrawItem &it = dl.items[i];
+            switch(it.shape){
+                case SHAPE_RECT: fb_fill_rect(fb, it.x0, it.y0, it.x1, it.y1, color); break;
+                case SHAPE_FRAME: fb_frame_rect(fb, it.x0, it.y0, it.x1, it.y1, color); break;
+                default: fb_fill_triangle(fb, it.x0, it.y0, it.x1, it.y1, it.x2, it.y2, color); break;
+            }
+        }
+    }
+}
+
+void render_draw_world(Framebuffer& fb, double alpha){
+    PROFILE_ZONE("render_world");
+    typedef std::chrono::steady_clock clk;
+    clk::time_point t0 = clk::now();
+    // camera follow player
+    const SimSnapshot &snap = sim_view();
+    double pwx, pwy; snapshot_ship_lerp(snap, alpha, pwx, pwy);
+    g_cam.viewW = std::min(fb.width, game_get_window_width() - game_get_hud_width());
+    g_cam.viewH = std::min(fb.height, game_get_window_height());
+    camera_follow(g_cam, pwx, pwy);
+
+    Framebuffer view = fb; view.width = g_cam.viewW; view.height = g_cam.viewH;
+    fb_clear(view, fb_rgb(10,10,28));
+
+    const WorldGrid &world = sim_view_world();
+    int ox = camera_ox(g_cam), oy = camera_oy(g_cam);
+    int r0, c0, r1, c1;
+    camera_visible_cells(g_cam, GRID_CELL, r0, c0, r1, c1);
+    int tr0 = std::max(r0, 0), tc0 = std::max(c0, 0);
+    int tr1 = std::min(r1, world.rows()-1), tc1 = std::min(c1, world.cols()-1);
+    if(tr0 <= tr1 && tc0 <= tc1)
+        fb_fill_rect(view, tc0*GRID_CELL - ox, tr0*GRID_CELL - oy, (tc1+1)*GRID_CELL - ox, (tr1+1)*GRID_CELL - oy, draw_material_color(MAT_TILE));
+
+    g_drawList.clear();
+    draw_list_add_cells(g_drawList, world, r0, c0, r1, c1, ox, oy);
+    draw_list_add_entities(g_drawList, g_cam, snap, alpha);
+    draw_list_sort(g_drawList);
+    submitDrawList(view, g_drawList);
+
+    g_viewR0 = (double)oy / GRID_CELL; g_viewC0 = (double)ox / GRID_CELL;
+    g_viewR1 = (double)(oy + g_cam.viewH) / GRID_CELL; g_viewC1 = (double)(ox + g_cam.viewW) / GRID_CELL;
+
+    double ms = std::chrono::duration<double, std::milli>(clk::now() - t0).count();
+    g_worldMs += (ms - g_worldMs) * 0.1;
+}
+
+void render_draw_map(Framebuffer& fb, double cellsPerPixel, double alpha){
+    PROFILE_ZONE("render_map");
+    const SimSnapshot &snap = sim_view();
+    double pwx, pwy; snapshot_ship_lerp(snap, alpha, pwx, pwy);
+    int viewW = std::min(fb.width, game_get_window_width() - game_get_hud_width());
+    int viewH = std::min(fb.height, game_get_window_height());
+    g_viewC0 = pwx / GRID_CELL - viewW / 2.0 * cellsPerPixel;
+    g_viewR0 = pwy / GRID_CELL - viewH / 2.0 * cellsPerPixel;
+    g_viewC1 = g_viewC0 + viewW * cellsPerPixel; g_viewR1 = g_viewR0 + viewH * cellsPerPixel;
+    int level = world_summary_draw(fb, sim_view_summary(), 0, 0, viewW, viewH, g_viewR0, g_viewC0, cellsPerPixel, SPACE_COLOR);
+
+    int sx = viewW / 2, sy = viewH / 2;
+    fb_fill_triangle(fb, sx, sy - 6, sx - 5, sy + 6, sx + 5, sy + 6, draw_material_color(MAT_SHIP));
+    char line[64];
+    snprintf(line, sizeof(line), "Map: %g cells/px, level %d", cellsPerPixel, level);
+    render_draw_text(fb, 12, 12, line, fb_rgb(170,170,200));
+}
+
+// the whole map from the summary, framed where the view is, with the ship as a dot
+static int drawMinimap(Framebuffer& fb, int x, int y, int maxW){
+    const WorldSummary &sum = sim_view_summary();
+    int w, h;
+    double cpp = world_summary_fit(sum, maxW, MINIMAP_MAX_H, w, h);
+    if(w <= 0 || h <= 0) return 0;
+    world_summary_draw(fb, sum, x, y, w, h, 0, 0, cpp, SPACE_COLOR);
+    Framebuffer map = fb; // clip the overlay to the minimap
+    map.pixels = fb.pixels + (size_t)y * fb.stride + x;
+    map.width = std::min(w, fb.width - x); map.height = std::min(h, fb.height - y);
+    fb_frame_rect(map, (int)std::floor(g_viewC0 / cpp), (int)std::floor(g_viewR0 / cpp),
+        (int)std::ceil(g_viewC1 / cpp), (int)std::ceil(g_viewR1 / cpp), fb_rgb(200,200,230));
+    int sx = (int)(sim_view().shipX / GRID_CELL / cpp), sy = (int)(sim_view().shipY / GRID_CELL / cpp);
+    fb_fill_rect(map, sx - 1, sy - 1, sx + 2, sy + 2, draw_material_color(MAT_SHIP));
+    return h;
+}
+
+void render_draw_hud(Framebuffer& fb){
+    PROFILE_ZONE("render_hud");
+    int left = game_get_window_width() - game_get_hud_width();
+    int h = game_get_window_height();
+    fb_fill_rect(fb, left, 0, left + game_get_hud_width(), h, fb_rgb(25,25,40));
+
+    char line[64];
+    render_draw_text(fb, left+12, 12, "SPACE ENGINEERS LITE (Mobile Demo)");
+    snprintf(line, sizeof(line), "Resources: %d", sim_view().resources);
+    render_draw_text(fb, left+12, 44, line);
+    snprintf(line, sizeof(line), "Score: %d", sim_view().score);
+    render_draw_text(fb, left+12, 68, line);
+
+    render_draw_text(fb, left+12, 110, "Build Palette:");
+    fb_fill_rect(fb, left+12, 140, left+12+24, 140+24, fb_rgb(120,110,80));
+    render_draw_text(fb, left+12+24+8, 150, "1 - Armor (8 res)");
+    fb_fill_rect(fb, left+12, 180, left+12+24, 180+24, fb_rgb(200,80,40));
+    render_draw_text(fb, left+12+24+8, 190, "2 - Thruster (12 res)");
+    fb_fill_rect(fb, left+12, 220, left+12+24, 220+24, fb_rgb(80,160,200));
+    render_draw_text(fb, left+12+24+8, 230, "3 - Miner (10 res)");
+
+    int mapH = drawMinimap(fb, left+12, MINIMAP_TOP, game_get_hud_width() - 24);
+
+    // live zone timings (profiled builds only)
+    const std::vector<ProfileZoneStats> &zones = profiler_rolling_stats();
+    if(!zones.empty()){
+        render_draw_text(fb, left+12, MINIMAP_TOP + mapH + 14, "Zone         p50 / p99 ms", fb_rgb(170,170,200));
+        int y = MINIMAP_TOP + mapH + 30;
+        for(const ProfileZoneStats &z : zones){
+            if(y > h - 116) break;
+            snprintf(line, sizeof(line), "%-14.14s %6.3f %7.3f", z.name, z.p50Ms, z.p99Ms);
+            render_draw_text(fb, left+12, y, line, fb_rgb(140,140,170));
+            y += 12;
+        }
+    }
+
+    snprintf(line, sizeof(line), "World: %.3f ms (%d blocks)", g_worldMs, g_drawList.cells);
+    render_draw_text(fb, left+12, h-80, line, fb_rgb(140,140,170));
+    snprintf(line, sizeof(line), "Draw: %d items, %d drones", (int)g_drawList.items.size(), g_drawList.drones);
+    render_draw_text(fb, left+12, h-60, line, fb_rgb(140,140,170));
+    const InputLatencyStats &lat = sim_view_input_latency();
+    if(lat.count > 0){
+        snprintf(line, sizeof(line), "Input: %.1f / %.1f ms p50/p99", lat.p50Ms, lat.p99Ms);
+        render_draw_text(fb, left+12, h-100, line, fb_rgb(140,140,170));
+    }
+}
+
+void render_draw_ui(Framebuffer& fb){
+    int cx = 120, cy = game_get_window_height() - 120;
+    fb_fill_circle(fb, cx, cy, 60, fb_rgb(40,40,60));
+    fb_fill_circle(fb, cx, cy, 18, fb_rgb(120,180,200));
+}
@@ -0,0 +1,256 @@
+// src/replay.cpp
+#include "replay.hpp"
+#include <chrono>
+#include <cstring>
+
+static const char REPLAY_MAGIC[4] = { 'S', 'E', 'L', 'R' };
+
+struct ReplayHeader {
+    char magic[4];
+    uint32_t version, headerBytes, seed;
+    int32_t rows, cols;
+    uint32_t blockTicks, numeric; // SIM_NUMERIC of the recording build (0, double, in older files)
+};
+static_assert(sizeof(ReplayHeader) == 32, "replay header layout is part of the file format");
+
+// per block: BlockHeader, runBytes of runs, then one hash per tick
+struct BlockHeader { uint32_t firstTick, ticks, runs, runBytes; };
+// Thrust is stored as floats (what the Win32 input path produces); a run whose values do not
+// survive the round trip sets RUN_WIDE and is followed by the exact doubles.
+struct InputRun { uint32_t ticks; float x, y; };
+static const uint32_t RUN_WIDE = 0x80000000u;
+
+static inline uint64_t mix(uint64_t h, uint64_t w){ return (h ^ w) * 0x100000001B3ull; }
+static inline uint64_t bits(double v){ uint64_t w; memcpy(&w, &v, 8); return w; }
+
+static void hashShips(uint64_t& h, const ShipStore& sh, bool debris){
+    h = mix(h, (uint64_t)sh.size());
+    for(int i=0;i<sh.size();i++){
+        h = mix(h, bits(sh.x[i])); h = mix(h, bits(sh.y[i])); h = mix(h, bits(sh.angle[i]));
+        if(debris){ h = mix(h, (uint64_t)(uint32_t)sh.grid[i].size() << 32 | (uint32_t)sh.ttl[i]); continue; }
+        h = mix(h, bits(sh.vx[i])); h = mix(h, bits(sh.vy[i])); h = mix(h, bits(sh.angVel[i]));
+        const ShipGrid &g = sh.grid[i];
+        h = mix(h, (uint64_t)g.size());
+        for(int k=0;k<g.size();k++)
+            h = mix(h, (uint64_t)(uint16_t)g.row(k) << 48 | (uint64_t)(uint16_t)g.col(k) << 32 | (uint64_t)g.type(k) << 24 | (uint32_t)g.hp(k));
+    }
+}
+
+uint64_t replay_state_hash(const Session& s){
+    uint64_t h = 0xCBF29CE484222325ull;
+    h = mix(h, (uint64_t)(uint32_t)s.tickCount | (uint64_t)(uint32_t)s.resources << 32);
+    h = mix(h, (uint64_t)(uint32_t)s.score | (uint64_t)(s.paused | s.gameOver << 1) << 32);
+    h = mix(h, s.rng.s);
+    // every ship, then every loose piece; blocks too: damage and pieces cut loose change them
+    // without moving anything
+    hashShips(h, s.ships, false);
+    hashShips(h, s.debris, true);
+    const DroneStore &d = s.drones;
+    h = mix(h, (uint64_t)d.size());
+    for(int i=0;i<d.size();i++){
+        h = mix(h, bits(d.x[i])); h = mix(h, bits(d.y[i]));
+        h = mix(h, bits(d.vx[i])); h = mix(h, bits(d.vy[i]));
+        h = mix(h, (uint64_t)(uint32_t)d.hp[i]); h = mix(h, bits(d.cooldown[i]));
+    }
+    for(const CellPos &p : s.world.changes())
+        h = mix(h, (uint64_t)(uint32_t)p.r << 32 | (uint32_t)p.c << 3 | (uint32_t)s.world.get(p.r, p.c).type());
+    return h;
+}
+
+static uint32_t fold(uint64_t h){ return (uint32_t)(h ^ (h >> 32)); }
+
+ReplayRecorder::ReplayRecorder(){
+    m_file = nullptr; m_session = nullptr;
+    m_inner = nullptr; m_innerUser = nullptr;
+    m_ticks = 0; m_blockFirst = 1;
+    m_haveRun = false; m_failed = false;
+    m_runCount = 0; m_runAt = 0;
+}
+
+bool ReplayRecorder::start(Session& s, const char* path){
+    stop();
+    if(s.tickCount != 0) return false;
+    FILE* f = fopen(path, "wb");
+    if(!f) return false;
+    ReplayHeader h; memset(&h, 0, sizeof(h));
+    memcpy(h.magic, REPLAY_MAGIC, 4);
+    h.version = REPLAY_VERSION; h.headerBytes = sizeof(ReplayHeader);
+    h.seed = s.seed; h.rows = s.world.rows(); h.cols = s.world.cols();
+    h.blockTicks = REPLAY_BLOCK_TICKS; h.numeric = SIM_NUMERIC;
+    if(fwrite(&h, sizeof(h), 1, f) != 1){ fclose(f); return false; }
+    fflush(f);
+
+    m_file = f; m_session = &s;
+    m_inner = s.inputSource; m_innerUser = s.inputUser;
+    s.inputSource = input; s.inputUser = this;
+    s.tickHook = tick; s.tickHookUser = this;
+    m_ticks = 0; m_blockFirst = 1;
+    m_haveRun = false; m_failed = false;
+    m_runs.clear(); m_hashes.clear(); m_runCount = 0;
+    m_hashes.reserve(REPLAY_BLOCK_TICKS);
+    return true;
+}
+
+void ReplayRecorder::stop(){
+    if(!m_file) return;
+    flush_block();
+    fclose(m_file);
+    m_file = nullptr;
+    m_session->inputSource = m_inner; m_session->inputUser = m_innerUser;
+    m_session->tickHook = nullptr; m_session->tickHookUser = nullptr;
+    m_session = nullptr;
+}
+
+Vec2 ReplayRecorder::input(int tick, void* user){
+    ReplayRecorder &r = *(ReplayRecorder*)user;
+    Vec2 v = r.m_inner ? r.m_inner(tick, r.m_innerUser) : Vec2();
+    if(r.m_haveRun && bits(v.x) == bits(r.m_last.x) && bits(v.y) == bits(r.m_last.y)){
+        InputRun run; memcpy(&run, &r.m_runs[r.m_runAt], sizeof(run));
+        run.ticks++;
+        memcpy(&r.m_runs[r.m_runAt], &run, sizeof(run));
+        return v;
+    }
+    InputRun run; run.ticks = 1; run.x = (float)v.x; run.y = (float)v.y;
+    bool wide = (double)run.x != v.x || (double)run.y != v.y;
+    if(wide) run.ticks |= RUN_WIDE;
+    r.m_runAt = r.m_runs.size();
+    r.m_runs.resize(r.m_runAt + sizeof(run) + (wide ? 2 * sizeof(double) : 0));
+    memcpy(&r.m_runs[r.m_runAt], &run, sizeof(run));
+    if(wide){
+        memcpy(&r.m_runs[r.m_runAt + sizeof(run)], &v.x, sizeof(double));
+        memcpy(&r.m_runs[r.m_runAt + sizeof(run) + sizeof(double)], &v.y, sizeof(double));
+    }
+    r.m_runCount++;
+    r.m_last = v; r.m_haveRun = true;
+    return v;
+}
+
+void ReplayRecorder::tick(const Session& s, void* user){
+    ReplayRecorder &r = *(ReplayRecorder*)user;
+    r.m_hashes.push_back(fold(replay_state_hash(s)));
+    r.m_ticks++;
+    if((int)r.m_hashes.size() >= REPLAY_BLOCK_TICKS) r.flush_block();
+}
+
+void ReplayRecorder::flush_block(){
+    if(m_hashes.empty()) return;
+    BlockHeader b;
+    b.firstTick = (uint32_t)m_blockFirst; b.ticks = (uint32_t)m_hashes.size();
+    b.runs = m_runCount; b.runBytes = (uint32_t)m_runs.size();
+    if(!m_failed){
+        bool ok = fwrite(&b, sizeof(b), 1, m_file) == 1
+            && (m_runs.empty() || fwrite(&m_runs[0], 1, m_runs.size(), m_file) == m_runs.size())
+            && fwrite(&m_hashes[0], sizeof(uint32_t), m_hashes.size(), m_file) == m_hashes.size()
+            && fflush(m_file) == 0;
+        if(!ok) m_failed = true;
+    }
+    m_blockFirst += (int)m_hashes.size();
+    m_runs.clear(); m_hashes.clear(); m_runCount = 0;
+    m_haveRun = false; // runs never span blocks, so each block decodes on its own
+}
+
+bool replay_load(const char* path, Replay& out){
+    FILE* f = fopen(path, "rb");
+    if(!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    ReplayHeader h;
+    if(data.size() < sizeof(h)) return false;
+    memcpy(&h, &data[0], sizeof(h));
+    if(memcmp(h.magic, REPLAY_MAGIC, 4) != 0 || h.version != REPLAY_VERSION || h.headerBytes != sizeof(h)) return false;
+    out.seed = h.seed; out.rows = h.rows; out.cols = h.cols; out.numeric = (int)h.numeric;
+    out.inputs.clear(); out.hashes.clear();
+
+    // a truncated last block (the recording process died mid-write) is dropped
+    size_t at = sizeof(h);
+    while(at + sizeof(BlockHeader) <= data.size()){
+        BlockHeader b; memcpy(&b, &data[at], sizeof(b));
+        size_t end = at + sizeof(b) + (size_t)b.runBytes + (size_t)b.ticks * sizeof(uint32_t);
+        if(end > data.size() || b.firstTick != (uint32_t)out.hashes.size() + 1) break;
+        const uint8_t* p = &data[at + sizeof(b)];
+        const uint8_t* runEnd = p + b.runBytes;
+        uint32_t tick = b.firstTick, covered = 0;
+        bool ok = true;
+        for(uint32_t i=0;i<b.runs && ok;i++){
+            InputRun run;
+            if(p + sizeof(run) > runEnd){ ok = false; break; }
+            memcpy(&run, p, sizeof(run)); p += sizeof(run);
+            ReplayInput in; in.firstTick = (int)tick; in.thrust = Vec2(run.x, run.y);
+            if(run.ticks & RUN_WIDE){
+                if(p + 2 * sizeof(double) > runEnd){ ok = false; break; }
+                memcpy(&in.thrust.x, p, sizeof(double)); memcpy(&in.thrust.y, p + sizeof(double), sizeof(double));
+                p += 2 * sizeof(double);
+            }
+            uint32_t len = run.ticks & ~RUN_WIDE;
+            out.inputs.push_back(in);
+            tick += len; covered += len;
+        }
+        if(!ok || p != runEnd || covered != b.ticks) return false;
+        size_t first = out.hashes.size();
+        out.hashes.resize(first + b.ticks);
+        memcpy(&out.hashes[first], runEnd, (size_t)b.ticks * sizeof(uint32_t));
+        at = end;
+    }
+    return true;
+}
+
+namespace {
+struct ReplayCursor {
+    const Replay* r;
+    size_t input;              // inputs[input] covers the current tick
+    int mismatchTick;
+    uint32_t expected, actual;
+};
+}
+
+static Vec2 replayInput(int tick, void* user){
+    ReplayCursor &c = *(ReplayCursor*)user;
+    const std::vector<ReplayInput> &in = c.r->inputs;
+    if(in.empty()) return Vec2();
+    while(c.input + 1 < in.size() && in[c.input + 1].firstTick <= tick) c.input++;
+    return in[c.input].thrust;
+}
+
+static void replayCheck(const Session& s, void* user){
+    ReplayCursor &c = *(ReplayCursor*)user;
+    if(c.mismatchTick || s.tickCount < 1 || s.tickCount > c.r->ticks()) return;
+    uint32_t want = c.r->hashes[s.tickCount - 1], got = fold(replay_state_hash(s));
+    if(want != got){ c.mismatchTick = s.tickCount; c.expected = want; c.actual = got; }
+}
+
+bool replay_run(const Replay& r, Session& s, ReplayResult& res, int stopTick){
+    if(r.numeric != SIM_NUMERIC){
+        // the other number type computes other states; not one hash would match
+        res.ticks = 0; res.seconds = 0;
+        res.mismatchTick = 1; res.expected = r.ticks() ? r.hashes[0] : 0; res.actual = 0;
+        return false;
+    }
+    GameInputSource oldSrc = s.inputSource; void* oldUser = s.inputUser;
+    GameTickHook oldHook = s.tickHook; void* oldHookUser = s.tickHookUser;
+    ReplayCursor c = { &r, 0, 0, 0, 0 };
+    s.inputSource = replayInput; s.inputUser = &c;
+    s.tickHook = replayCheck; s.tickHookUser = &c;
+    session_reset(s, r.seed, r.rows, r.cols);
+
+    int end = r.ticks();
+    if(stopTick > 0 && stopTick < end) end = stopTick;
+    typedef std::chrono::steady_clock clk;
+    clk::time_point t0 = clk::now();
+    while(s.tickCount < end && !c.mismatchTick){
+        int before = s.tickCount;
+        session_update(s);
+        // the session ended while the recording went on: it drifted somewhere untracked
+        if(s.tickCount == before){ c.mismatchTick = before + 1; c.expected = r.hashes[before]; c.actual = 0; }
+    }
+    res.seconds = std::chrono::duration<double>(clk::now() - t0).count();
+    res.ticks = s.tickCount;
+    res.mismatchTick = c.mismatchTick; res.expected = c.expected; res.actual = c.actual;
+
+    s.inputSource = oldSrc; s.inputUser = oldUser;
+    s.tickHook = oldHook; s.tickHookUser = oldHookUser;
+    return c.mismatchTick == 0;
+}
@@ -0,0 +1,403 @@
+// src/save_file.cpp
+#include "save_file.hpp"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char SAVE_MAGIC[4] = { 'S', 'E', 'L', 'S' };
+static const uint32_t FLAG_PAUSED = 1, FLAG_GAME_OVER = 2;
+static const int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+struct SaveHeader {
+    char magic[4];
+    uint32_t version, kind, headerBytes;
+    uint64_t id, baseId, payloadBytes;
+    int32_t rows, cols, tick, resources, score;
+    uint32_t seed;
+    uint64_t rngState;
+    uint32_t flags;
+    uint32_t shipBlocks, drones, chunks; // chunks: RLE chunks (full) or touched chunks (delta)
+    double shipX, shipY, shipAngle, shipVelX, shipVelY, shipAngVel;
+    int32_t shipCoreR, shipCoreC;
+    uint32_t debris, ships;              // loose pieces, AI ships
+};
+static_assert(sizeof(SaveHeader) == 152, "save header layout is part of the file format");
+
+// full saves, per chunk: ChunkRec, the block layer as runs of one type (row-major), then the
+// 16-bit hp of each non-empty cell in the same order. hp is effectively random per asteroid
+// cell, so keeping it out of the runs is what lets the type layer compress.
+struct ChunkRec { int32_t cr, cc; uint32_t runs, filled; };
+struct TypeRun { uint16_t len; uint8_t type, pad; };
+// delta saves: DeltaRec + one packed cell (Block::bits) per set bit, in bit order
+struct DeltaRec { int32_t cr, cc; uint32_t count, pad; uint64_t bits[CHUNK_CELLS / 64]; };
+struct CellValue { int32_t hp; uint8_t type, pad[3]; };
+// both kinds, after the drones: resident regions, then the modification log sorted by cell
+struct StreamRec { uint32_t regions, mods; };
+struct ModRec { int32_t r, c; CellValue v; };
+// ship blocks in grid index order, so the reloaded grid indexes them identically
+struct ShipBlockRec { int32_t r, c; CellValue v; };
+// after the drones, per loose piece: DebrisRec, then its blocks as ShipBlockRecs
+struct DebrisRec { double x, y, angle, velX, velY, angVel; int32_t ttl; uint32_t blocks; };
+// after the debris, per AI ship (s.ships beyond the player's, in pool order): ShipRec, then its blocks
+struct ShipRec { double x, y, angle, velX, velY, angVel, targetX, targetY; int32_t coreR, coreC; uint32_t blocks, pad; };
+
+static void put(std::vector<uint8_t>& out, const void* p, size_t n){
+    if(!n) return;
+    size_t at = out.size(); out.resize(at + n); memcpy(&out[at], p, n);
+}
+static void pad8(std::vector<uint8_t>& out){ out.resize((out.size() + 7) & ~(size_t)7, 0); }
+
+// FNV-1a over 64-bit words (payloads are padded to 8 bytes)
+static uint64_t checksum(const uint8_t* p, size_t n){
+    uint64_t h = 0xCBF29CE484222325ull;
+    for(size_t i=0;i+8<=n;i+=8){ uint64_t w; memcpy(&w, p + i, 8); h = (h ^ w) * 0x100000001B3ull; }
+    return h;
+}
+
+static void putBlocks(const ShipGrid& g, std::vector<uint8_t>& out){
+    for(int i=0;i<g.size();i++){
+        ShipBlockRec rec; memset(&rec, 0, sizeof(rec));
+        rec.r = g.row(i); rec.c = g.col(i); rec.v.hp = g.hp(i); rec.v.type = (uint8_t)g.type(i);
+        put(out, &rec, sizeof(rec));
+    }
+}
+
+// header and the small per-session state every save carries
+static void putState(const Session& s, uint32_t kind, uint32_t chunks, std::vector<uint8_t>& out){
+    SaveHeader h; memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SAVE_MAGIC, 4);
+    h.version = SAVE_VERSION; h.kind = kind; h.headerBytes = sizeof(SaveHeader);
+    h.rows = s.world.rows(); h.cols = s.world.cols();
+    h.tick = s.tickCount; h.resources = s.resources; h.score = s.score;
+    h.seed = s.seed; h.rngState = s.rng.s;
+    h.flags = (s.paused ? FLAG_PAUSED : 0) | (s.gameOver ? FLAG_GAME_OVER : 0);
+    const ShipStore &sh = s.ships;
+    const int P = PLAYER_SHIP;
+    h.shipBlocks = (uint32_t)sh.grid[P].size(); h.drones = (uint32_t)s.drones.size(); h.chunks = chunks;
+    h.shipX = sh.x[P]; h.shipY = sh.y[P]; h.shipAngle = sh.angle[P];
+    h.shipVelX = sh.vx[P]; h.shipVelY = sh.vy[P]; h.shipAngVel = sh.angVel[P];
+    h.shipCoreR = sh.coreR[P]; h.shipCoreC = sh.coreC[P];
+    h.debris = (uint32_t)s.debris.size(); h.ships = (uint32_t)(sh.size() - 1);
+    out.clear();
+    put(out, &h, sizeof(h));
+    putBlocks(sh.grid[P], out);
+    pad8(out);
+    size_t n = s.drones.size();
+    const std::vector<double>* cols[] = { &s.drones.x, &s.drones.y, &s.drones.vx, &s.drones.vy, &s.drones.angle, &s.drones.cooldown };
+    for(auto *v : cols) put(out, v->data(), n * sizeof(double));
+    put(out, s.drones.hp.data(), n * sizeof(int));
+    pad8(out);
+    const ShipStore &db = s.debris;
+    for(int i=0;i<db.size();i++){
+        DebrisRec rec = { db.x[i], db.y[i], db.angle[i], db.vx[i], db.vy[i], db.angVel[i], db.ttl[i], (uint32_t)db.grid[i].size() };
+        put(out, &rec, sizeof(rec));
+        putBlocks(db.grid[i], out);
+    }
+    for(int i=P+1;i<sh.size();i++){
+        ShipRec rec = { sh.x[i], sh.y[i], sh.angle[i], sh.vx[i], sh.vy[i], sh.angVel[i], sh.targetX[i], sh.targetY[i],
+            sh.coreR[i], sh.coreC[i], (uint32_t)sh.grid[i].size(), 0 };
+        put(out, &rec, sizeof(rec));
+        putBlocks(sh.grid[i], out);
+    }
+
+    std::vector<RegionPos> regions;
+    std::vector<ModCell> mods;
+    s.stream.resident_regions(regions);
+    s.stream.collect_mods(s.world, mods);
+    StreamRec sr = { (uint32_t)regions.size(), (uint32_t)mods.size() };
+    put(out, &sr, sizeof(sr));
+    for(const RegionPos &p : regions){ int32_t rc[2] = { p.rr, p.rc }; put(out, rc, sizeof(rc)); }
+    pad8(out);
+    for(const ModCell &m : mods){
+        ModRec rec; memset(&rec, 0, sizeof(rec));
+        rec.r = m.r; rec.c = m.c; rec.v.hp = m.b.hp(); rec.v.type = (uint8_t)m.b.type();
+        put(out, &rec, sizeof(rec));
+    }
+}
+
+// a touched chunk outside the resident regions reads as empty here; its real cells are
+// in the modification log
+static bool chunkResident(const Session& s, int cr, int cc){
+    return s.stream.resident(cr >> REGION_CHUNK_SHIFT, cc >> REGION_CHUNK_SHIFT);
+}
+
+static void finish(std::vector<uint8_t>& out, uint64_t baseId){
+    SaveHeader *h = (SaveHeader*)out.data();
+    h->payloadBytes = out.size() - sizeof(SaveHeader);
+    h->baseId = baseId;
+    h->id = checksum(out.data() + sizeof(SaveHeader), (size_t)h->payloadBytes);
+}
+
+void save_encode_full(Session& s, std::vector<uint8_t>& out){
+    putState(s, SAVE_FULL, (uint32_t)s.world.chunk_count(), out);
+    // one chunk is encoded into worst-case scratch (stays in cache), then appended
+    uint64_t scratch[(sizeof(ChunkRec) + CHUNK_CELLS * (sizeof(TypeRun) + sizeof(uint16_t))) / 8 + 1];
+    uint8_t *base = (uint8_t*)scratch;
+    out.reserve(out.size() + (size_t)s.world.chunk_count() * 1024); // typical asteroid chunk is well under 1 KB
+    for(int i=0;i<s.world.chunk_count();i++){
+        const Chunk &ch = s.world.chunk(i);
+        TypeRun *runs = (TypeRun*)(base + sizeof(ChunkRec));
+        uint32_t nRuns = 0;
+        for(int k=0;k<CHUNK_CELLS;){
+            BlockType t = ch.cells[k].type();
+            int e = k + 1;
+            while(e < CHUNK_CELLS && ch.cells[e].type() == t) e++;
+            TypeRun run = { (uint16_t)(e - k), (uint8_t)t, 0 };
+            runs[nRuns++] = run;
+            k = e;
+        }
+        size_t used = sizeof(ChunkRec) + nRuns * sizeof(TypeRun);
+        if(used & 7){ memset(base + used, 0, 4); used += 4; }
+        uint16_t *hp = (uint16_t*)(base + used);
+        uint32_t filled = 0;
+        for(int k=0;k<CHUNK_CELLS;k++) if(!ch.cells[k].empty()) hp[filled++] = (uint16_t)ch.cells[k].hp();
+        used += filled * sizeof(uint16_t);
+        size_t padded = (used + 7) & ~(size_t)7;
+        memset(base + used, 0, padded - used); used = padded;
+        ChunkRec rec = { ch.cr, ch.cc, nRuns, filled };
+        memcpy(base, &rec, sizeof(rec));
+        put(out, base, used);
+    }
+    finish(out, 0);
+    s.checkpointId = ((const SaveHeader*)out.data())->id;
+    s.world.track_touched(true);
+}
+
+bool save_encode_delta(const Session& s, std::vector<uint8_t>& out){
+    if(!s.checkpointId || !s.world.tracking_touched()) return false;
+    const std::vector<TouchedChunk> &touched = s.world.touched();
+    uint32_t chunks = 0;
+    for(const TouchedChunk &t : touched) chunks += chunkResident(s, t.cr, t.cc);
+    putState(s, SAVE_DELTA, chunks, out);
+    for(const TouchedChunk &t : touched){
+        if(!chunkResident(s, t.cr, t.cc)) continue;
+        DeltaRec rec; rec.cr = t.cr; rec.cc = t.cc; rec.pad = 0;
+        rec.count = 0;
+        for(uint64_t w : t.bits) for(; w; w &= w - 1) rec.count++;
+        memcpy(rec.bits, t.bits, sizeof(rec.bits));
+        put(out, &rec, sizeof(rec));
+        for(int k=0;k<CHUNK_CELLS;k++){
+            if(!(t.bits[k >> 6] >> (k & 63) & 1)) continue;
+            const Block &b = s.world.get((t.cr << CHUNK_SHIFT) + (k >> CHUNK_SHIFT), (t.cc << CHUNK_SHIFT) + (k & CHUNK_MASK));
+            put(out, &b.bits, sizeof(b.bits));
+        }
+        pad8(out);
+    }
+    finish(out, s.checkpointId);
+    return true;
+}
+
+// bounds-checked cursor over a mapped save
+struct Reader {
+    const uint8_t *p, *end;
+    template<class T> const T* take(size_t count = 1){
+        size_t n = sizeof(T) * count;
+        if((size_t)(end - p) < n) return nullptr;
+        const T* r = (const T*)p; p += n; return r;
+    }
+    bool align8(){ size_t off = (size_t)(8 - ((uintptr_t)p & 7)) & 7; if((size_t)(end - p) < off) return false; p += off; return true; }
+};
+
+bool save_read_info(const uint8_t* data, size_t size, SaveInfo& out){
+    if(size < sizeof(SaveHeader) || ((uintptr_t)data & 7)) return false;
+    const SaveHeader &h = *(const SaveHeader*)data;
+    if(memcmp(h.magic, SAVE_MAGIC, 4) != 0 || h.headerBytes != sizeof(SaveHeader)) return false;
+    out.version = h.version; out.kind = h.kind; out.id = h.id; out.baseId = h.baseId;
+    out.rows = h.rows; out.cols = h.cols; out.tick = h.tick; out.bytes = size;
+    return true;
+}
+
+static bool validBlocks(const ShipBlockRec* blocks, uint32_t n){
+    for(uint32_t i=0;i<n;i++) if(blocks[i].v.type == BLOCK_EMPTY || !block_valid_type(blocks[i].v.type)) return false;
+    return true;
+}
+
+static void loadBlocks(ShipGrid& g, const ShipBlockRec* blocks, uint32_t n){
+    g.clear();
+    g.reserve((int)n);
+    for(uint32_t i=0;i<n;i++) g.add(blocks[i].r, blocks[i].c, (BlockType)blocks[i].v.type, blocks[i].v.hp);
+}
+
+bool save_decode(Session& s, const uint8_t* data, size_t size){
+    SaveInfo info;
+    if(!save_read_info(data, size, info) || info.version != SAVE_VERSION) return false;
+    const SaveHeader &h = *(const SaveHeader*)data;
+    if(h.payloadBytes != size - sizeof(SaveHeader)) return false;
+    if(checksum(data + sizeof(SaveHeader), (size_t)h.payloadBytes) != h.id) return false;
+    if(h.kind == SAVE_DELTA){
+        // a delta only lists cells written since its base; any other write would be left behind
+        if(h.baseId != s.checkpointId || h.rows != s.world.rows() || h.cols != s.world.cols()) return false;
+        if(!s.world.tracking_touched() || !s.world.touched().empty()) return false;
+    } else if(h.kind != SAVE_FULL || h.rows < 0 || h.cols < 0){
+        return false;
+    }
+
+    Reader rd = { data + sizeof(SaveHeader), data + size };
+    const ShipBlockRec *blocks = rd.take<ShipBlockRec>(h.shipBlocks);
+    if(!blocks || !rd.align8() || !validBlocks(blocks, h.shipBlocks)) return false;
+    size_t n = h.drones;
+    const double *cols[6];
+    for(auto &c : cols) if(!(c = rd.take<double>(n))) return false;
+    const int32_t *hp = rd.take<int32_t>(n);
+    if(!hp || !rd.align8()) return false;
+    std::vector<const DebrisRec*> debris(h.debris);
+    for(uint32_t i=0;i<h.debris;i++){
+        const DebrisRec *rec = rd.take<DebrisRec>();
+        if(!rec || !rd.take<ShipBlockRec>(rec->blocks) || !validBlocks((const ShipBlockRec*)(rec + 1), rec->blocks)) return false;
+        debris[i] = rec;
+    }
+    std::vector<const ShipRec*> ships(h.ships);
+    for(uint32_t i=0;i<h.ships;i++){
+        const ShipRec *rec = rd.take<ShipRec>();
+        if(!rec || !rd.take<ShipBlockRec>(rec->blocks) || !validBlocks((const ShipBlockRec*)(rec + 1), rec->blocks)) return false;
+        ships[i] = rec;
+    }
+    const StreamRec *sr = rd.take<StreamRec>();
+    const int32_t *regionRecs = sr ? rd.take<int32_t>(2 * (size_t)sr->regions) : nullptr;
+    if(!regionRecs || !rd.align8()) return false;
+    const ModRec *modRecs = rd.take<ModRec>(sr->mods);
+    if(!modRecs) return false;
+    std::vector<RegionPos> regions(sr->regions);
+    for(uint32_t i=0;i<sr->regions;i++){ regions[i].rr = regionRecs[2*i]; regions[i].rc = regionRecs[2*i+1]; }
+    std::vector<ModCell> mods(sr->mods);
+    for(uint32_t i=0;i<sr->mods;i++){
+        if(!block_valid_type(modRecs[i].v.type)) return false;
+        mods[i].r = modRecs[i].r; mods[i].c = modRecs[i].c;
+        mods[i].b = Block((BlockType)modRecs[i].v.type, modRecs[i].v.hp);
+    }
+
+    s.tickCount = h.tick; s.resources = h.resources; s.score = h.score;
+    s.seed = h.seed; s.rng.s = h.rngState;
+    s.paused = (h.flags & FLAG_PAUSED) != 0; s.gameOver = (h.flags & FLAG_GAME_OVER) != 0;
+    ShipStore &sh = s.ships;
+    sh.clear();
+    int p = sh.add(h.shipX, h.shipY, h.shipAngle);
+    sh.vx[p] = h.shipVelX; sh.vy[p] = h.shipVelY; sh.angVel[p] = h.shipAngVel;
+    sh.coreR[p] = h.shipCoreR; sh.coreC[p] = h.shipCoreC;
+    loadBlocks(sh.grid[p], blocks, h.shipBlocks);
+    sh.grid[p].update_transforms(sh.x[p], sh.y[p], sh.angle[p], GRID_CELL);
+    for(uint32_t i=0;i<h.ships;i++){
+        const ShipRec &rec = *ships[i];
+        int k = sh.add(rec.x, rec.y, rec.angle);
+        sh.vx[k] = rec.velX; sh.vy[k] = rec.velY; sh.angVel[k] = rec.angVel;
+        sh.targetX[k] = rec.targetX; sh.targetY[k] = rec.targetY;
+        sh.coreR[k] = rec.coreR; sh.coreC[k] = rec.coreC;
+        loadBlocks(sh.grid[k], (const ShipBlockRec*)(&rec + 1), rec.blocks);
+        sh.grid[k].update_transforms(sh.x[k], sh.y[k], sh.angle[k], GRID_CELL);
+    }
+    ShipStore &db = s.debris;
+    db.clear();
+    for(uint32_t i=0;i<h.debris;i++){
+        const DebrisRec &rec = *debris[i];
+        int k = db.add(rec.x, rec.y, rec.angle);
+        db.vx[k] = rec.velX; db.vy[k] = rec.velY; db.angVel[k] = rec.angVel; db.ttl[k] = rec.ttl;
+        loadBlocks(db.grid[k], (const ShipBlockRec*)(&rec + 1), rec.blocks);
+    }
+    DroneStore &d = s.drones;
+    d.x.assign(cols[0], cols[0] + n); d.y.assign(cols[1], cols[1] + n);
+    d.vx.assign(cols[2], cols[2] + n); d.vy.assign(cols[3], cols[3] + n);
+    d.angle.assign(cols[4], cols[4] + n); d.cooldown.assign(cols[5], cols[5] + n);
+    d.hp.assign(hp, hp + n);
+    d.prevX = d.x; d.prevY = d.y;
+
+    bool ok = true;
+    if(h.kind == SAVE_FULL){
+        s.world.reset(h.rows, h.cols);
+        s.stream.restore(s.world, worldgen_default(h.seed, h.rows, h.cols), mods, regions);
+        for(uint32_t i=0;i<h.chunks && ok;i++){
+            const ChunkRec *rec = rd.take<ChunkRec>();
+            const TypeRun *runs = rec ? rd.take<TypeRun>(rec->runs) : nullptr;
+            const uint16_t *hps = runs && rd.align8() ? rd.take<uint16_t>(rec->filled) : nullptr;
+            if(!hps || !rd.align8()){ ok = false; break; }
+            s.world.load_chunk(rec->cr, rec->cc, [&](Block* cells){
+                int k = 0; uint32_t f = 0;
+                for(uint32_t j=0;j<rec->runs;j++){
+                    const TypeRun &run = runs[j];
+                    if(!block_valid_type(run.type) || k + run.len > CHUNK_CELLS || (run.type != BLOCK_EMPTY && f + run.len > rec->filled)) break;
+                    int e = k + run.len;
+                    if(run.type == BLOCK_EMPTY){ for(; k<e; k++) cells[k] = Block(); }
+                    else for(; k<e; k++) cells[k] = Block((BlockType)run.type, hps[f++]);
+                }
+                if(k != CHUNK_CELLS || f != rec->filled){ ok = false; return 0; } // drops the chunk
+                return (int)f;
+            });
+        }
+        s.world.clear_changes();
+        s.world.track_touched(true);
+        s.checkpointId = h.id;
+    } else {
+        // regions evicted since the full save regenerate from the log; cells of regions this
+        // session does not hold are skipped for the same reason
+        s.stream.restore_delta(s.world, mods, regions);
+        for(uint32_t i=0;i<h.chunks && ok;i++){
+            const DeltaRec *rec = rd.take<DeltaRec>();
+            const uint16_t *vals = rec ? rd.take<uint16_t>(rec->count) : nullptr;
+            if(!vals || !rd.align8()){ ok = false; break; }
+            if(!chunkResident(s, rec->cr, rec->cc)) continue;
+            uint32_t v = 0;
+            for(int k=0;k<CHUNK_CELLS && ok;k++){
+                if(!(rec->bits[k >> 6] >> (k & 63) & 1)) continue;
+                Block b; b.bits = v < rec->count ? vals[v] : 0;
+                if(v++ >= rec->count || !block_valid_type(b.type())){ ok = false; break; }
+                // through set(), so these cells stay in the touched set for the next delta
+                s.world.set((rec->cr << CHUNK_SHIFT) + (k >> CHUNK_SHIFT), (rec->cc << CHUNK_SHIFT) + (k & CHUNK_MASK), b);
+            }
+        }
+        s.world.clear_changes();
+    }
+    s.flow.reset(); // derived from the world: the next tick rebuilds it from what was loaded
+    return ok;
+}
+
+bool save_write_full(Session& s, const char* path){
+    std::vector<uint8_t> buf;
+    save_encode_full(s, buf);
+    FILE *f = fopen(path, "wb");
+    if(!f) return false;
+    bool ok = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool save_write_delta(const Session& s, const char* path){
+    std::vector<uint8_t> buf;
+    if(!save_encode_delta(s, buf)) return false;
+    FILE *f = fopen(path, "wb");
+    if(!f) return false;
+    bool ok = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool save_load(Session& s, const char* path){
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0){ CloseHandle(file); return false; }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const uint8_t *data = mapping ? (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    bool ok = data && save_decode(s, data, (size_t)size.QuadPart);
+    if(data) UnmapViewOfFile(data);
+    if(mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    return ok;
+#else
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0){ close(fd); return false; }
+    void *map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) return false;
+    bool ok = save_decode(s, (const uint8_t*)map, (size_t)st.st_size);
+    munmap(map, (size_t)st.st_size);
+    return ok;
+#endif
+}
@@ -0,0 +1,197 @@
+// src/ship_grid.cpp
+#include "ship_grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// masses are multiples of 1/2 (blocks.hpp), so the running sums stay exact however often
+// blocks come and go
+double ship_block_mass(BlockType t){ return block_info(t).mass; }
+
+ShipGrid::ShipGrid(){ m_stamp = 0; clear(); }
+
+void ShipGrid::clear(){
+    m_r.clear(); m_c.clear(); m_type.clear(); m_hp.clear();
+    m_index.clear(); m_thrusters.clear(); m_miners.clear();
+    m_wx.clear(); m_wy.clear(); m_wr.clear(); m_wc.clear();
+    m_mass = 0; m_sumR = 0; m_sumC = 0; m_sumSq = 0; m_thrustSumC = 0;
+    m_extent = 0;
+}
+
+void ShipGrid::reserve(int n){
+    m_r.reserve(n); m_c.reserve(n); m_type.reserve(n); m_hp.reserve(n);
+    m_index.reserve(n);
+    m_wx.reserve(n); m_wy.reserve(n); m_wr.reserve(n); m_wc.reserve(n);
+}
+
+std::vector<int>* ShipGrid::roleList(BlockType t){
+    if(t == BLOCK_THRUSTER) return &m_thrusters;
+    if(t == BLOCK_MINER) return &m_miners;
+    return nullptr;
+}
+
+void ShipGrid::account(int i, double sign){
+    double m = ship_block_mass((BlockType)m_type[i]) * sign;
+    double r = m_r[i], c = m_c[i];
+    m_mass += m; m_sumR += m * r; m_sumC += m * c; m_sumSq += m * (r * r + c * c);
+    if(m_type[i] == BLOCK_THRUSTER) m_thrustSumC += c * sign;
+}
+
+bool ShipGrid::add(int r, int c, BlockType t, int hp){
+    if(t == BLOCK_EMPTY || abs(r) > SHIP_MAX_EXTENT || abs(c) > SHIP_MAX_EXTENT) return false;
+    int i = size();
+    if(!m_index.emplace(key(r, c), i).second) return false;
+    m_r.push_back((int16_t)r); m_c.push_back((int16_t)c); m_type.push_back((uint8_t)t); m_hp.push_back(hp);
+    std::vector<int> *list = roleList(t);
+    if(list) list->push_back(i); // i is the largest index, so the list stays sorted
+    account(i, 1.0);
+    int e = abs(r) > abs(c) ? abs(r) : abs(c);
+    if(m_extent >= 0 && e > m_extent) m_extent = e;
+    // the cache covers the new block only after the next update_transforms()
+    m_wx.push_back(0); m_wy.push_back(0); m_wr.push_back(0); m_wc.push_back(0);
+    return true;
+}
+
+bool ShipGrid::remove(int r, int c){
+    auto it = m_index.find(key(r, c));
+    if(it == m_index.end()) return false;
+    int i = it->second, last = size() - 1;
+    m_index.erase(it);
+    account(i, -1.0);
+    int e = abs(r) > abs(c) ? abs(r) : abs(c);
+    if(e == m_extent) m_extent = -1;
+    std::vector<int> *list = roleList((BlockType)m_type[i]);
+    if(list) list->erase(std::lower_bound(list->begin(), list->end(), i));
+    if(i != last){
+        m_r[i] = m_r[last]; m_c[i] = m_c[last]; m_type[i] = m_type[last]; m_hp[i] = m_hp[last];
+        m_wx[i] = m_wx[last]; m_wy[i] = m_wy[last]; m_wr[i] = m_wr[last]; m_wc[i] = m_wc[last];
+        m_index[key(m_r[i], m_c[i])] = i;
+        // the moved block was the last entry of its list; it goes back in at its new index
+        std::vector<int> *moved = roleList((BlockType)m_type[i]);
+        if(moved){
+            moved->pop_back();
+            moved->insert(std::lower_bound(moved->begin(), moved->end(), i), i);
+        }
+    }
+    m_r.pop_back(); m_c.pop_back(); m_type.pop_back(); m_hp.pop_back();
+    m_wx.pop_back(); m_wy.pop_back(); m_wr.pop_back(); m_wc.pop_back();
+    return true;
+}
+
+int ShipGrid::find(int r, int c) const {
+    if(abs(r) > SHIP_MAX_EXTENT || abs(c) > SHIP_MAX_EXTENT) return -1;
+    auto it = m_index.find(key(r, c));
+    return it == m_index.end() ? -1 : it->second;
+}
+
+double ShipGrid::inertia() const {
+    if(m_mass <= 0) return 0.0;
+    SimReal mass(m_mass), cr = comR(), cc = comC();
+    // parallel axis: about the core, plus each unit square's own m/6, moved to the COM
+    return sim_to_double(SimReal(m_sumSq) + mass / 6 - mass * (cr * cr + cc * cc));
+}
+
+double ShipGrid::thrust_arm() const {
+    // torque of a push toward -r at column c is -(c - com_c) per unit force
+    return sim_to_double(comC() * (int)m_thrusters.size() - SimReal(m_thrustSumC));
+}
+
+int ShipGrid::extent() const {
+    if(m_extent < 0){
+        int e = 0;
+        for(int i=0;i<size();i++){
+            int a = abs(m_r[i]), b = abs(m_c[i]);
+            if(a > e) e = a;
+            if(b > e) e = b;
+        }
+        m_extent = e;
+    }
+    return m_extent;
+}
+
+void ShipGrid::update_transforms(double x, double y, double angle, int cell){
+    SimReal px(x), py(y), s, c;
+    sim_sin_cos(SimReal(angle), s, c);
+    s = s * cell; c = c * cell;
+    int n = size();
+    const int16_t *br = m_r.data(), *bc = m_c.data();
+    double *wx = m_wx.data(), *wy = m_wy.data();
+    for(int i=0;i<n;i++){
+        SimReal lc(bc[i]), lr(br[i]);
+        wx[i] = sim_to_double(px + lc * c - lr * s);
+        wy[i] = sim_to_double(py + lc * s + lr * c);
+    }
+    int *wr = m_wr.data(), *wc = m_wc.data();
+    for(int i=0;i<n;i++){
+        wr[i] = sim_trunc(SimReal(wy[i]) / cell);
+        wc[i] = sim_trunc(SimReal(wx[i]) / cell);
+    }
+}
+
+int ShipGrid::detach_after_remove(int r, int c, std::vector<CellPos>& cells, std::vector<int>& ends){
+    static const int DR[4] = { -1, 1, 0, 0 }, DC[4] = { 0, 0, -1, 1 };
+    int core = find(0, 0);
+    if(core < 0) return 0; // nothing anchors the ship
+    int n = size();
+    if((int)m_seen.size() < n){ m_seen.resize(n, 0); m_owner.resize(n, 0); }
+    if(++m_stamp == 0){ std::fill(m_seen.begin(), m_seen.end(), 0u); m_stamp = 1; }
+
+    // one search per remaining neighbour; searches that meet join one group (union by parent)
+    int parent[4], head[4] = { 0, 0, 0, 0 }, count = 0;
+    bool anchored[4];
+    for(int d=0;d<4;d++){
+        int j = find(r + DR[d], c + DC[d]);
+        if(j < 0) continue;
+        m_queue[count].clear(); m_queue[count].push_back(j);
+        m_seen[j] = m_stamp; m_owner[j] = (uint8_t)count;
+        parent[count] = count; anchored[count] = j == core;
+        count++;
+    }
+    if(count <= 1) return 0; // one neighbour: nothing hung on (r,c) but (r,c) itself
+    auto root = [&](int i){ while(parent[i] != i) i = parent[i]; return i; };
+
+    bool open[4];
+    for(;;){
+        // a group is open while any of its searches has blocks left to expand
+        for(int g=0;g<count;g++) open[g] = false;
+        for(int i=0;i<count;i++) if(head[i] < (int)m_queue[i].size()) open[root(i)] = true;
+        int openGroups = 0;
+        bool coreClosed = false;
+        for(int g=0;g<count;g++){
+            if(root(g) != g) continue;
+            if(open[g]) openGroups++;
+            else if(anchored[g]) coreClosed = true;
+        }
+        // the last open group holds the core unless a finished one already did
+        if(openGroups == 0 || (openGroups == 1 && !coreClosed)) break;
+        for(int i=0;i<count;i++){
+            if(head[i] >= (int)m_queue[i].size()) continue;
+            int b = m_queue[i][head[i]++];
+            for(int d=0;d<4;d++){
+                int j = find(m_r[b] + DR[d], m_c[b] + DC[d]);
+                if(j < 0) continue;
+                if(m_seen[j] == m_stamp){
+                    int a = root(m_owner[j]), o = root(i);
+                    if(a != o){ parent[a] = o; anchored[o] = anchored[o] || anchored[a]; }
+                    continue;
+                }
+                m_seen[j] = m_stamp; m_owner[j] = (uint8_t)i;
+                if(j == core) anchored[root(i)] = true;
+                m_queue[i].push_back(j);
+            }
+        }
+    }
+
+    // every finished group that never reached the core is a fragment
+    int fragments = 0;
+    for(int g=0;g<count;g++){
+        if(root(g) != g || open[g] || anchored[g]) continue;
+        for(int i=0;i<count;i++){
+            if(root(i) != g) continue;
+            for(int b : m_queue[i]) cells.push_back({ m_r[b], m_c[b] });
+        }
+        ends.push_back((int)cells.size());
+        fragments++;
+    }
+    return fragments;
+}
@@ -0,0 +1,46 @@
+// src/ship_store.cpp
+#include "ship_store.hpp"
+#include <utility>
+
+void ShipStore::clear(){
+    x.clear(); y.clear(); angle.clear(); prevX.clear(); prevY.clear(); prevAngle.clear();
+    coreR.clear(); coreC.clear(); vx.clear(); vy.clear(); angVel.clear();
+    grid.clear(); throttle.clear(); targetX.clear(); targetY.clear(); ttl.clear();
+}
+
+void ShipStore::reserve(int n){
+    x.reserve(n); y.reserve(n); angle.reserve(n); prevX.reserve(n); prevY.reserve(n); prevAngle.reserve(n);
+    coreR.reserve(n); coreC.reserve(n); vx.reserve(n); vy.reserve(n); angVel.reserve(n);
+    grid.reserve(n); throttle.reserve(n); targetX.reserve(n); targetY.reserve(n); ttl.reserve(n);
+}
+
+int ShipStore::add(double px, double py, double a){
+    x.push_back(px); y.push_back(py); angle.push_back(a);
+    prevX.push_back(px); prevY.push_back(py); prevAngle.push_back(a);
+    coreR.push_back(0); coreC.push_back(0);
+    vx.push_back(0); vy.push_back(0); angVel.push_back(0);
+    grid.emplace_back();
+    throttle.push_back(0); targetX.push_back(px); targetY.push_back(py);
+    ttl.push_back(-1);
+    return size() - 1;
+}
+
+void ShipStore::remove_swap(int i){
+    int last = size() - 1;
+    if(i != last){
+        x[i] = x[last]; y[i] = y[last]; angle[i] = angle[last];
+        prevX[i] = prevX[last]; prevY[i] = prevY[last]; prevAngle[i] = prevAngle[last];
+        coreR[i] = coreR[last]; coreC[i] = coreC[last];
+        vx[i] = vx[last]; vy[i] = vy[last]; angVel[i] = angVel[last];
+        grid[i] = std::move(grid[last]);
+        throttle[i] = throttle[last]; targetX[i] = targetX[last]; targetY[i] = targetY[last];
+        ttl[i] = ttl[last];
+    }
+    x.pop_back(); y.pop_back(); angle.pop_back(); prevX.pop_back(); prevY.pop_back(); prevAngle.pop_back();
+    coreR.pop_back(); coreC.pop_back(); vx.pop_back(); vy.pop_back(); angVel.pop_back();
+    grid.pop_back(); throttle.pop_back(); targetX.pop_back(); targetY.pop_back(); ttl.pop_back();
+}
+
+void ShipStore::save_prev(){
+    prevX = x; prevY = y; prevAngle = angle;
+}
@@ -0,0 +1,133 @@
+// src/sim_thread.cpp
+#include "sim_thread.hpp"
+#include "frame_scheduler.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <thread>
+
+static SnapshotChannel g_channel;
+static SnapshotView g_view;
+static SimSnapshot g_direct;     // snapshot captured in place when no sim thread runs
+static const SimSnapshot* g_current = &g_direct;
+static std::thread g_thread;
+static std::atomic<bool> g_stop(false);
+static bool g_threaded = false;
+static double g_directInput = 0;  // oldest input noted since the last direct capture
+
+// render thread: latency samples (ring) and the newest input time already measured
+static double g_latencySamples[INPUT_LATENCY_SAMPLES];
+static double g_lastMeasuredInput = 0;
+static InputLatencyStats g_latency = { 0, 0, 0, 0 };
+
+static void publishTick(double time, double dt){
+    game_update();
+    PROFILE_ZONE("snapshot_publish");
+    g_channel.note_changes(game_get_world(), game_dirty_cells());
+    game_clear_dirty_cells();
+    SimSnapshot &b = g_channel.back();
+    snapshot_capture(b, game_session(), game_world_generation());
+    b.time = time; b.dt = dt;
+    g_channel.publish();
+}
+
+static void simTick(void* user){
+    publishTick(sched_default_now(nullptr), ((FrameScheduler*)user)->dt());
+}
+
+static void simMain(double dt){
+    PROFILE_THREAD("sim");
+    FrameScheduler sched(dt, 5);
+    while(!g_stop.load(std::memory_order_relaxed)){
+        if(!sched.frame_due()){ PROFILE_ZONE("sim_wait"); sched.wait_next_frame(); continue; }
+        sched.step(simTick, &sched);
+    }
+}
+
+void sim_thread_start(double dt){
+    if(g_threaded) return;
+    // the sim is not running yet, so the live world can be copied safely
+    g_view.sync(game_get_world(), game_world_generation());
+    game_clear_dirty_cells();
+    snapshot_capture(g_direct, game_session(), game_world_generation());
+    g_current = &g_direct;
+    g_stop.store(false);
+    g_threaded = true;
+    g_thread = std::thread(simMain, dt);
+}
+
+void sim_thread_stop(){
+    if(!g_threaded) return;
+    g_stop.store(true);
+    g_thread.join();
+    // take the last snapshot so the mirror world matches the live one again
+    if(g_channel.acquire()){
+        g_current = &g_channel.front();
+        g_view.apply(*g_current);
+    }
+    g_threaded = false;
+}
+
+bool sim_thread_running(){ return g_threaded; }
+
+void sim_thread_note_input(double time){
+    if(g_threaded) g_channel.note_input(time);
+    else if(g_directInput == 0 || time < g_directInput) g_directInput = time;
+}
+
+bool sim_view_update(){
+    PROFILE_ZONE("sim_view_update");
+    if(g_threaded){
+        if(!g_channel.acquire()) return false;
+        g_current = &g_channel.front();
+    } else {
+        if(g_view.generation() != game_world_generation()) g_view.sync(game_get_world(), game_world_generation());
+        g_direct.cells.clear();
+        for(const CellPos &p : game_dirty_cells()){
+            CellChange c = { p.r, p.c, game_get_world().get(p.r, p.c).type() };
+            g_direct.cells.push_back(c);
+        }
+        game_clear_dirty_cells();
+        snapshot_capture(g_direct, game_session(), game_world_generation());
+        g_direct.seq++;
+        g_direct.time = sched_default_now(nullptr);
+        g_direct.dt = 1.0/60.0;
+        g_direct.inputTime = g_directInput;
+        g_directInput = 0;
+        g_current = &g_direct;
+    }
+    g_view.apply(*g_current);
+    return true;
+}
+
+const SimSnapshot& sim_view(){ return *g_current; }
+const WorldGrid& sim_view_world(){ return g_view.world(); }
+const WorldSummary& sim_view_summary(){ return g_view.summary(); }
+const std::vector<CellPos>& sim_view_dirty_cells(){ return g_view.world().changes(); }
+void sim_view_clear_dirty_cells(){ g_view.clear_dirty(); }
+unsigned sim_view_generation(){ return g_view.generation(); }
+
+double sim_view_alpha(){
+    const SimSnapshot &s = *g_current;
+    if(!g_threaded || s.dt <= 0) return 1.0;
+    double a = (sched_default_now(nullptr) - s.time) / s.dt;
+    return a < 0 ? 0 : (a > 1 ? 1 : a);
+}
+
+void sim_view_note_present(double now){
+    double t = g_current->inputTime;
+    // a snapshot the reader skipped hands its input on to the next, so the same time can
+    // arrive more than once: only the first present of it counts
+    if(t <= g_lastMeasuredInput) return;
+    g_lastMeasuredInput = t;
+    g_latencySamples[g_latency.count % INPUT_LATENCY_SAMPLES] = (now - t) * 1e3;
+    g_latency.count++;
+    int n = (int)std::min<long>(g_latency.count, INPUT_LATENCY_SAMPLES);
+    double sorted[INPUT_LATENCY_SAMPLES];
+    std::copy(g_latencySamples, g_latencySamples + n, sorted);
+    std::sort(sorted, sorted + n);
+    g_latency.p50Ms = sorted[n / 2];
+    g_latency.p99Ms = sorted[std::min(n - 1, n * 99 / 100)];
+    g_latency.maxMs = sorted[n - 1];
+}
+
+const InputLatencyStats& sim_view_input_latency(){ return g_latency; }
@@ -0,0 +1,112 @@
+// src/snapshot.cpp
+#include "snapshot.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const size_t COMPACT_MIN = 4096;
+
+// centers of mass of bodies [first, size) of a pool, now and at the start of the tick
+static void addHulls(SimSnapshot& out, const ShipStore& sh, int first){
+    for(int i=first;i<sh.size();i++){
+        const ShipGrid &g = sh.grid[i];
+        double comX = g.com_c() * GRID_CELL, comY = g.com_r() * GRID_CELL;
+        double sA = sin(sh.angle[i]), cA = cos(sh.angle[i]), sP = sin(sh.prevAngle[i]), cP = cos(sh.prevAngle[i]);
+        out.hullX.push_back(sh.x[i] + comX * cA - comY * sA); out.hullY.push_back(sh.y[i] + comX * sA + comY * cA);
+        out.hullPrevX.push_back(sh.prevX[i] + comX * cP - comY * sP); out.hullPrevY.push_back(sh.prevY[i] + comX * sP + comY * cP);
+        out.hullBlocks.push_back(g.size());
+    }
+}
+
+void snapshot_capture(SimSnapshot& out, const Session& s, unsigned worldGeneration){
+    out.tick = s.tickCount;
+    const ShipStore &sh = s.ships;
+    out.shipX = sh.x[PLAYER_SHIP]; out.shipY = sh.y[PLAYER_SHIP]; out.shipAngle = sh.angle[PLAYER_SHIP];
+    out.shipPrevX = sh.prevX[PLAYER_SHIP]; out.shipPrevY = sh.prevY[PLAYER_SHIP]; out.shipPrevAngle = sh.prevAngle[PLAYER_SHIP];
+    out.droneX = s.drones.x; out.droneY = s.drones.y;
+    out.dronePrevX = s.drones.prevX; out.dronePrevY = s.drones.prevY;
+    out.hullX.clear(); out.hullY.clear(); out.hullPrevX.clear(); out.hullPrevY.clear();
+    out.hullBlocks.clear();
+    addHulls(out, sh, PLAYER_SHIP + 1);
+    addHulls(out, s.debris, 0);
+    out.resources = s.resources; out.score = s.score;
+    out.paused = s.paused; out.gameOver = s.gameOver;
+    out.worldGeneration = worldGeneration;
+}
+
+SnapshotChannel::SnapshotChannel() : m_middle(1){
+    m_back = 0; m_front = 2;
+    m_seq = 0;
+    m_lastLen = 0;
+    m_compactAt = COMPACT_MIN;
+    m_inputPending = 0; m_inputNew = 0;
+}
+
+void SnapshotChannel::note_changes(const WorldGrid& world, const std::vector<CellPos>& cells){
+    for(const CellPos &p : cells){
+        CellChange c = { p.r, p.c, world.get(p.r, p.c).type() };
+        m_pending.push_back(c);
+    }
+}
+
+void SnapshotChannel::note_input(double time){
+    if(m_inputNew == 0 || time < m_inputNew) m_inputNew = time;
+}
+
+// keep only the newest change per cell; bounds the backlog when nobody reads for a while
+static void compactChanges(std::vector<CellChange>& v){
+    std::stable_sort(v.begin(), v.end(), [](const CellChange &a, const CellChange &b){
+        return a.r != b.r ? a.r < b.r : a.c < b.c;
+    });
+    size_t out = 0;
+    for(size_t i=0;i<v.size();i++){
+        if(i + 1 < v.size() && v[i+1].r == v[i].r && v[i+1].c == v[i].c) continue; // a newer one follows
+        v[out++] = v[i];
+    }
+    v.resize(out);
+}
+
+void SnapshotChannel::publish(){
+    if(m_pending.size() >= m_compactAt){
+        compactChanges(m_pending);
+        m_compactAt = std::max(COMPACT_MIN, m_pending.size() * 2);
+        m_lastLen = 0; // entries were reordered; nothing can be trimmed until the next publish
+    }
+    SimSnapshot &b = m_buf[m_back];
+    b.seq = ++m_seq;
+    b.cells.assign(m_pending.begin(), m_pending.end());
+    if(m_inputPending == 0 || (m_inputNew != 0 && m_inputNew < m_inputPending)) m_inputPending = m_inputNew;
+    b.inputTime = m_inputPending;
+
+    unsigned old = m_middle.exchange((unsigned)m_back | FRESH, std::memory_order_acq_rel);
+    m_back = (int)(old & 3);
+    if(!(old & FRESH)){
+        // the reader took the previous snapshot, so the changes it carried have arrived
+        m_pending.erase(m_pending.begin(), m_pending.begin() + m_lastLen);
+        m_inputPending = m_inputNew; // only this snapshot carries input noted since then
+    }
+    // else: the previous snapshot is back with the writer unread; its changes stay pending
+    // (this snapshot carries them too)
+    m_lastLen = m_pending.size();
+    m_inputNew = 0;
+}
+
+bool SnapshotChannel::acquire(){
+    if(!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+    unsigned old = m_middle.exchange((unsigned)m_front, std::memory_order_acq_rel);
+    m_front = (int)(old & 3);
+    return true;
+}
+
+void SnapshotView::sync(const WorldGrid& live, unsigned generation){
+    m_world.copy_from(live);
+    m_summary.build(m_world);
+    m_generation = generation;
+}
+
+void SnapshotView::apply(const SimSnapshot& s){
+    for(const CellChange &c : s.cells){
+        BlockType was = m_world.get(c.r, c.c).type();
+        m_world.set(c.r, c.c, Block(c.type, 1)); // the mirror only tracks types
+        m_summary.change(c.r, c.c, was, c.type);
+    }
+}
@@ -0,0 +1,122 @@
+// src/state_server.cpp
+#include "state_server.hpp"
+#include <cstring>
+
+StateServer::StateServer(){
+    m_s = nullptr;
+    m_listener = NET_INVALID;
+    m_received = 0; m_applied = 0;
+    m_lastTick = 0;
+    m_closedOut = 0; m_closedIn = 0;
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+StateServer::~StateServer(){ stop(); }
+
+bool StateServer::start(Session& s, const char* addr){
+    stop();
+    m_listener = net_listen(addr);
+    if(m_listener == NET_INVALID) return false;
+    m_addr = addr;
+    m_s = &s;
+    s.inputSource = input; s.inputUser = this;
+    m_thrust = Vec2(); m_received = 0; m_applied = 0;
+    m_encoder.sync(s);
+    m_lastTick = s.tickCount;
+    return true;
+}
+
+void StateServer::stop(){
+    if(!running()) return;
+    for(auto &v : m_viewers) v->flush();
+    count();
+    m_closedOut = m_stats.bytesOut; m_closedIn = m_stats.bytesIn;
+    m_viewers.clear();
+    net_unlisten(m_listener, m_addr.c_str());
+    m_listener = NET_INVALID;
+    if(m_s && m_s->inputUser == this){ m_s->inputSource = nullptr; m_s->inputUser = nullptr; }
+    m_s = nullptr;
+    m_stats.viewers = 0;
+}
+
+// sampled once at the start of every tick: the pilot's newest input holds until the next one
+Vec2 StateServer::input(int, void* user){
+    StateServer *sv = (StateServer*)user;
+    sv->m_applied = sv->m_received;
+    return sv->m_thrust;
+}
+
+void StateServer::drop(size_t i){
+    m_closedOut += m_viewers[i]->bytes_sent(); m_closedIn += m_viewers[i]->bytes_received();
+    m_viewers.erase(m_viewers.begin() + i);
+    m_stats.dropped++;
+    if(i == 0){ // the next oldest pilots from a standstill
+        m_thrust = Vec2(); m_received = 0; m_applied = 0;
+    }
+}
+
+void StateServer::poll(){
+    if(!running()) return;
+    for(NetSocket s; (s = net_accept(m_listener)) != NET_INVALID;){
+        m_viewers.emplace_back(new NetLink(s));
+        m_encoder.keyframe(*m_s, m_applied, m_msg);
+        m_viewers.back()->send(m_msg);
+        m_stats.joined++; m_stats.keyframes++;
+        m_stats.lastKeyframeBytes = m_msg.size();
+    }
+    for(size_t i=0;i<m_viewers.size();){
+        NetLink &v = *m_viewers[i];
+        uint32_t seq;
+        Vec2 thrust;
+        bool bad = false;
+        while(v.receive(m_msg)){
+            if(!stream_decode_input(m_msg.data(), m_msg.size(), seq, thrust)){ bad = true; break; }
+            if(i == 0 && seq > m_received){ m_thrust = thrust; m_received = seq; m_stats.inputs++; }
+        }
+        if(bad || !v.flush()) drop(i);
+        else i++;
+    }
+    count();
+}
+
+void StateServer::count(){
+    m_stats.viewers = (int)m_viewers.size();
+    m_stats.bytesOut = m_closedOut; m_stats.bytesIn = m_closedIn;
+    for(auto &v : m_viewers){ m_stats.bytesOut += v->bytes_sent(); m_stats.bytesIn += v->bytes_received(); }
+}
+
+void StateServer::sendAll(const std::vector<uint8_t>& msg){
+    for(size_t i=0;i<m_viewers.size();){
+        if(m_viewers[i]->send(msg)) i++;
+        else drop(i);
+    }
+    count();
+}
+
+void StateServer::publish(const std::vector<CellPos>& cells){
+    if(!running() || m_s->tickCount == m_lastTick) return;
+    m_lastTick = m_s->tickCount;
+    if(m_viewers.empty()){ m_encoder.sync(*m_s); return; } // nobody to hold a delta base
+    m_encoder.frame(*m_s, cells, m_applied, m_msg);
+    m_stats.frames++;
+    m_stats.lastFrameBytes = m_msg.size();
+    m_stats.frameBytes += m_msg.size();
+    sendAll(m_msg);
+}
+
+void StateServer::resync(){
+    if(!running()) return;
+    m_encoder.sync(*m_s);
+    m_lastTick = m_s->tickCount;
+    m_encoder.keyframe(*m_s, m_applied, m_msg);
+    m_stats.keyframes++;
+    m_stats.lastKeyframeBytes = m_msg.size();
+    sendAll(m_msg);
+}
+
+void StateServer::wait(int ms){
+    if(!running()) return;
+    std::vector<NetSocket> socks(1, m_listener);
+    for(auto &v : m_viewers) socks.push_back(v->socket());
+    net_wait(socks.data(), (int)socks.size(), ms);
+}
@@ -0,0 +1,494 @@
+// src/state_stream.cpp
+#include "state_stream.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const double TWO_PI = 6.283185307179586;
+static const uint8_t FLAG_PAUSED = 1, FLAG_GAME_OVER = 2, FLAG_RESIDENT = 4;
+// drone ops on the wire: a push, a clear, or remove_swap(k) as k + OP_REMOVE
+static const uint64_t OP_PUSH = 0, OP_CLEAR = 1, OP_REMOVE = 2;
+static const int TYPE_MASK = (1 << BLOCK_TYPE_BITS) - 1;
+
+static uint64_t zig(int64_t v){ return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static void putVar(std::vector<uint8_t>& out, uint64_t v){
+    while(v >= 0x80){ out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    out.push_back((uint8_t)v);
+}
+static void putSigned(std::vector<uint8_t>& out, int64_t v){ putVar(out, zig(v)); }
+
+// Bounds-checked reads; any read past the end or bad value clears ok and reads as 0
+struct StreamReader {
+    const uint8_t *p, *end;
+    bool ok;
+    StreamReader(const uint8_t* data, size_t n) : p(data), end(data + n), ok(true) {}
+    bool done() const { return ok && p == end; }
+    uint8_t byte(){
+        if(p == end){ ok = false; return 0; }
+        return *p++;
+    }
+    uint64_t var(){
+        uint64_t v = 0;
+        for(int shift=0; shift<64; shift+=7){
+            if(p == end) break;
+            uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7f) << shift;
+            if(!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    int64_t sig(){ uint64_t v = var(); return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+    // a value that must lie in [lo,hi]
+    int64_t range(int64_t v, int64_t lo, int64_t hi){
+        if(v < lo || v > hi){ ok = false; return lo; }
+        return v;
+    }
+    // a count of items of at least one byte each: more than there are bytes left is malformed
+    size_t count(){
+        uint64_t v = var();
+        return (size_t)range((int64_t)std::min(v, (uint64_t)INT64_MAX), 0, end - p);
+    }
+};
+
+static int64_t quantPos(double v){ return (int64_t)llround(v * STREAM_POS_SCALE); }
+static int quantAngle(double a){ return (int)(llround(a * (STREAM_ANGLE_STEPS / TWO_PI)) & (STREAM_ANGLE_STEPS - 1)); }
+// an angle difference in steps, into [-half turn, half turn)
+static int wrapAngle(int d){ return ((d + STREAM_ANGLE_STEPS / 2) & (STREAM_ANGLE_STEPS - 1)) - STREAM_ANGLE_STEPS / 2; }
+
+static uint64_t shapeHash(const ShipGrid& g){
+    uint64_t h = 0xCBF29CE484222325ull;
+    for(int i=0;i<g.size();i++){
+        uint64_t w = ((uint64_t)(uint32_t)g.row(i) << 32) ^ ((uint64_t)(uint32_t)g.col(i) << 4) ^ (uint64_t)g.type(i);
+        h = (h ^ w) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+static void putHeader(std::vector<uint8_t>& out, const Session& s, uint32_t inputAck, uint8_t flags){
+    putVar(out, (uint64_t)s.tickCount);
+    putSigned(out, s.resources); putSigned(out, s.score);
+    out.push_back(flags | (s.paused ? FLAG_PAUSED : 0) | (s.gameOver ? FLAG_GAME_OVER : 0));
+    putVar(out, inputAck);
+}
+
+static void putRegions(std::vector<uint8_t>& out, const std::vector<RegionPos>& regions){
+    putVar(out, regions.size());
+    int pr = 0, pc = 0;
+    for(const RegionPos &rp : regions){
+        putSigned(out, rp.rr - pr); putSigned(out, rp.rc - pc);
+        pr = rp.rr; pc = rp.rc;
+    }
+}
+
+static bool sameRegions(const std::vector<RegionPos>& a, const std::vector<RegionPos>& b){
+    if(a.size() != b.size()) return false;
+    for(size_t i=0;i<a.size();i++) if(a[i].rr != b[i].rr || a[i].rc != b[i].rc) return false;
+    return true;
+}
+
+static void putBlocks(std::vector<uint8_t>& out, const ShipGrid& g){
+    putVar(out, (uint64_t)g.size());
+    for(int i=0;i<g.size();i++){
+        putSigned(out, g.row(i));
+        putVar(out, zig(g.col(i)) << BLOCK_TYPE_BITS | (uint64_t)g.type(i));
+    }
+}
+
+static StreamBody heldBody(const ShipStore& sh, int i){
+    StreamBody b;
+    b.x = quantPos(sh.x[i]); b.y = quantPos(sh.y[i]); b.angle = quantAngle(sh.angle[i]);
+    b.dx = 0; b.dy = 0; b.dAngle = 0;
+    b.shape = shapeHash(sh.grid[i]);
+    return b;
+}
+
+static StreamDrone heldDrone(const DroneStore& d, int i){
+    StreamDrone h = { quantPos(d.x[i]), quantPos(d.y[i]), 0, 0 };
+    return h;
+}
+
+// pose residuals: what the value is minus what the last step predicted; a slot that was not
+// there before the message starts from 0 and takes no step
+static int64_t stepPos(int64_t& held, int64_t& step, int64_t q){
+    int64_t r = q - (held + step);
+    step = q - held; held = q;
+    return r;
+}
+static int64_t unstepPos(int64_t& held, int64_t& step, int64_t r){
+    int64_t q = held + step + r;
+    step = q - held; held = q;
+    return q;
+}
+
+// frames: how many bodies, the blocks of those whose blocks the viewer does not have, then
+// every pose
+static void putBodies(std::vector<uint8_t>& out, const ShipStore& sh, std::vector<StreamBody>& held, std::vector<int>& reshaped){
+    int n = sh.size();
+    size_t old = held.size();
+    held.resize(n);
+    reshaped.clear();
+    for(int i=0;i<n;i++){
+        if((size_t)i >= old){ held[i] = StreamBody(); held[i].shape = 0; }
+        uint64_t h = shapeHash(sh.grid[i]);
+        if((size_t)i >= old || h != held[i].shape){ held[i].shape = h; reshaped.push_back(i); }
+    }
+    putVar(out, (uint64_t)n);
+    putVar(out, reshaped.size());
+    for(int i : reshaped){ putVar(out, (uint64_t)i); putBlocks(out, sh.grid[i]); }
+    for(int i=0;i<n;i++){
+        StreamBody &b = held[i];
+        putSigned(out, stepPos(b.x, b.dx, quantPos(sh.x[i])));
+        putSigned(out, stepPos(b.y, b.dy, quantPos(sh.y[i])));
+        int qa = quantAngle(sh.angle[i]);
+        putSigned(out, wrapAngle(qa - (b.angle + b.dAngle)));
+        b.dAngle = wrapAngle(qa - b.angle); b.angle = qa;
+        if((size_t)i >= old){ b.dx = 0; b.dy = 0; b.dAngle = 0; }
+    }
+}
+
+// one drone op on the held list; fresh marks slots the current message pushed
+static void droneOp(std::vector<StreamDrone>& held, std::vector<char>& fresh, uint64_t op){
+    if(op == OP_PUSH){
+        StreamDrone d = { 0, 0, 0, 0 };
+        held.push_back(d); fresh.push_back(1);
+    }else if(op == OP_CLEAR){
+        held.clear(); fresh.clear();
+    }else{
+        size_t i = (size_t)(op - OP_REMOVE);
+        held[i] = held.back(); held.pop_back();
+        fresh[i] = fresh.back(); fresh.pop_back();
+    }
+}
+
+StateEncoder::StateEncoder(){}
+
+void StateEncoder::sync(Session& s){
+    m_ships.clear(); m_debris.clear(); m_drones.clear();
+    for(int i=0;i<s.ships.size();i++) m_ships.push_back(heldBody(s.ships, i));
+    for(int i=0;i<s.debris.size();i++) m_debris.push_back(heldBody(s.debris, i));
+    for(int i=0;i<s.drones.size();i++) m_drones.push_back(heldDrone(s.drones, i));
+    s.stream.resident_regions(m_resident);
+    s.drones.journal_ops(true);
+}
+
+static void putHeldBodies(std::vector<uint8_t>& out, const ShipStore& sh, const std::vector<StreamBody>& held){
+    putVar(out, held.size());
+    for(size_t i=0;i<held.size();i++){
+        const StreamBody &b = held[i];
+        putSigned(out, b.x); putSigned(out, b.y); putVar(out, (uint64_t)b.angle);
+        putSigned(out, b.dx); putSigned(out, b.dy); putSigned(out, b.dAngle);
+        putBlocks(out, sh.grid[i]);
+    }
+}
+
+// the keyframe is the held state itself, steps included, so the viewer predicts the next frame
+// exactly as this side does
+void StateEncoder::keyframe(const Session& s, uint32_t inputAck, std::vector<uint8_t>& out) const {
+    out.clear();
+    out.push_back(STREAM_KEYFRAME);
+    putVar(out, STREAM_VERSION);
+    const WorldGenParams &p = s.stream.params();
+    putVar(out, p.seed);
+    putVar(out, (uint64_t)p.rows); putVar(out, (uint64_t)p.cols);
+    putSigned(out, p.startR); putSigned(out, p.startC); putSigned(out, p.clearRadius);
+    putHeader(out, s, inputAck, FLAG_RESIDENT);
+    putRegions(out, m_resident);
+    std::vector<ModCell> mods;
+    s.stream.collect_mods(s.world, mods);
+    putVar(out, mods.size());
+    int pr = 0, pc = 0;
+    for(const ModCell &m : mods){
+        putSigned(out, m.r - pr); putSigned(out, m.c - pc); putVar(out, m.b.bits);
+        pr = m.r; pc = m.c;
+    }
+    putHeldBodies(out, s.ships, m_ships);
+    putHeldBodies(out, s.debris, m_debris);
+    putVar(out, m_drones.size());
+    for(const StreamDrone &d : m_drones){ putSigned(out, d.x); putSigned(out, d.y); putSigned(out, d.dx); putSigned(out, d.dy); }
+}
+
+void StateEncoder::frame(Session& s, const std::vector<CellPos>& cells, uint32_t inputAck, std::vector<uint8_t>& out){
+    out.clear();
+    out.push_back(STREAM_FRAME);
+    s.stream.resident_regions(m_residentNow);
+    bool regions = !sameRegions(m_residentNow, m_resident);
+    putHeader(out, s, inputAck, regions ? FLAG_RESIDENT : 0);
+    if(regions){
+        m_resident.swap(m_residentNow);
+        putRegions(out, m_resident);
+    }
+
+    putVar(out, cells.size());
+    int pr = 0, pc = 0;
+    for(const CellPos &p : cells){
+        putSigned(out, p.r - pr);
+        putVar(out, zig(p.c - pc) << BLOCK_TYPE_BITS | (uint64_t)s.world.get(p.r, p.c).type());
+        pr = p.r; pc = p.c;
+    }
+
+    putBodies(out, s.ships, m_ships, m_reshaped);
+    putBodies(out, s.debris, m_debris, m_reshaped);
+
+    // the journal replayed on what viewers hold must land on the session's drones; if it does
+    // not (no journal, or it was restarted) they start over from a clear
+    DroneStore &d = s.drones;
+    bool replay = d.journaling;
+    size_t size = m_drones.size();
+    for(size_t k=0; replay && k<d.ops.size(); k++){
+        if(d.ops[k] < 0) size++;
+        else if((size_t)d.ops[k] < size) size--;
+        else replay = false;
+    }
+    if(size != (size_t)d.size()) replay = false;
+    m_fresh.assign(m_drones.size(), 0);
+    if(replay){
+        putVar(out, d.ops.size());
+        for(int op : d.ops){
+            uint64_t w = op < 0 ? OP_PUSH : OP_REMOVE + (uint64_t)op;
+            putVar(out, w);
+            droneOp(m_drones, m_fresh, w);
+        }
+    }else{
+        putVar(out, (uint64_t)d.size() + 1);
+        putVar(out, OP_CLEAR);
+        droneOp(m_drones, m_fresh, OP_CLEAR);
+        for(int i=0;i<d.size();i++){ putVar(out, OP_PUSH); droneOp(m_drones, m_fresh, OP_PUSH); }
+    }
+    d.clear_ops();
+    putVar(out, m_drones.size());
+    for(int i=0;i<d.size();i++){
+        StreamDrone &h = m_drones[i];
+        putSigned(out, stepPos(h.x, h.dx, quantPos(d.x[i])));
+        putSigned(out, stepPos(h.y, h.dy, quantPos(d.y[i])));
+        if(m_fresh[i]){ h.dx = 0; h.dy = 0; }
+    }
+}
+
+void stream_encode_input(uint32_t seq, Vec2 thrust, std::vector<uint8_t>& out){
+    out.clear();
+    out.push_back(STREAM_INPUT);
+    putVar(out, seq);
+    putSigned(out, llround(thrust.x * STREAM_INPUT_SCALE));
+    putSigned(out, llround(thrust.y * STREAM_INPUT_SCALE));
+}
+
+// each axis is clamped to [-1,1], the keyboard's range
+bool stream_decode_input(const uint8_t* msg, size_t n, uint32_t& seq, Vec2& thrust){
+    StreamReader in(msg, n);
+    if(in.byte() != STREAM_INPUT) return false;
+    uint64_t q = in.var();
+    int64_t x = in.sig(), y = in.sig();
+    if(!in.done() || q > UINT32_MAX) return false;
+    seq = (uint32_t)q;
+    x = std::max<int64_t>(-STREAM_INPUT_SCALE, std::min<int64_t>(STREAM_INPUT_SCALE, x));
+    y = std::max<int64_t>(-STREAM_INPUT_SCALE, std::min<int64_t>(STREAM_INPUT_SCALE, y));
+    thrust = Vec2((double)x / STREAM_INPUT_SCALE, (double)y / STREAM_INPUT_SCALE);
+    return true;
+}
+
+StateMirror::StateMirror(){
+    m_generation = 0;
+    m_synced = false;
+    m_tick = 0; m_resources = 0; m_score = 0;
+    m_paused = false; m_gameOver = false;
+    m_inputAck = 0;
+    m_deaths = 0;
+    m_stream.report_streamed(true);
+}
+
+bool StateMirror::apply(const uint8_t* msg, size_t n){
+    StreamReader in(msg, n);
+    uint8_t kind = in.byte();
+    if(kind == STREAM_KEYFRAME) m_synced = applyKeyframe(in) && in.done();
+    else if(kind == STREAM_FRAME && m_synced) m_synced = applyFrame(in) && in.done();
+    else return false;
+    return m_synced;
+}
+
+static void setPose(MirrorBody& m, const StreamBody& b){
+    m.x = (double)b.x / STREAM_POS_SCALE; m.y = (double)b.y / STREAM_POS_SCALE;
+    m.angle = b.angle * (TWO_PI / STREAM_ANGLE_STEPS);
+}
+
+bool StateMirror::readHeader(StreamReader& in, uint8_t& flags){
+    m_tick = (int)in.range((int64_t)std::min(in.var(), (uint64_t)INT32_MAX), 0, INT32_MAX);
+    m_resources = (int)in.range(in.sig(), INT32_MIN, INT32_MAX);
+    m_score = (int)in.range(in.sig(), INT32_MIN, INT32_MAX);
+    flags = in.byte();
+    m_paused = (flags & FLAG_PAUSED) != 0; m_gameOver = (flags & FLAG_GAME_OVER) != 0;
+    m_inputAck = (uint32_t)in.range((int64_t)std::min(in.var(), (uint64_t)UINT32_MAX), 0, UINT32_MAX);
+    return in.ok;
+}
+
+bool StateMirror::readRegions(StreamReader& in){
+    size_t n = in.count();
+    int rrMax = (m_world.rows() - 1) >> REGION_SHIFT, rcMax = (m_world.cols() - 1) >> REGION_SHIFT;
+    m_resident.clear();
+    int64_t rr = 0, rc = 0;
+    for(size_t i=0; i<n && in.ok; i++){
+        rr = in.range(rr + in.sig(), 0, rrMax); rc = in.range(rc + in.sig(), 0, rcMax);
+        RegionPos rp = { (int)rr, (int)rc };
+        m_resident.push_back(rp);
+    }
+    return in.ok;
+}
+
+bool StateMirror::readBlocks(StreamReader& in, ShipGrid& g){
+    g.clear();
+    size_t n = in.count();
+    for(size_t i=0; i<n && in.ok; i++){
+        int r = (int)in.range(in.sig(), -SHIP_MAX_EXTENT, SHIP_MAX_EXTENT);
+        uint64_t w = in.var();
+        int64_t zc = (int64_t)(w >> BLOCK_TYPE_BITS);
+        int c = (int)in.range((zc >> 1) ^ -(zc & 1), -SHIP_MAX_EXTENT, SHIP_MAX_EXTENT);
+        if(in.ok && (!block_valid_type(w & TYPE_MASK) || !g.add(r, c, (BlockType)(w & TYPE_MASK)))) in.ok = false;
+    }
+    return in.ok;
+}
+
+// a StreamBody's pose and step as a keyframe carries them
+bool StateMirror::readHeldBodies(StreamReader& in, std::vector<StreamBody>& held, std::vector<MirrorBody>& out){
+    size_t n = in.count();
+    held.resize(n); out.resize(n);
+    for(size_t i=0; i<n && in.ok; i++){
+        StreamBody &b = held[i];
+        b.x = in.sig(); b.y = in.sig();
+        b.angle = (int)in.range((int64_t)std::min(in.var(), (uint64_t)STREAM_ANGLE_STEPS), 0, STREAM_ANGLE_STEPS - 1);
+        b.dx = in.sig(); b.dy = in.sig();
+        b.dAngle = (int)in.range(in.sig(), -STREAM_ANGLE_STEPS / 2, STREAM_ANGLE_STEPS / 2 - 1);
+        b.shape = 0;
+        readBlocks(in, out[i].blocks);
+        setPose(out[i], b);
+    }
+    return in.ok;
+}
+
+bool StateMirror::applyBodies(StreamReader& in, std::vector<StreamBody>& held, std::vector<MirrorBody>& out){
+    size_t n = in.count();
+    size_t old = held.size();
+    held.resize(n); out.resize(n);
+    for(size_t i=old;i<n;i++){ held[i] = StreamBody(); held[i].shape = 0; }
+    size_t reshaped = in.count();
+    for(size_t k=0; k<reshaped && in.ok; k++){
+        size_t i = (size_t)in.range((int64_t)std::min(in.var(), (uint64_t)INT32_MAX), 0, (int64_t)n - 1);
+        if(in.ok) readBlocks(in, out[i].blocks);
+    }
+    for(size_t i=0; i<n && in.ok; i++){
+        StreamBody &b = held[i];
+        unstepPos(b.x, b.dx, in.sig());
+        unstepPos(b.y, b.dy, in.sig());
+        int qa = (b.angle + b.dAngle + (int)in.range(in.sig(), -STREAM_ANGLE_STEPS / 2, STREAM_ANGLE_STEPS / 2 - 1)) & (STREAM_ANGLE_STEPS - 1);
+        b.dAngle = wrapAngle(qa - b.angle); b.angle = qa;
+        if(i >= old){ b.dx = 0; b.dy = 0; b.dAngle = 0; }
+        setPose(out[i], b);
+    }
+    return in.ok;
+}
+
+bool StateMirror::applyDrones(StreamReader& in){
+    std::vector<StreamDrone> &held = m_heldDrones;
+    m_fresh.assign(held.size(), 0);
+    m_deaths = 0;
+    size_t ops = in.count();
+    for(size_t k=0; k<ops && in.ok; k++){
+        uint64_t op = in.var();
+        if(op == OP_CLEAR){
+            for(char f : m_fresh) if(!f) m_deaths++;
+        }else if(op != OP_PUSH){
+            if(op - OP_REMOVE >= held.size()){ in.ok = false; break; }
+            if(!m_fresh[(size_t)(op - OP_REMOVE)]) m_deaths++;
+        }
+        droneOp(held, m_fresh, op);
+    }
+    if(!in.ok || in.var() != held.size()) return in.ok = false;
+    m_droneX.resize(held.size()); m_droneY.resize(held.size());
+    m_spawns.clear();
+    for(size_t i=0; i<held.size() && in.ok; i++){
+        StreamDrone &h = held[i];
+        unstepPos(h.x, h.dx, in.sig());
+        unstepPos(h.y, h.dy, in.sig());
+        if(m_fresh[i]){ h.dx = 0; h.dy = 0; m_spawns.push_back((int)i); }
+        m_droneX[i] = (double)h.x / STREAM_POS_SCALE; m_droneY[i] = (double)h.y / STREAM_POS_SCALE;
+    }
+    return in.ok;
+}
+
+void StateMirror::takeStreamed(){
+    const std::vector<CellPos> &st = m_stream.streamed();
+    m_dirty.insert(m_dirty.end(), st.begin(), st.end());
+    m_stream.clear_streamed();
+}
+
+bool StateMirror::applyKeyframe(StreamReader& in){
+    if(in.var() != STREAM_VERSION) return false;
+    WorldGenParams p;
+    p.seed = (uint32_t)in.range((int64_t)std::min(in.var(), (uint64_t)UINT32_MAX), 0, UINT32_MAX);
+    p.rows = (int)in.range((int64_t)std::min(in.var(), (uint64_t)INT32_MAX), 1, INT32_MAX);
+    p.cols = (int)in.range((int64_t)std::min(in.var(), (uint64_t)INT32_MAX), 1, INT32_MAX);
+    p.startR = (int)in.range(in.sig(), INT32_MIN, INT32_MAX);
+    p.startC = (int)in.range(in.sig(), INT32_MIN, INT32_MAX);
+    p.clearRadius = (int)in.range(in.sig(), INT32_MIN, INT32_MAX);
+    if(!in.ok) return false;
+    m_world.reset(p.rows, p.cols);
+    m_stream.reset(m_world, p);
+    m_generation++;
+    m_dirty.clear();
+
+    uint8_t flags;
+    if(!readHeader(in, flags) || !(flags & FLAG_RESIDENT) || !readRegions(in)) return false;
+    size_t n = in.count();
+    m_mods.clear();
+    int64_t r = 0, c = 0;
+    for(size_t i=0; i<n && in.ok; i++){
+        r += in.sig(); c += in.sig();
+        uint64_t bits = in.var();
+        if(!m_world.in_grid((int)in.range(r, 0, p.rows - 1), (int)in.range(c, 0, p.cols - 1)) || bits > 0xffff || !block_valid_type(bits & TYPE_MASK)){ in.ok = false; break; }
+        ModCell m; m.r = (int)r; m.c = (int)c; m.b.bits = (uint16_t)bits;
+        m_mods.push_back(m);
+    }
+    if(!in.ok) return false;
+    m_stream.restore_delta(m_world, m_mods, m_resident);
+    m_stream.clear_streamed(); // the new generation redraws everything anyway
+
+    if(!readHeldBodies(in, m_heldShips, m_ships) || !readHeldBodies(in, m_heldDebris, m_debris)) return false;
+    n = in.count();
+    m_heldDrones.resize(n);
+    m_droneX.resize(n); m_droneY.resize(n);
+    for(size_t i=0; i<n && in.ok; i++){
+        StreamDrone &h = m_heldDrones[i];
+        h.x = in.sig(); h.y = in.sig(); h.dx = in.sig(); h.dy = in.sig();
+        m_droneX[i] = (double)h.x / STREAM_POS_SCALE; m_droneY[i] = (double)h.y / STREAM_POS_SCALE;
+    }
+    m_spawns.clear(); m_deaths = 0;
+    return in.ok;
+}
+
+bool StateMirror::applyFrame(StreamReader& in){
+    uint8_t flags;
+    if(!readHeader(in, flags)) return false;
+    if(flags & FLAG_RESIDENT){
+        if(!readRegions(in)) return false;
+        m_stream.collect_mods(m_world, m_mods);
+        m_stream.restore_delta(m_world, m_mods, m_resident);
+        takeStreamed();
+    }
+
+    size_t n = in.count();
+    int64_t r = 0, c = 0;
+    for(size_t i=0; i<n && in.ok; i++){
+        r += in.sig();
+        uint64_t w = in.var();
+        int64_t zc = (int64_t)(w >> BLOCK_TYPE_BITS);
+        c += (zc >> 1) ^ -(zc & 1);
+        if(r < 0 || r >= m_world.rows() || c < 0 || c >= m_world.cols() || !block_valid_type(w & TYPE_MASK)){ in.ok = false; break; }
+        BlockType t = (BlockType)(w & TYPE_MASK);
+        if(m_world.get((int)r, (int)c).type() != t) m_world.set((int)r, (int)c, Block::of(t));
+    }
+    const std::vector<CellPos> &ch = m_world.changes();
+    m_dirty.insert(m_dirty.end(), ch.begin(), ch.end());
+    m_world.clear_changes();
+    m_stream.record_writes(m_world);
+    if(!in.ok) return false;
+
+    return applyBodies(in, m_heldShips, m_ships) && applyBodies(in, m_heldDebris, m_debris) && applyDrones(in);
+}
@@ -0,0 +1,88 @@
+// src/thread_pool.cpp
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(int threads){
+    if(threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    m_size = threads > 0 ? threads : 1;
+    m_ranges.reset(new Range[m_size]);
+    for(int i=1;i<m_size;i++) m_threads.emplace_back(&ThreadPool::worker_main, this, i);
+}
+
+ThreadPool::~ThreadPool(){
+    { std::lock_guard<std::mutex> lk(m_mutex); m_stop = true; }
+    m_wake.notify_all();
+    for(auto &t : m_threads) t.join();
+}
+
+bool ThreadPool::take(int id, int& index){
+    {
+        Range &own = m_ranges[id];
+        std::lock_guard<std::mutex> lk(own.m);
+        if(own.begin < own.end){ index = own.begin++; return true; }
+    }
+    // own range drained: steal the back half of the first victim that still has work
+    for(int k=1;k<m_size;k++){
+        Range &victim = m_ranges[(id + k) % m_size];
+        int b, e;
+        {
+            std::lock_guard<std::mutex> lk(victim.m);
+            int n = victim.end - victim.begin;
+            if(n <= 0) continue;
+            e = victim.end;
+            b = e - (n + 1) / 2;
+            victim.end = b;
+        }
+        index = b;
+        if(b + 1 < e){
+            Range &own = m_ranges[id];
+            std::lock_guard<std::mutex> lk(own.m);
+            own.begin = b + 1; own.end = e;
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run_items(int id){
+    int index;
+    while(take(id, index)) (*m_fn)(index, id);
+}
+
+void ThreadPool::worker_main(int id){
+    unsigned seen = 0;
+    for(;;){
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_wake.wait(lk, [&]{ return m_stop || m_generation != seen; });
+            if(m_stop) return;
+            seen = m_generation;
+        }
+        run_items(id);
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            if(--m_busy == 0) m_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallel_for(int count, const std::function<void(int,int)>& fn){
+    if(count <= 0) return;
+    if(m_size == 1){ for(int i=0;i<count;i++) fn(i, 0); return; }
+    for(int w=0;w<m_size;w++){
+        Range &r = m_ranges[w];
+        std::lock_guard<std::mutex> lk(r.m);
+        r.begin = (int)((long long)count * w / m_size);
+        r.end = (int)((long long)count * (w + 1) / m_size);
+    }
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_fn = &fn;
+        m_busy = m_size - 1;
+        m_generation++;
+    }
+    m_wake.notify_all();
+    run_items(0);
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_done.wait(lk, [&]{ return m_busy == 0; });
+    m_fn = nullptr;
+}
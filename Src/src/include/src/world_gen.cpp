@@ -0,0 +1,83 @@
+// src/world_gen.cpp
+#include "world_gen.hpp"
+
+// lattice spacing of the density field and of the asteroid shapes, as shifts (64 and 8 cells)
+static const int FIELD_SHIFT = 6;
+static const int SHAPE_SHIFT = 3;
+// a cell is rock where shape > THRESHOLD_BASE - density * 59/64 (noise values are 0..65535),
+// so areas with density below ~0.1 hold nothing at all
+static const int THRESHOLD_BASE = 72000;
+static const int SPECKLE_PERCENT = 60;
+enum { SALT_FIELD = 1, SALT_SHAPE = 2, SALT_SPECKLE = 3, SALT_HP = 4 };
+
+static inline uint32_t hashCell(uint32_t seed, uint32_t salt, int x, int y){
+    uint32_t h = seed * 0x9E3779B1u ^ salt * 0x7FEB352Du ^ (uint32_t)x * 0x85EBCA77u ^ (uint32_t)y * 0xC2B2AE3Du;
+    h ^= h >> 15; h *= 0x2C1B3C6Du;
+    h ^= h >> 12; h *= 0x297A2D39u;
+    h ^= h >> 15;
+    return h;
+}
+
+static inline int lattice(uint32_t seed, uint32_t salt, int x, int y){ return (int)(hashCell(seed, salt, x, y) >> 16); }
+
+// smoothstep weight 0..256 for offset t within a lattice cell of 1<<shift
+static inline int smoothWeight(int t, int shift){
+    int s = 1 << shift;
+    return (t * t * (3 * s - 2 * t) << 8) >> (3 * shift);
+}
+
+// value noise 0..65535 at cell (r,c), lattice every 1<<shift cells (r,c >= 0)
+static int valueNoise(uint32_t seed, uint32_t salt, int r, int c, int shift){
+    int x = c >> shift, y = r >> shift;
+    int mask = (1 << shift) - 1;
+    int wx = smoothWeight(c & mask, shift), wy = smoothWeight(r & mask, shift);
+    int a = (lattice(seed, salt, x, y) * (256 - wx) + lattice(seed, salt, x + 1, y) * wx) >> 8;
+    int b = (lattice(seed, salt, x, y + 1) * (256 - wx) + lattice(seed, salt, x + 1, y + 1) * wx) >> 8;
+    return (a * (256 - wy) + b * wy) >> 8;
+}
+
+static inline int threshold(int density){ return THRESHOLD_BASE - density * 59 / 64; }
+
+WorldGenParams worldgen_default(uint32_t seed, int rows, int cols){
+    WorldGenParams p;
+    p.seed = seed; p.rows = rows; p.cols = cols;
+    p.startR = rows / 2; p.startC = 10;
+    p.clearRadius = 4;
+    return p;
+}
+
+int worldgen_chunk(const WorldGenParams& p, int cr, int cc, Block* cells){
+    const int n = CHUNK_SIZE * CHUNK_SIZE;
+    for(int k=0;k<n;k++) cells[k] = Block();
+    int r0 = cr << CHUNK_SHIFT, c0 = cc << CHUNK_SHIFT;
+    if(r0 >= p.rows || c0 >= p.cols || r0 < 0 || c0 < 0) return 0;
+
+    // interpolation never exceeds the largest lattice value around it, so if even that cannot
+    // reach the threshold the whole chunk is empty space
+    int fx0 = c0 >> FIELD_SHIFT, fx1 = ((c0 + CHUNK_SIZE - 1) >> FIELD_SHIFT) + 1;
+    int fy0 = r0 >> FIELD_SHIFT, fy1 = ((r0 + CHUNK_SIZE - 1) >> FIELD_SHIFT) + 1;
+    int maxField = 0;
+    for(int y=fy0;y<=fy1;y++) for(int x=fx0;x<=fx1;x++){
+        int v = lattice(p.seed, SALT_FIELD, x, y);
+        if(v > maxField) maxField = v;
+    }
+    if(threshold(maxField) >= 65535) return 0;
+
+    int rEnd = r0 + CHUNK_SIZE < p.rows ? r0 + CHUNK_SIZE : p.rows;
+    int cEnd = c0 + CHUNK_SIZE < p.cols ? c0 + CHUNK_SIZE : p.cols;
+    long long clear2 = (long long)p.clearRadius * p.clearRadius;
+    int occupied = 0;
+    for(int r=r0;r<rEnd;r++){
+        Block *row = cells + ((r - r0) << CHUNK_SHIFT);
+        for(int c=c0;c<cEnd;c++){
+            int t = threshold(valueNoise(p.seed, SALT_FIELD, r, c, FIELD_SHIFT));
+            if(t >= 65535 || valueNoise(p.seed, SALT_SHAPE, r, c, SHAPE_SHIFT) <= t) continue;
+            if(hashCell(p.seed, SALT_SPECKLE, c, r) % 100 >= (uint32_t)SPECKLE_PERCENT) continue;
+            long long dr = r - p.startR, dc = c - p.startC;
+            if(dr * dr + dc * dc <= clear2) continue;
+            row[c - c0] = Block(BLOCK_ARMOR, 40 + (int)(hashCell(p.seed, SALT_HP, c, r) % 40));
+            occupied++;
+        }
+    }
+    return occupied;
+}
@@ -0,0 +1,162 @@
+// src/world_grid.cpp
+#include "world_grid.hpp"
+
+static const int SLAB_CHUNKS = 64;
+static const size_t MIN_TABLE = 64;
+
+WorldGrid::WorldGrid(){
+    m_rows = 0; m_cols = 0;
+    m_keys.assign(MIN_TABLE, WORLD_EMPTY_KEY);
+    m_vals.assign(MIN_TABLE, -1);
+    m_mask = MIN_TABLE - 1;
+    m_used = 0;
+    m_tracking = false;
+    m_journaling = false;
+    m_lastTouchedKey = WORLD_EMPTY_KEY; m_lastTouchedSlot = -1;
+}
+
+WorldGrid::~WorldGrid(){
+    for(Chunk* slab : m_slabs) delete[] slab;
+}
+
+void WorldGrid::reset(int rows, int cols){
+    while(!m_live.empty()) free_chunk(m_live.back());
+    m_rows = rows; m_cols = cols;
+    m_changes.clear();
+    m_written.clear();
+    track_touched(false);
+}
+
+int WorldGrid::alloc_chunk(int cr, int cc, bool clearCells){
+    if(m_free.empty()){
+        Chunk* slab = new Chunk[SLAB_CHUNKS];
+        m_slabs.push_back(slab);
+        for(int i=SLAB_CHUNKS-1;i>=0;i--){ m_free.push_back((int)m_pool.size() + i); }
+        for(int i=0;i<SLAB_CHUNKS;i++) m_pool.push_back(&slab[i]);
+    }
+    int idx = m_free.back(); m_free.pop_back();
+    Chunk &ch = *m_pool[idx];
+    if(clearCells) for(auto &b : ch.cells) b = Block();
+    ch.cr = cr; ch.cc = cc; ch.occupied = 0;
+    ch.liveSlot = (int)m_live.size();
+    m_live.push_back(idx);
+    table_insert(key(cr, cc), idx);
+    return idx;
+}
+
+void WorldGrid::free_chunk(int idx){
+    Chunk &ch = *m_pool[idx];
+    table_erase(key(ch.cr, ch.cc));
+    // swap-remove from the live list
+    int last = m_live.back();
+    m_live[ch.liveSlot] = last;
+    m_pool[last]->liveSlot = ch.liveSlot;
+    m_live.pop_back();
+    m_free.push_back(idx);
+}
+
+void WorldGrid::set(int r, int c, const Block& b){
+    if(!in_grid(r,c)) return;
+    if(m_journaling){ CellPos p = { r, c }; m_written.push_back(p); }
+    int cr = r >> CHUNK_SHIFT, cc = c >> CHUNK_SHIFT;
+    int idx = lookup(key(cr, cc));
+    if(idx < 0){
+        if(b.empty()) return; // empty chunks are never stored
+        idx = alloc_chunk(cr, cc);
+    }
+    if(m_tracking) touch(r, c);
+    Chunk &ch = *m_pool[idx];
+    Block &cell = ch.cells[((r & CHUNK_MASK) << CHUNK_SHIFT) | (c & CHUNK_MASK)];
+    ch.occupied += !b.empty() - !cell.empty();
+    if(cell.type() != b.type()){ CellPos p = { r, c }; m_changes.push_back(p); }
+    cell = b.empty() ? Block() : b;
+    if(ch.occupied == 0) free_chunk(idx);
+}
+
+void WorldGrid::clear(int r, int c){ set(r, c, Block()); }
+
+void WorldGrid::unload_chunk(int cr, int cc){
+    int idx = lookup(key(cr, cc));
+    if(idx >= 0) free_chunk(idx);
+}
+
+void WorldGrid::track_touched(bool on){
+    m_tracking = on;
+    m_touched.clear();
+    m_touchedIndex.clear();
+    m_lastTouchedKey = WORLD_EMPTY_KEY; m_lastTouchedSlot = -1;
+}
+
+void WorldGrid::touch(int r, int c){
+    uint64_t k = key(r >> CHUNK_SHIFT, c >> CHUNK_SHIFT);
+    if(k != m_lastTouchedKey){
+        auto it = m_touchedIndex.find(k);
+        if(it == m_touchedIndex.end()){
+            TouchedChunk t; t.cr = r >> CHUNK_SHIFT; t.cc = c >> CHUNK_SHIFT;
+            for(uint64_t &w : t.bits) w = 0;
+            it = m_touchedIndex.emplace(k, (int)m_touched.size()).first;
+            m_touched.push_back(t);
+        }
+        m_lastTouchedKey = k; m_lastTouchedSlot = it->second;
+    }
+    int bit = ((r & CHUNK_MASK) << CHUNK_SHIFT) | (c & CHUNK_MASK);
+    m_touched[m_lastTouchedSlot].bits[bit >> 6] |= 1ull << (bit & 63);
+}
+
+void WorldGrid::copy_from(const WorldGrid& o){
+    reset(o.m_rows, o.m_cols);
+    for(int idx : o.m_live){
+        const Chunk &src = *o.m_pool[idx];
+        Chunk &dst = *m_pool[alloc_chunk(src.cr, src.cc)];
+        for(int i=0;i<CHUNK_SIZE*CHUNK_SIZE;i++) dst.cells[i] = src.cells[i];
+        dst.occupied = src.occupied;
+    }
+    m_changes.clear();
+}
+
+void WorldGrid::table_insert(uint64_t k, int idx){
+    if((m_used + 1) * 2 > m_keys.size()) table_grow();
+    size_t h = home(k);
+    while(m_keys[h] != WORLD_EMPTY_KEY) h = (h + 1) & m_mask;
+    m_keys[h] = k; m_vals[h] = idx; m_used++;
+}
+
+void WorldGrid::table_erase(uint64_t k){
+    size_t h = home(k);
+    while(m_keys[h] != k){
+        if(m_keys[h] == WORLD_EMPTY_KEY) return;
+        h = (h + 1) & m_mask;
+    }
+    // backward-shift deletion keeps probe chains intact without tombstones
+    size_t hole = h;
+    for(size_t j = (h + 1) & m_mask; m_keys[j] != WORLD_EMPTY_KEY; j = (j + 1) & m_mask){
+        size_t want = home(m_keys[j]);
+        // move j into the hole unless its home lies cyclically in (hole, j]
+        bool stays = (hole <= j) ? (want > hole && want <= j) : (want > hole || want <= j);
+        if(!stays){ m_keys[hole] = m_keys[j]; m_vals[hole] = m_vals[j]; hole = j; }
+    }
+    m_keys[hole] = WORLD_EMPTY_KEY; m_vals[hole] = -1;
+    m_used--;
+}
+
+void WorldGrid::table_grow(){
+    std::vector<uint64_t> keys; keys.swap(m_keys);
+    std::vector<int> vals; vals.swap(m_vals);
+    size_t cap = keys.size() * 2;
+    m_keys.assign(cap, WORLD_EMPTY_KEY);
+    m_vals.assign(cap, -1);
+    m_mask = cap - 1;
+    m_used = 0;
+    for(size_t i=0;i<keys.size();i++) if(keys[i] != WORLD_EMPTY_KEY){
+        size_t h = home(keys[i]);
+        while(m_keys[h] != WORLD_EMPTY_KEY) h = (h + 1) & m_mask;
+        m_keys[h] = keys[i]; m_vals[h] = vals[i]; m_used++;
+    }
+}
+
+size_t WorldGrid::memory_bytes() const {
+    return m_slabs.size() * SLAB_CHUNKS * sizeof(Chunk)
+        + m_keys.capacity() * sizeof(uint64_t) + m_vals.capacity() * sizeof(int)
+        + (m_pool.capacity() + m_slabs.capacity()) * sizeof(void*)
+        + (m_free.capacity() + m_live.capacity()) * sizeof(int);
+}
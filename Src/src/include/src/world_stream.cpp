@@ -0,0 +1,349 @@
+// src/world_stream.cpp
+#include "world_stream.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+static const int REGION_CELLS = REGION_SIZE * REGION_SIZE;
+static const int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+static const int REGION_CHUNK_COUNT = REGION_CHUNKS * REGION_CHUNKS;
+
+// cell index within its region, and which of the region's chunks holds it
+static inline int regionCell(int r, int c){ return ((r & (REGION_SIZE - 1)) << REGION_SHIFT) | (c & (REGION_SIZE - 1)); }
+static inline int chunkOfCell(int idx){ return ((idx >> (REGION_SHIFT + CHUNK_SHIFT)) << REGION_CHUNK_SHIFT) | ((idx & (REGION_SIZE - 1)) >> CHUNK_SHIFT); }
+static inline int cellInChunk(int idx){ return (((idx >> REGION_SHIFT) & CHUNK_MASK) << CHUNK_SHIFT) | (idx & CHUNK_MASK); }
+
+WorldStream::WorldStream(){
+    m_params = worldgen_default(1, 0, 0);
+    m_report = false;
+    m_prefetch = 96; m_evict = 384;
+    m_async = 0; m_inline = 0; m_stalls = 0; m_evicted = 0;
+    m_epoch = 0;
+    m_stop = false;
+}
+
+WorldStream::~WorldStream(){ stop_workers(); }
+
+void WorldStream::drop_jobs(){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.clear();
+    m_results.clear();
+    m_epoch++;
+}
+
+void WorldStream::reset(WorldGrid& w, const WorldGenParams& p){
+    drop_jobs();
+    m_params = p;
+    m_regions.clear();
+    m_active.clear();
+    m_streamed.clear();
+    m_async = 0; m_inline = 0; m_stalls = 0; m_evicted = 0;
+    w.journal_writes(true);
+}
+
+WorldStream::Region& WorldStream::region(int rr, int rc){
+    auto it = m_regions.find(key(rr, rc));
+    if(it == m_regions.end()){
+        it = m_regions.emplace(key(rr, rc), Region()).first;
+        it->second.rr = rr; it->second.rc = rc; it->second.state = ABSENT;
+    }
+    return it->second;
+}
+
+bool WorldStream::resident(int rr, int rc) const {
+    auto it = m_regions.find(key(rr, rc));
+    return it != m_regions.end() && it->second.state == RESIDENT;
+}
+
+void WorldStream::chunk_blocks(const WorldGrid& w, int cr, int cc, Block* cells) const {
+    int rr = cr >> REGION_CHUNK_SHIFT, rc = cc >> REGION_CHUNK_SHIFT;
+    auto it = m_regions.find(key(rr, rc));
+    if(it != m_regions.end() && it->second.state == RESIDENT){
+        for(int k=0;k<CHUNK_CELLS;k++) cells[k] = Block();
+        int r0 = cr << CHUNK_SHIFT, c0 = cc << CHUNK_SHIFT;
+        w.visit_chunks(r0, c0, r0 + CHUNK_MASK, c0 + CHUNK_MASK, [&](const Chunk& ch){
+            for(int k=0;k<CHUNK_CELLS;k++) cells[k] = ch.cells[k];
+        });
+        return;
+    }
+    worldgen_chunk(m_params, cr, cc, cells);
+    if(it == m_regions.end()) return;
+    int i = ((cr & (REGION_CHUNKS - 1)) << REGION_CHUNK_SHIFT) | (cc & (REGION_CHUNKS - 1));
+    for(auto &m : it->second.mods) if(chunkOfCell(m.first) == i) cells[cellInChunk(m.first)] = m.second;
+}
+
+void WorldStream::generate(int rr, int rc, const WorldGenParams& p, Block* cells, int* occupied) const {
+    PROFILE_ZONE("worldgen_region");
+    for(int i=0;i<REGION_CHUNK_COUNT;i++){
+        int cr = (rr << REGION_CHUNK_SHIFT) + (i >> REGION_CHUNK_SHIFT);
+        int cc = (rc << REGION_CHUNK_SHIFT) + (i & (REGION_CHUNKS - 1));
+        occupied[i] = worldgen_chunk(p, cr, cc, cells + i * CHUNK_CELLS);
+    }
+}
+
+void WorldStream::install(WorldGrid& w, Region& reg, const Block* cells, const int* occupied){
+    int modsIn[REGION_CHUNK_COUNT] = { 0 };
+    for(auto &m : reg.mods) modsIn[chunkOfCell(m.first)]++;
+    for(int i=0;i<REGION_CHUNK_COUNT;i++){
+        int cr = (reg.rr << REGION_CHUNK_SHIFT) + (i >> REGION_CHUNK_SHIFT);
+        int cc = (reg.rc << REGION_CHUNK_SHIFT) + (i & (REGION_CHUNKS - 1));
+        if((cr << CHUNK_SHIFT) >= w.rows() || (cc << CHUNK_SHIFT) >= w.cols()) continue;
+        // a chunk may already exist if something wrote here early; generation replaces it
+        if(!occupied[i] && !modsIn[i]){ w.unload_chunk(cr, cc); continue; }
+        const Block *src = cells + i * CHUNK_CELLS;
+        w.load_chunk(cr, cc, [&](Block* dst){
+            for(int k=0;k<CHUNK_CELLS;k++) dst[k] = src[k];
+            if(modsIn[i]) for(auto &m : reg.mods) if(chunkOfCell(m.first) == i) dst[cellInChunk(m.first)] = m.second;
+            int occ = 0;
+            for(int k=0;k<CHUNK_CELLS;k++){
+                if(dst[k].empty()) continue;
+                occ++;
+                if(m_report){ CellPos p = { (cr << CHUNK_SHIFT) + (k >> CHUNK_SHIFT), (cc << CHUNK_SHIFT) + (k & CHUNK_MASK) }; m_streamed.push_back(p); }
+            }
+            return occ;
+        });
+    }
+    reg.state = RESIDENT;
+}
+
+void WorldStream::evict(WorldGrid& w, Region& reg){
+    int r0 = reg.rr << REGION_SHIFT, c0 = reg.rc << REGION_SHIFT;
+    if(m_report){
+        w.visit_chunks(r0, c0, r0 + REGION_SIZE - 1, c0 + REGION_SIZE - 1, [&](const Chunk& ch){
+            for(int k=0;k<CHUNK_CELLS;k++) if(!ch.cells[k].empty()){
+                CellPos p = { ch.row0() + (k >> CHUNK_SHIFT), ch.col0() + (k & CHUNK_MASK) };
+                m_streamed.push_back(p);
+            }
+        });
+    }
+    for(int i=0;i<REGION_CHUNK_COUNT;i++)
+        w.unload_chunk((reg.rr << REGION_CHUNK_SHIFT) + (i >> REGION_CHUNK_SHIFT), (reg.rc << REGION_CHUNK_SHIFT) + (i & (REGION_CHUNKS - 1)));
+    reg.state = ABSENT;
+    m_evicted++;
+}
+
+void WorldStream::record_writes(WorldGrid& w){
+    for(const CellPos &p : w.written())
+        region(p.r >> REGION_SHIFT, p.c >> REGION_SHIFT).mods[regionCell(p.r, p.c)] = w.get(p.r, p.c);
+    w.clear_written();
+}
+
+// Chebyshev distance in cells from (r,c) to region (rr,rc)
+static int regionDistance(int rr, int rc, int r, int c){
+    int r0 = rr << REGION_SHIFT, c0 = rc << REGION_SHIFT;
+    int dr = r < r0 ? r0 - r : (r >= r0 + REGION_SIZE ? r - (r0 + REGION_SIZE - 1) : 0);
+    int dc = c < c0 ? c0 - c : (c >= c0 + REGION_SIZE ? c - (c0 + REGION_SIZE - 1) : 0);
+    return dr > dc ? dr : dc;
+}
+
+// region (rr,rc) resident now, generated here if no worker has delivered it
+void WorldStream::require(WorldGrid& w, int rr, int rc){
+    Region &reg = region(rr, rc);
+    if(reg.state == RESIDENT) return;
+    if(reg.state == PENDING) m_stalls++;
+    else m_active.push_back(key(rr, rc));
+    m_scratch.resize(REGION_CELLS);
+    int occupied[REGION_CHUNK_COUNT];
+    generate(rr, rc, m_params, m_scratch.data(), occupied);
+    install(w, reg, m_scratch.data(), occupied);
+    m_inline++;
+}
+
+void WorldStream::update(WorldGrid& w, const StreamFocus* foci, int count){
+    record_writes(w); // before installs, so writes into not-yet-generated regions survive them
+    if(m_params.rows <= 0 || m_params.cols <= 0 || count <= 0) return;
+
+    if(!m_threads.empty()){
+        std::vector<Result> done;
+        { std::lock_guard<std::mutex> lock(m_mutex); done.swap(m_results); }
+        for(Result &res : done){
+            if(res.epoch != m_epoch) continue;
+            auto it = m_regions.find(key(res.rr, res.rc));
+            if(it == m_regions.end() || it->second.state != PENDING) continue; // cancelled meanwhile
+            install(w, it->second, res.cells.data(), res.occupied);
+            m_async++;
+        }
+    }
+
+    int rrMax = (m_params.rows - 1) >> REGION_SHIFT, rcMax = (m_params.cols - 1) >> REGION_SHIFT;
+    auto box = [&](int r, int c, int radius, int &rr0, int &rc0, int &rr1, int &rc1){
+        rr0 = std::max(0, (r - radius) >> REGION_SHIFT); rr1 = std::min(rrMax, std::max(r + radius, 0) >> REGION_SHIFT);
+        rc0 = std::max(0, (c - radius) >> REGION_SHIFT); rc1 = std::min(rcMax, std::max(c + radius, 0) >> REGION_SHIFT);
+    };
+
+    // what this tick can touch must be there, worker or not, around every focus
+    int rr0, rc0, rr1, rc1;
+    m_held.clear();
+    for(int f=0;f<count;f++){
+        box(foci[f].r, foci[f].c, foci[f].reach, rr0, rc0, rr1, rc1);
+        for(int rr=rr0; rr<=rr1; rr++) for(int rc=rc0; rc<=rc1; rc++) require(w, rr, rc);
+        if(f == 0) continue;
+        // a region of slack, so a ship on a region border does not evict and regenerate it
+        box(foci[f].r, foci[f].c, foci[f].reach + REGION_SIZE, rr0, rc0, rr1, rc1);
+        for(int rr=rr0; rr<=rr1; rr++) for(int rc=rc0; rc<=rc1; rc++) m_held.push_back(key(rr, rc));
+    }
+    std::sort(m_held.begin(), m_held.end());
+    m_held.erase(std::unique(m_held.begin(), m_held.end()), m_held.end());
+
+    int r = foci[0].r, c = foci[0].c, reach = foci[0].reach;
+
+    // the rest of the neighbourhood is queued nearest first
+    if(!m_threads.empty() && m_prefetch > reach){
+        box(r, c, m_prefetch, rr0, rc0, rr1, rc1);
+        std::vector<RegionPos> want;
+        for(int rr=rr0; rr<=rr1; rr++) for(int rc=rc0; rc<=rc1; rc++){
+            auto it = m_regions.find(key(rr, rc));
+            if(it == m_regions.end() || it->second.state == ABSENT){ RegionPos p = { rr, rc }; want.push_back(p); }
+        }
+        if(!want.empty()){
+            std::sort(want.begin(), want.end(), [&](const RegionPos &a, const RegionPos &b){
+                return regionDistance(a.rr, a.rc, r, c) < regionDistance(b.rr, b.rc, r, c);
+            });
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for(const RegionPos &p : want){
+                region(p.rr, p.rc).state = PENDING;
+                m_active.push_back(key(p.rr, p.rc));
+                Job job = { p.rr, p.rc, m_epoch, m_params };
+                m_jobs.push_back(job);
+            }
+            m_wake.notify_all();
+        }
+    }
+
+    // far regions go; their log entries stay so they can come back
+    int limit = std::max(m_evict, reach);
+    for(size_t i=0;i<m_active.size();){
+        auto it = m_regions.find(m_active[i]);
+        Region &reg = it->second;
+        if(regionDistance(reg.rr, reg.rc, r, c) <= limit || std::binary_search(m_held.begin(), m_held.end(), m_active[i])){ i++; continue; }
+        if(reg.state == RESIDENT) evict(w, reg);
+        reg.state = ABSENT; // a pending result is dropped when it arrives
+        if(reg.mods.empty()) m_regions.erase(it);
+        m_active[i] = m_active.back(); m_active.pop_back();
+    }
+}
+
+void WorldStream::start_workers(int threads){
+    stop_workers();
+    m_stop = false;
+    for(int i=0;i<threads;i++) m_threads.emplace_back([this]{ worker_main(); });
+}
+
+void WorldStream::stop_workers(){
+    if(m_threads.empty()) return;
+    { std::lock_guard<std::mutex> lock(m_mutex); m_stop = true; }
+    m_wake.notify_all();
+    for(auto &t : m_threads) t.join();
+    m_threads.clear();
+    drop_jobs();
+    for(size_t i=0;i<m_active.size();){
+        auto it = m_regions.find(m_active[i]);
+        if(it->second.state == RESIDENT){ i++; continue; }
+        it->second.state = ABSENT;
+        if(it->second.mods.empty()) m_regions.erase(it);
+        m_active[i] = m_active.back(); m_active.pop_back();
+    }
+}
+
+void WorldStream::worker_main(){
+    PROFILE_THREAD("stream_worker");
+    for(;;){
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]{ return m_stop || !m_jobs.empty(); });
+            if(m_stop) return;
+            job = m_jobs.front(); m_jobs.pop_front();
+        }
+        Result res;
+        res.rr = job.rr; res.rc = job.rc; res.epoch = job.epoch;
+        res.cells.resize(REGION_CELLS);
+        generate(job.rr, job.rc, job.params, res.cells.data(), res.occupied);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(std::move(res));
+    }
+}
+
+void WorldStream::collect_mods(const WorldGrid& w, std::vector<ModCell>& out) const {
+    out.clear();
+    for(auto &kv : m_regions){
+        const Region &reg = kv.second;
+        for(auto &m : reg.mods){
+            ModCell mc = { (reg.rr << REGION_SHIFT) + (m.first >> REGION_SHIFT), (reg.rc << REGION_SHIFT) + (m.first & (REGION_SIZE - 1)), m.second };
+            out.push_back(mc);
+        }
+    }
+    // writes since the last update() override what the log has
+    for(const CellPos &p : w.written()){ ModCell mc = { p.r, p.c, w.get(p.r, p.c) }; out.push_back(mc); }
+    std::stable_sort(out.begin(), out.end(), [](const ModCell &a, const ModCell &b){ return a.r != b.r ? a.r < b.r : a.c < b.c; });
+    size_t n = 0;
+    for(size_t i=0;i<out.size();i++){
+        if(i + 1 < out.size() && out[i+1].r == out[i].r && out[i+1].c == out[i].c) continue; // a newer one follows
+        out[n++] = out[i];
+    }
+    out.resize(n);
+}
+
+void WorldStream::resident_regions(std::vector<RegionPos>& out) const {
+    out.clear();
+    for(long long k : m_active){
+        const Region &reg = m_regions.find(k)->second;
+        if(reg.state == RESIDENT){ RegionPos p = { reg.rr, reg.rc }; out.push_back(p); }
+    }
+    std::sort(out.begin(), out.end(), [](const RegionPos &a, const RegionPos &b){ return a.rr != b.rr ? a.rr < b.rr : a.rc < b.rc; });
+}
+
+void WorldStream::restore(WorldGrid& w, const WorldGenParams& p, const std::vector<ModCell>& mods, const std::vector<RegionPos>& resident){
+    reset(w, p);
+    for(const ModCell &m : mods) region(m.r >> REGION_SHIFT, m.c >> REGION_SHIFT).mods[regionCell(m.r, m.c)] = m.b;
+    for(const RegionPos &rp : resident){
+        Region &reg = region(rp.rr, rp.rc);
+        if(reg.state == RESIDENT) continue;
+        reg.state = RESIDENT;
+        m_active.push_back(key(rp.rr, rp.rc));
+    }
+}
+
+void WorldStream::restore_delta(WorldGrid& w, const std::vector<ModCell>& mods, const std::vector<RegionPos>& resident){
+    record_writes(w);
+    for(auto &kv : m_regions) kv.second.mods.clear();
+    for(const ModCell &m : mods) region(m.r >> REGION_SHIFT, m.c >> REGION_SHIFT).mods[regionCell(m.r, m.c)] = m.b;
+    std::unordered_set<long long> keep;
+    for(const RegionPos &rp : resident) keep.insert(key(rp.rr, rp.rc));
+    for(size_t i=0;i<m_active.size();){
+        auto it = m_regions.find(m_active[i]);
+        if(it->second.state != RESIDENT || keep.count(m_active[i])){ i++; continue; }
+        evict(w, it->second);
+        m_active[i] = m_active.back(); m_active.pop_back();
+    }
+    // and regions the saver held that this session does not are generated now, so the
+    // resident world matches the saver's exactly
+    for(const RegionPos &rp : resident){
+        Region &reg = region(rp.rr, rp.rc);
+        if(reg.state == RESIDENT) continue;
+        if(reg.state == ABSENT) m_active.push_back(key(rp.rr, rp.rc));
+        m_scratch.resize(REGION_CELLS);
+        int occupied[REGION_CHUNK_COUNT];
+        generate(rp.rr, rp.rc, m_params, m_scratch.data(), occupied);
+        install(w, reg, m_scratch.data(), occupied);
+        m_inline++;
+    }
+    for(auto it = m_regions.begin(); it != m_regions.end();){
+        if(it->second.state == ABSENT && it->second.mods.empty()) it = m_regions.erase(it);
+        else ++it;
+    }
+}
+
+StreamStats WorldStream::stats() const {
+    StreamStats st;
+    st.resident = 0; st.pending = 0;
+    for(long long k : m_active){
+        int state = m_regions.find(k)->second.state;
+        if(state == RESIDENT) st.resident++;
+        else if(state == PENDING) st.pending++;
+    }
+    st.generatedAsync = m_async; st.generatedInline = m_inline; st.stalls = m_stalls; st.evicted = m_evicted;
+    st.modCells = 0;
+    for(auto &kv : m_regions) st.modCells += kv.second.mods.size();
+    return st;
+}
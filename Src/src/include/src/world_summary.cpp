@@ -0,0 +1,166 @@
+// src/world_summary.cpp
+#include "world_summary.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+WorldSummary::WorldSummary(){
+    m_rows = 0; m_cols = 0;
+    m_baseShift = SUMMARY_MIN_BASE_SHIFT;
+}
+
+static int nodesAlong(int cells, int shift){ return (int)(((long long)cells + (1ll << shift) - 1) >> shift); }
+
+void WorldSummary::reset(int rows, int cols){
+    m_rows = rows; m_cols = cols;
+    m_baseShift = SUMMARY_MIN_BASE_SHIFT;
+    while((long long)nodesAlong(rows, m_baseShift) * nodesAlong(cols, m_baseShift) > SUMMARY_MAX_BASE_NODES) m_baseShift++;
+    size_t n = 0;
+    for(int shift = m_baseShift;; shift++){
+        int lr = nodesAlong(rows, shift), lc = nodesAlong(cols, shift);
+        if(n == m_levels.size()) m_levels.emplace_back();
+        Level &lv = m_levels[n++];
+        lv.rows = lr; lv.cols = lc;
+        lv.counts.assign((size_t)lr * lc * SUMMARY_TYPES, 0);
+        lv.colors.assign((size_t)lr * lc, BLOCK_INFO[BLOCK_EMPTY].color);
+        if(lr <= 1 && lc <= 1) break;
+    }
+    m_levels.resize(n);
+}
+
+void WorldSummary::build(const WorldGrid& world){
+    reset(world.rows(), world.cols());
+    if(m_levels.empty()) return;
+    Level &base = m_levels[0];
+    for(int i=0;i<world.chunk_count();i++){
+        const Chunk &ch = world.chunk(i);
+        for(int lr=0;lr<CHUNK_SIZE;lr++) for(int lc=0;lc<CHUNK_SIZE;lc++){
+            BlockType t = ch.at(lr, lc).type();
+            if(t == BLOCK_EMPTY) continue;
+            int nr = (ch.row0() + lr) >> m_baseShift, nc = (ch.col0() + lc) >> m_baseShift;
+            base.counts[((size_t)nr * base.cols + nc) * SUMMARY_TYPES + (t - 1)]++;
+        }
+    }
+    // each level is the 2x2 sums of the one below
+    for(size_t k=1;k<m_levels.size();k++){
+        const Level &lo = m_levels[k-1];
+        Level &hi = m_levels[k];
+        for(int r=0;r<lo.rows;r++) for(int c=0;c<lo.cols;c++){
+            const uint32_t *src = &lo.counts[((size_t)r * lo.cols + c) * SUMMARY_TYPES];
+            uint32_t *dst = &hi.counts[((size_t)(r >> 1) * hi.cols + (c >> 1)) * SUMMARY_TYPES];
+            for(int t=0;t<SUMMARY_TYPES;t++) dst[t] += src[t];
+        }
+    }
+    for(size_t k=0;k<m_levels.size();k++)
+        for(size_t i=0;i<m_levels[k].colors.size();i++) recolor((int)k, i);
+}
+
+void WorldSummary::change(int r, int c, BlockType from, BlockType to){
+    if(from == to || r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
+    for(size_t k=0;k<m_levels.size();k++){
+        Level &lv = m_levels[k];
+        int shift = m_baseShift + (int)k;
+        size_t node = (size_t)(r >> shift) * lv.cols + (c >> shift);
+        uint32_t *n = &lv.counts[node * SUMMARY_TYPES];
+        if(from != BLOCK_EMPTY) n[from - 1]--;
+        if(to != BLOCK_EMPTY) n[to - 1]++;
+        recolor((int)k, node);
+    }
+}
+
+uint32_t WorldSummary::occupied(int k, int nr, int nc) const {
+    const uint32_t *n = counts(k, nr, nc);
+    uint32_t sum = 0;
+    for(int t=0;t<SUMMARY_TYPES;t++) sum += n[t];
+    return sum;
+}
+
+uint32_t WorldSummary::area(int k, int nr, int nc) const {
+    int shift = level_shift(k);
+    long long r0 = (long long)nr << shift, c0 = (long long)nc << shift;
+    long long h = std::min<long long>(m_rows, r0 + (1ll << shift)) - r0;
+    long long w = std::min<long long>(m_cols, c0 + (1ll << shift)) - c0;
+    return (uint32_t)std::min<long long>(h * w, UINT32_MAX);
+}
+
+int WorldSummary::level_for(double cellsPerPixel) const {
+    int k = 0;
+    while(k + 1 < levels() && (double)(1ll << level_shift(k)) < cellsPerPixel) k++;
+    return k;
+}
+
+size_t WorldSummary::memory_bytes() const {
+    size_t bytes = m_levels.capacity() * sizeof(Level);
+    for(const Level &lv : m_levels) bytes += (lv.counts.capacity() + lv.colors.capacity()) * sizeof(uint32_t);
+    return bytes;
+}
+
+// tile color blended with each type's color by its share of the node's cells
+void WorldSummary::recolor(int k, size_t node){
+    Level &lv = m_levels[k];
+    const uint32_t *n = &lv.counts[node * SUMMARY_TYPES];
+    uint32_t tile = BLOCK_INFO[BLOCK_EMPTY].color;
+    uint64_t cells = area(k, (int)(node / lv.cols), (int)(node % lv.cols));
+    if(cells == 0){ lv.colors[node] = tile; return; }
+    uint64_t rest = cells;
+    uint64_t ch[3] = { 0, 0, 0 };
+    for(int t=0;t<SUMMARY_TYPES;t++){
+        if(!n[t]) continue;
+        uint32_t col = BLOCK_INFO[t + 1].color;
+        ch[0] += (uint64_t)n[t] * ((col >> 16) & 0xFF);
+        ch[1] += (uint64_t)n[t] * ((col >> 8) & 0xFF);
+        ch[2] += (uint64_t)n[t] * (col & 0xFF);
+        rest -= std::min<uint64_t>(rest, n[t]);
+    }
+    ch[0] += rest * ((tile >> 16) & 0xFF);
+    ch[1] += rest * ((tile >> 8) & 0xFF);
+    ch[2] += rest * (tile & 0xFF);
+    double inv = 1.0 / (double)cells;
+    lv.colors[node] = (uint32_t)(ch[0] * inv + 0.5) << 16 | (uint32_t)(ch[1] * inv + 0.5) << 8 | (uint32_t)(ch[2] * inv + 0.5);
+}
+
+int world_summary_draw(Framebuffer& fb, const WorldSummary& sum, int x, int y, int w, int h,
+    double r0, double c0, double cellsPerPixel, uint32_t outside){
+    // clip to the framebuffer, then map every column to its node once (-1 = off the map)
+    int px0 = std::max(x, 0), py0 = std::max(y, 0);
+    int px1 = std::min(x + w, fb.width), py1 = std::min(y + h, fb.height);
+    if(px0 >= px1 || py0 >= py1) return 0;
+    if(sum.levels() == 0){ // never built: all off the map
+        for(int py=py0;py<py1;py++) std::fill(fb.pixels + (size_t)py * fb.stride + px0, fb.pixels + (size_t)py * fb.stride + px1, outside);
+        return 0;
+    }
+    int k = sum.level_for(cellsPerPixel);
+    int shift = sum.level_shift(k);
+    std::vector<int> colNode(px1 - px0);
+    for(int px=px0;px<px1;px++){
+        double c = std::floor(c0 + (px - x + 0.5) * cellsPerPixel);
+        colNode[px - px0] = (c < 0 || c >= sum.cols()) ? -1 : (int)c >> shift;
+    }
+    int lastNr = -2;
+    const uint32_t *lastRow = nullptr;
+    for(int py=py0;py<py1;py++){
+        uint32_t *row = fb.pixels + (size_t)py * fb.stride;
+        double r = std::floor(r0 + (py - y + 0.5) * cellsPerPixel);
+        int nr = (r < 0 || r >= sum.rows()) ? -1 : (int)r >> shift;
+        // magnified levels repeat whole rows
+        if(nr == lastNr){ memcpy(row + px0, lastRow + px0, (size_t)(px1 - px0) * sizeof(uint32_t)); continue; }
+        if(nr < 0) std::fill(row + px0, row + px1, outside);
+        else{
+            const uint32_t *colors = sum.color_row(k, nr);
+            for(int px=px0;px<px1;px++){
+                int nc = colNode[px - px0];
+                row[px] = nc < 0 ? outside : colors[nc];
+            }
+        }
+        lastNr = nr; lastRow = row;
+    }
+    return k;
+}
+
+double world_summary_fit(const WorldSummary& sum, int maxW, int maxH, int& w, int& h){
+    double cellsPerPixel = std::max((double)sum.cols() / std::max(maxW, 1), (double)sum.rows() / std::max(maxH, 1));
+    if(cellsPerPixel <= 0){ w = 0; h = 0; return 1.0; }
+    w = std::min(maxW, (int)std::ceil(sum.cols() / cellsPerPixel));
+    h = std::min(maxH, (int)std::ceil(sum.rows() / cellsPerPixel));
+    return cellsPerPixel;
+}
@@ -0,0 +1,68 @@
+// include/state_server.hpp
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "net_socket.hpp"
+#include "state_stream.hpp"
+
+struct StateServerStats {
+    int viewers;                // connected now
+    long joined, dropped;       // viewers ever accepted / dropped for falling behind, closing or sending garbage
+    long keyframes, frames;     // messages sent (a frame to n viewers counts once)
+    long inputs;                // input messages taken from the pilot
+    size_t lastKeyframeBytes, lastFrameBytes;
+    uint64_t frameBytes;        // all frames, once each
+    uint64_t bytesOut, bytesIn; // on the wire, all viewers, closed links included
+};
+
+// Headless authoritative host for one session: viewers connect to a socket, get a keyframe of
+// the session and then one delta frame (state_stream.hpp) after every tick. The oldest viewer
+// pilots: its input messages drive the session's input source, and frames echo the newest one a
+// tick consumed; the others watch. Everything runs on the caller's thread between ticks and
+// never blocks it: a viewer that cannot keep up is dropped when its send queue fills.
+class StateServer {
+public:
+    StateServer();
+    ~StateServer();
+    StateServer(const StateServer&) = delete;
+    StateServer& operator=(const StateServer&) = delete;
+
+    // listen on addr (net_socket.hpp) and take over s's input source; false if the address
+    // cannot be bound. s must outlive the server or stop().
+    bool start(Session& s, const char* addr);
+    void stop();
+    bool running() const { return m_listener != NET_INVALID; }
+
+    // between ticks: accept viewers (each gets a keyframe), take the pilot's input and send what
+    // is still queued
+    void poll();
+    // after each tick: the frame for it to every viewer. cells are the world cells whose block
+    // type the tick changed (world.changes(), or game_dirty_cells() with streamed cells left out
+    // by report_streamed(false)). Nothing is sent if no tick ran since the last publish().
+    void publish(const std::vector<CellPos>& cells);
+    // after s was replaced wholesale (session_reset, game_init, a load): keyframes to everyone
+    void resync();
+
+    // waits up to ms for a viewer to send something or a new one to connect
+    void wait(int ms);
+    const StateServerStats& stats() const { return m_stats; }
+
+private:
+    static Vec2 input(int tick, void* user);
+    void drop(size_t i);
+    void count();
+    void sendAll(const std::vector<uint8_t>& msg);
+
+    Session* m_s;
+    NetSocket m_listener;
+    std::string m_addr;
+    std::vector<std::unique_ptr<NetLink>> m_viewers; // [0] pilots
+    StateEncoder m_encoder;
+    std::vector<uint8_t> m_msg;
+    Vec2 m_thrust;
+    uint32_t m_received, m_applied; // the pilot's newest input / the newest a tick consumed
+    int m_lastTick;
+    uint64_t m_closedOut, m_closedIn; // bytes of links already closed
+    StateServerStats m_stats;
+};
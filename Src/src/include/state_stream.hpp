@@ -0,0 +1,136 @@
+// include/state_stream.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game.hpp"
+
+// Wire format for streaming a session to viewers (state_server.hpp sends it, StateMirror
+// rebuilds it). A viewer joins on one keyframe and then follows one frame per tick, each
+// holding only what the tick changed:
+//  - world cells never travel as chunks: world_gen is a pure function of the seed, so the
+//    viewer regenerates the resident regions itself from the keyframe's parameters and the
+//    stream's modification log, and after that gets each tick's block type changes plus the
+//    resident region set whenever it changes
+//  - ship, debris and drone transforms are quantized (1/STREAM_POS_SCALE px,
+//    1/STREAM_ANGLE_STEPS turn) and sent as the error of a constant-velocity prediction from
+//    the last two quantized values both sides hold; a body's blocks only go out when they
+//    differ from the viewer's copy
+//  - drone spawns and deaths are the appends and swap-removes the session made (DroneStore's
+//    op journal), replayed in order, so the viewer's drones keep the session's indices
+// Inputs go the other way as small messages whose sequence number frames echo. A message is a
+// kind byte and its payload, all bytes and varints (signed values zigzagged), so byte order
+// and padding never matter; net_socket.hpp frames messages on the wire.
+static const int STREAM_VERSION = 1;
+static const int STREAM_POS_SCALE = 8;
+static const int STREAM_ANGLE_STEPS = 65536;
+static const int STREAM_INPUT_SCALE = 16384; // thrust units per 1.0
+enum StreamMsg { STREAM_KEYFRAME = 1, STREAM_FRAME, STREAM_INPUT };
+
+// a ship or loose piece as a viewer holds it: quantized pose, the last step of each (the next
+// one is predicted to repeat it) and a hash of its blocks
+struct StreamBody { int64_t x, y, dx, dy; int angle, dAngle; uint64_t shape; };
+// a drone likewise, position only
+struct StreamDrone { int64_t x, y, dx, dy; };
+
+// Server side. Holds the quantized state every synced viewer holds, so each frame is the
+// difference from it.
+class StateEncoder {
+public:
+    StateEncoder();
+    // viewers hold s as it is now (they are about to get keyframes of it); turns on s.drones'
+    // op journal
+    void sync(Session& s);
+    // keyframe message of s as it is now: the generator parameters, modification log, resident
+    // regions and every body and drone. After sync(s) or frame(s) it decodes to exactly what
+    // synced viewers hold, so a viewer joining on it follows the next frame().
+    void keyframe(const Session& s, uint32_t inputAck, std::vector<uint8_t>& out) const;
+    // frame message for the tick s just ran; inputAck is the sequence number of the newest input
+    // the tick consumed (0 = none). cells: the world cells whose block type the tick changed
+    // (world.changes()), not cells streamed in or out, which viewers regenerate. Consumes
+    // s.drones' op journal; without one the drones go out as a clear and fresh spawns.
+    void frame(Session& s, const std::vector<CellPos>& cells, uint32_t inputAck, std::vector<uint8_t>& out);
+
+private:
+    std::vector<StreamBody> m_ships, m_debris;
+    std::vector<StreamDrone> m_drones;
+    std::vector<RegionPos> m_resident;     // sorted
+    std::vector<RegionPos> m_residentNow;  // scratch
+    std::vector<int> m_reshaped;           // scratch: bodies whose blocks go out
+    std::vector<char> m_fresh;             // scratch: drones this frame spawned
+};
+
+// input message: the pilot's thrust (quantized to 1/STREAM_INPUT_SCALE) under sequence number
+// seq (from 1, increasing)
+void stream_encode_input(uint32_t seq, Vec2 thrust, std::vector<uint8_t>& out);
+bool stream_decode_input(const uint8_t* msg, size_t n, uint32_t& seq, Vec2& thrust);
+
+struct StreamReader;
+struct MirrorBody { double x, y, angle; ShipGrid blocks; };
+
+// Viewer side: the session as the messages describe it. The world holds the server's resident
+// regions only, and tracks block types: cells a frame changes read at their type's registry hp.
+class StateMirror {
+public:
+    StateMirror();
+    StateMirror(const StateMirror&) = delete;
+    StateMirror& operator=(const StateMirror&) = delete;
+
+    // one message, kind byte first. False if it is malformed or a frame arrives without a
+    // keyframe before it; the mirror then ignores frames until the next keyframe.
+    bool apply(const uint8_t* msg, size_t n);
+    bool synced() const { return m_synced; }
+
+    int tick() const { return m_tick; }
+    int resources() const { return m_resources; }
+    int score() const { return m_score; }
+    bool paused() const { return m_paused; }
+    bool game_over() const { return m_gameOver; }
+    // newest input the server's last tick consumed
+    uint32_t input_ack() const { return m_inputAck; }
+
+    const WorldGrid& world() const { return m_world; }
+    // cells whose type changed or that were streamed in or out since clear_dirty_cells();
+    // generation() changes whenever a keyframe replaces the whole world
+    const std::vector<CellPos>& dirty_cells() const { return m_dirty; }
+    void clear_dirty_cells(){ m_dirty.clear(); }
+    unsigned generation() const { return m_generation; }
+
+    // [PLAYER_SHIP] is the player's; pos is the core's center as in ShipStore
+    const std::vector<MirrorBody>& ships() const { return m_ships; }
+    const std::vector<MirrorBody>& debris() const { return m_debris; }
+    const std::vector<double>& drone_x() const { return m_droneX; }
+    const std::vector<double>& drone_y() const { return m_droneY; }
+    // the last message's drone spawns (indices after it) and how many drones it removed
+    const std::vector<int>& drone_spawns() const { return m_spawns; }
+    int drone_deaths() const { return m_deaths; }
+
+private:
+    bool applyKeyframe(StreamReader& in);
+    bool applyFrame(StreamReader& in);
+    bool readHeader(StreamReader& in, uint8_t& flags);
+    bool readRegions(StreamReader& in);
+    bool readBlocks(StreamReader& in, ShipGrid& g);
+    bool readHeldBodies(StreamReader& in, std::vector<StreamBody>& held, std::vector<MirrorBody>& out);
+    bool applyBodies(StreamReader& in, std::vector<StreamBody>& held, std::vector<MirrorBody>& out);
+    bool applyDrones(StreamReader& in);
+    void takeStreamed();
+
+    WorldGrid m_world;
+    WorldStream m_stream;
+    std::vector<CellPos> m_dirty;
+    unsigned m_generation;
+    bool m_synced;
+    int m_tick, m_resources, m_score;
+    bool m_paused, m_gameOver;
+    uint32_t m_inputAck;
+    std::vector<StreamBody> m_heldShips, m_heldDebris;
+    std::vector<StreamDrone> m_heldDrones;
+    std::vector<MirrorBody> m_ships, m_debris;
+    std::vector<double> m_droneX, m_droneY;
+    std::vector<char> m_fresh;             // scratch: drones the message spawned
+    std::vector<int> m_spawns;
+    int m_deaths;
+    std::vector<RegionPos> m_resident;     // scratch
+    std::vector<ModCell> m_mods;           // scratch
+};
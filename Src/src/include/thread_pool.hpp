@@ -0,0 +1,37 @@
+// include/thread_pool.hpp
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size work-stealing pool. parallel_for() splits [0,count) into one contiguous range
+// per worker; a worker takes items from the front of its own range and, once that is empty,
+// steals the back half of another worker's range. The calling thread works as worker 0.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads = 0); // 0 = one per hardware thread
+    ~ThreadPool();
+    int size() const { return m_size; }
+    // runs fn(index, worker) for every index in [0,count); returns when all are done
+    void parallel_for(int count, const std::function<void(int,int)>& fn);
+
+private:
+    struct Range { std::mutex m; int begin = 0, end = 0; };
+
+    void worker_main(int id);
+    void run_items(int id);
+    bool take(int id, int& index);
+
+    int m_size;
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<Range[]> m_ranges;
+    std::mutex m_mutex;
+    std::condition_variable m_wake, m_done;
+    const std::function<void(int,int)>* m_fn = nullptr;
+    unsigned m_generation = 0;
+    int m_busy = 0;
+    bool m_stop = false;
+};
@@ -0,0 +1,57 @@
+// include/tick_events.hpp
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Deferred world mutations. The read phases of a tick (mining, drones, collisions) never write
+// the world, resources or score: each worker emits events into its own buffer and the apply
+// phase runs them all on one thread, in order-key order. Keys are made from the phase and the
+// item that emitted the event (miner, drone, contact), never from the worker that ran it, so
+// the result is the same at any thread count, and every read phase sees the world as the tick
+// found it.
+enum TickEventKind {
+    TICK_MINE = 0,      // a miner over (r,c): a mineable block still there loses 1-3 hp (rng); breaking it gives its registry mine yield (player's miners only)
+    TICK_DAMAGE,        // (r,c) loses amount hp if still solid; breaking it gives reward resources
+    TICK_SHIP_HIT,      // a drone hit the bare hull: amount px/tick (for the starting ship's mass) added to the ship's x velocity, 2 score lost
+    TICK_SHIP_DAMAGE    // ship block at ship cell (r,c) loses amount hp if still aboard; breaking it removes it and cuts loose what it held on
+};
+
+struct TickEvent {
+    uint64_t order;
+    int kind;
+    int r, c;
+    int amount, reward;
+    int ship;           // index in s.ships of the ship the event comes from or is about (0 = the player's)
+};
+
+// phase in the top byte, then the item within the phase (48 bits), then a sequence number within the item
+inline uint64_t tick_event_order(int phase, uint64_t item, int seq = 0){
+    return ((uint64_t)phase << 56) | ((item & 0xffffffffffffull) << 8) | (uint64_t)(seq & 0xff);
+}
+
+class TickEvents {
+public:
+    // a new tick: every buffer emptied, at least one per worker
+    void begin(int workers){
+        if((int)m_buffers.size() < workers) m_buffers.resize(workers);
+        for(auto &b : m_buffers) b.clear();
+        m_merged.clear();
+    }
+    void emit(int worker, const TickEvent& e){ m_buffers[worker].push_back(e); }
+    void emit(int worker, uint64_t order, int kind, int r, int c, int amount = 0, int reward = 0, int ship = 0){
+        TickEvent e; e.order = order; e.kind = kind; e.r = r; e.c = c; e.amount = amount; e.reward = reward; e.ship = ship;
+        m_buffers[worker].push_back(e);
+    }
+    // every buffer's events in key order (keys are unique, so this is the only order there is)
+    const std::vector<TickEvent>& merge(){
+        m_merged.clear();
+        for(auto &b : m_buffers) m_merged.insert(m_merged.end(), b.begin(), b.end());
+        std::sort(m_merged.begin(), m_merged.end(), [](const TickEvent& a, const TickEvent& b){ return a.order < b.order; });
+        return m_merged;
+    }
+
+private:
+    std::vector<std::vector<TickEvent>> m_buffers;
+    std::vector<TickEvent> m_merged;
+};
@@ -0,0 +1,23 @@
+// include/world_gen.hpp
+#pragma once
+#include <cstdint>
+#include "world_grid.hpp"
+
+// Procedural asteroid field. Each cell is a pure function of the seed and its position: a
+// large-scale noise field sets how dense an area is (from empty space to asteroid belts) and a
+// small-scale one shapes the asteroids within it, speckled like mined-out rock. All integer
+// math, so any thread, any build and any order produces the same cells.
+struct WorldGenParams {
+    uint32_t seed;
+    int rows, cols;
+    int startR, startC;   // ship start; cells within clearRadius of it are always empty
+    int clearRadius;
+};
+
+// the ship starts 10 columns in, halfway down the map
+WorldGenParams worldgen_default(uint32_t seed, int rows, int cols);
+
+// fills the CHUNK_SIZE x CHUNK_SIZE cells of chunk (cr,cc) row-major (cells outside the map
+// are empty) and returns how many are non-empty. Chunks in empty space return after a few
+// lattice lookups without touching the per-cell noise.
+int worldgen_chunk(const WorldGenParams& p, int cr, int cc, Block* cells);
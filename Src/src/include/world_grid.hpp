@@ -0,0 +1,179 @@
+// include/world_grid.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "blocks.hpp"
+
+struct CellPos { int r, c; };
+
+// Sparse world storage: the map is split into CHUNK_SIZE x CHUNK_SIZE chunks and only chunks
+// holding at least one non-empty cell exist. Chunks come from a slab pool and go back to it
+// when their last block is removed, so memory tracks occupied chunks, not map area.
+// Lookups are one hash probe (open addressing, linear probing) plus an index.
+static const int CHUNK_SHIFT = 5;
+static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+static const int CHUNK_MASK = CHUNK_SIZE - 1;
+
+struct Chunk;
+
+// cells of one chunk written since touched tracking was (re)started, one bit per cell
+struct TouchedChunk { int cr, cc; uint64_t bits[CHUNK_SIZE * CHUNK_SIZE / 64]; };
+
+class WorldGrid {
+public:
+    WorldGrid();
+    ~WorldGrid();
+    WorldGrid(const WorldGrid&) = delete;
+    WorldGrid& operator=(const WorldGrid&) = delete;
+
+    // drop every chunk (they stay pooled) and resize the map
+    void reset(int rows, int cols);
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    bool in_grid(int r, int c) const { return r>=0 && r<m_rows && c>=0 && c<m_cols; }
+
+    // read a cell; cells in absent chunks (or outside the map) read as empty
+    const Block& get(int r, int c) const;
+    // writable cell, or nullptr when its chunk is absent (the cell is empty). Only for hp
+    // edits (set_hp/damage): type changes go through set() so occupancy stays right.
+    Block* find(int r, int c);
+    // write a cell; allocates the chunk on first block, frees it when it empties
+    void set(int r, int c, const Block& b);
+    void clear(int r, int c);
+    // replace this grid with a copy of o (chunks are copied whole; the change list is cleared)
+    void copy_from(const WorldGrid& o);
+    // bulk load: fill(Block* cells) writes every cell of chunk (cr,cc) in row-major order (empty
+    // cells as Block()) straight into chunk memory and returns how many are non-empty. Not
+    // recorded in changes() or the touched set.
+    template<class Fill> void load_chunk(int cr, int cc, Fill fill);
+    // drop chunk (cr,cc) if it exists; its cells read as empty. Not recorded anywhere (world
+    // streaming evicts this way).
+    void unload_chunk(int cr, int cc);
+
+    // occupied-chunk iteration (order is unspecified but stable while no chunk is added/removed)
+    int chunk_count() const { return (int)m_live.size(); }
+    const Chunk& chunk(int i) const { return *m_pool[m_live[i]]; }
+    // calls fn(const Chunk&) for each occupied chunk overlapping rows [r0,r1] x cols [c0,c1]
+    template<class F> void visit_chunks(int r0, int c0, int r1, int c1, F fn) const;
+
+    // cells whose block type changed through set()/clear() since the last clear_changes()
+    // (hp-only damage is not recorded: nothing visible changes)
+    const std::vector<CellPos>& changes() const { return m_changes; }
+    void clear_changes(){ m_changes.clear(); }
+
+    // Touched set: every cell written through set()/clear() or handed out by find() (hp edits)
+    // since track_touched(true). Off by default and after reset(), so generation pays nothing;
+    // delta checkpoints turn it on when they take their base snapshot. Chunks freed since then
+    // stay listed, their cells now read as empty.
+    void track_touched(bool on);
+    bool tracking_touched() const { return m_tracking; }
+    const std::vector<TouchedChunk>& touched() const { return m_touched; }
+
+    // Write journal: cells written through set()/clear() or handed out by find() since the last
+    // clear_written(), repeats included. Off by default; world streaming turns it on to keep
+    // its modification log.
+    void journal_writes(bool on){ m_journaling = on; m_written.clear(); }
+    const std::vector<CellPos>& written() const { return m_written; }
+    void clear_written(){ m_written.clear(); }
+
+    size_t memory_bytes() const;
+
+private:
+    static uint64_t key(int cr, int cc){ return ((uint64_t)(uint32_t)cr << 32) | (uint32_t)cc; }
+    size_t home(uint64_t k) const { return (size_t)((k * 0x9E3779B97F4A7C15ull) >> 20) & m_mask; }
+    int lookup(uint64_t k) const;
+    int alloc_chunk(int cr, int cc, bool clearCells = true);
+    void free_chunk(int idx);
+    void table_insert(uint64_t k, int idx);
+    void table_erase(uint64_t k);
+    void table_grow();
+    void touch(int r, int c);
+
+    int m_rows, m_cols;
+    std::vector<Chunk*> m_pool;      // every chunk ever allocated (slab-owned)
+    std::vector<int> m_free;         // pooled chunk indices not in use
+    std::vector<int> m_live;         // occupied chunk indices, for iteration
+    std::vector<Chunk*> m_slabs;     // backing allocations
+    std::vector<uint64_t> m_keys;    // hash table: chunk key, EMPTY_KEY when unused
+    std::vector<int> m_vals;         // hash table: chunk index
+    size_t m_mask;
+    size_t m_used;
+    std::vector<CellPos> m_changes;
+    bool m_tracking;
+    std::vector<TouchedChunk> m_touched;
+    std::unordered_map<uint64_t, int> m_touchedIndex; // chunk key -> m_touched slot
+    uint64_t m_lastTouchedKey;                        // one-entry cache: writes cluster in a chunk
+    int m_lastTouchedSlot;
+    bool m_journaling;
+    std::vector<CellPos> m_written;
+};
+
+struct Chunk {
+    Block cells[CHUNK_SIZE * CHUNK_SIZE]; // row-major
+    int cr, cc;       // chunk row/col
+    int occupied;     // non-empty cells
+    int liveSlot;     // position in WorldGrid::m_live
+    const Block& at(int lr, int lc) const { return cells[(lr << CHUNK_SHIFT) | lc]; }
+    int row0() const { return cr << CHUNK_SHIFT; }
+    int col0() const { return cc << CHUNK_SHIFT; }
+};
+
+static const uint64_t WORLD_EMPTY_KEY = ~0ull;
+
+inline int WorldGrid::lookup(uint64_t k) const {
+    size_t h = home(k);
+    for(;;){
+        uint64_t kk = m_keys[h];
+        if(kk == k) return m_vals[h];
+        if(kk == WORLD_EMPTY_KEY) return -1;
+        h = (h + 1) & m_mask;
+    }
+}
+
+inline const Block& WorldGrid::get(int r, int c) const {
+    static const Block empty;
+    if(!in_grid(r,c)) return empty;
+    int idx = lookup(key(r >> CHUNK_SHIFT, c >> CHUNK_SHIFT));
+    return idx < 0 ? empty : m_pool[idx]->cells[((r & CHUNK_MASK) << CHUNK_SHIFT) | (c & CHUNK_MASK)];
+}
+
+inline Block* WorldGrid::find(int r, int c){
+    if(!in_grid(r,c)) return nullptr;
+    int idx = lookup(key(r >> CHUNK_SHIFT, c >> CHUNK_SHIFT));
+    if(idx < 0) return nullptr;
+    if(m_tracking) touch(r, c);
+    if(m_journaling){ CellPos p = { r, c }; m_written.push_back(p); }
+    return &m_pool[idx]->cells[((r & CHUNK_MASK) << CHUNK_SHIFT) | (c & CHUNK_MASK)];
+}
+
+template<class Fill> void WorldGrid::load_chunk(int cr, int cc, Fill fill){
+    int idx = lookup(key(cr, cc));
+    if(idx < 0) idx = alloc_chunk(cr, cc, false); // fill() overwrites every cell
+    Chunk &ch = *m_pool[idx];
+    ch.occupied = fill(ch.cells);
+    if(ch.occupied == 0) free_chunk(idx);
+}
+
+template<class F> void WorldGrid::visit_chunks(int r0, int c0, int r1, int c1, F fn) const {
+    if(r0 < 0) r0 = 0;
+    if(c0 < 0) c0 = 0;
+    if(r1 >= m_rows) r1 = m_rows - 1;
+    if(c1 >= m_cols) c1 = m_cols - 1;
+    if(r0 > r1 || c0 > c1) return;
+    int cr0 = r0 >> CHUNK_SHIFT, cr1 = r1 >> CHUNK_SHIFT;
+    int cc0 = c0 >> CHUNK_SHIFT, cc1 = c1 >> CHUNK_SHIFT;
+    // a small window probes the table per chunk; a window wider than the live set just scans it
+    if((long long)(cr1 - cr0 + 1) * (cc1 - cc0 + 1) <= (long long)m_live.size()){
+        for(int cr=cr0; cr<=cr1; cr++) for(int cc=cc0; cc<=cc1; cc++){
+            int idx = lookup(key(cr, cc));
+            if(idx >= 0) fn((const Chunk&)*m_pool[idx]);
+        }
+    } else {
+        for(int idx : m_live){
+            const Chunk &ch = *m_pool[idx];
+            if(ch.cr >= cr0 && ch.cr <= cr1 && ch.cc >= cc0 && ch.cc <= cc1) fn(ch);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+// include/world_stream.hpp
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "world_gen.hpp"
+
+// Lazy world streaming. The world exists only where the ship has been: it is generated per
+// region (REGION_CHUNKS x REGION_CHUNKS chunks) from world_gen as the ship approaches, on
+// background workers when any run, and regions beyond the evict radius are dropped. Every
+// cell written in the world goes into a modification log, so a region comes back exactly as
+// it was left: content is always generator(seed) + log, whenever and wherever it was made.
+//
+// That keeps ticks deterministic without waiting on workers: the cells a tick can touch (a
+// margin around every ship) are made resident before it runs, generated inline in the rare case
+// a worker has not delivered them yet. Prefetch only decides how early the rest shows up, and
+// nothing a tick reads lies outside those margins, so when an install lands never matters.
+static const int REGION_CHUNK_SHIFT = 2;
+static const int REGION_CHUNKS = 1 << REGION_CHUNK_SHIFT;
+static const int REGION_SHIFT = CHUNK_SHIFT + REGION_CHUNK_SHIFT;
+static const int REGION_SIZE = 1 << REGION_SHIFT;   // cells per region side
+static const int STREAM_SIM_MARGIN = 16;            // cells around the ship a tick may read or write
+
+struct RegionPos { int rr, rc; };
+// something that reads the world this tick: every cell within reach of (r,c) is made resident
+struct StreamFocus { int r, c, reach; };
+struct ModCell { int r, c; Block b; };
+
+struct StreamStats {
+    int resident, pending;          // regions in the world / queued or being generated
+    long generatedAsync;            // installed from a worker
+    long generatedInline;           // generated on the ticking thread
+    long stalls;                    // of those, regions a worker had been asked for but not delivered
+    long evicted;
+    size_t modCells;                // cells in the modification log
+};
+
+class WorldStream {
+public:
+    WorldStream();
+    ~WorldStream();
+    WorldStream(const WorldStream&) = delete;
+    WorldStream& operator=(const WorldStream&) = delete;
+
+    // start a new world: w must already be reset to p's size. Nothing is generated here.
+    void reset(WorldGrid& w, const WorldGenParams& p);
+    const WorldGenParams& params() const { return m_params; }
+
+    // Background generation threads; 0 (the default) generates inline, only what ticks need.
+    // Call between ticks.
+    void start_workers(int threads);
+    void stop_workers();
+    int workers() const { return (int)m_threads.size(); }
+    // cells around the ship to generate ahead (workers only) and beyond which regions go
+    void set_radius(int prefetchCells, int evictCells){ m_prefetch = prefetchCells; m_evict = evictCells; }
+
+    // once per tick, before anything reads the world: logs pending writes, installs finished
+    // regions, makes every region within reach cells of (r,c) resident, queues prefetch and
+    // evicts far regions
+    void update(WorldGrid& w, int r, int c, int reach = STREAM_SIM_MARGIN){ StreamFocus f = { r, c, reach }; update(w, &f, 1); }
+    // the same for several foci (the player's ship first, then AI ships): every focus's reach is
+    // made resident. Prefetch and the evict radius are measured from foci[0]; the others only
+    // keep what lies within a region of their reach.
+    void update(WorldGrid& w, const StreamFocus* foci, int count);
+    // folds w.written() into the modification log
+    void record_writes(WorldGrid& w);
+    bool resident(int rr, int rc) const;
+    // what chunk (cr,cc) holds, resident or not: copied from w, or generated plus the log
+    // (writes not recorded yet are only seen in resident regions)
+    void chunk_blocks(const WorldGrid& w, int cr, int cc, Block* cells) const;
+
+    // Non-empty cells that appeared (install) or vanished (eviction) since clear_streamed(),
+    // for renderers that cache the world; only collected when report_streamed(true).
+    void report_streamed(bool on){ m_report = on; m_streamed.clear(); }
+    const std::vector<CellPos>& streamed() const { return m_streamed; }
+    void clear_streamed(){ m_streamed.clear(); }
+
+    // saves: the log including writes not recorded yet (sorted by cell), and the resident set
+    void collect_mods(const WorldGrid& w, std::vector<ModCell>& out) const;
+    void resident_regions(std::vector<RegionPos>& out) const;
+    // full restore: log and resident set replaced, w reset by the caller (the resident regions'
+    // chunks are loaded after this)
+    void restore(WorldGrid& w, const WorldGenParams& p, const std::vector<ModCell>& mods, const std::vector<RegionPos>& resident);
+    // delta restore: log replaced, resident regions not listed are evicted and listed ones
+    // missing here are generated
+    void restore_delta(WorldGrid& w, const std::vector<ModCell>& mods, const std::vector<RegionPos>& resident);
+
+    StreamStats stats() const;
+
+private:
+    enum { ABSENT = 0, PENDING, RESIDENT };
+    struct Region {
+        int rr, rc;
+        int state;
+        std::unordered_map<int, Block> mods; // cell index within the region -> current block
+    };
+    struct Job { int rr, rc; unsigned epoch; WorldGenParams params; };
+    struct Result { int rr, rc; unsigned epoch; std::vector<Block> cells; int occupied[REGION_CHUNKS * REGION_CHUNKS]; };
+
+    static long long key(int rr, int rc){ return ((long long)rr << 32) | (unsigned)rc; }
+    Region& region(int rr, int rc);
+    void require(WorldGrid& w, int rr, int rc);
+    void install(WorldGrid& w, Region& reg, const Block* cells, const int* occupied);
+    void evict(WorldGrid& w, Region& reg);
+    void generate(int rr, int rc, const WorldGenParams& p, Block* cells, int* occupied) const;
+    void worker_main();
+    void drop_jobs();
+
+    WorldGenParams m_params;
+    std::unordered_map<long long, Region> m_regions;
+    std::vector<long long> m_active;       // regions PENDING or RESIDENT, scanned for eviction
+    std::vector<long long> m_held;         // scratch: regions foci past the first keep, sorted
+    std::vector<Block> m_scratch;          // inline generation
+    std::vector<CellPos> m_streamed;
+    bool m_report;
+    int m_prefetch, m_evict;
+    long m_async, m_inline, m_stalls, m_evicted;
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Job> m_jobs;
+    std::vector<Result> m_results;
+    unsigned m_epoch;                      // bumped on reset/restore; older results are dropped
+    bool m_stop;
+};
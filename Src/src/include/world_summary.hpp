@@ -0,0 +1,70 @@
+// include/world_summary.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "framebuffer.hpp"
+#include "world_grid.hpp"
+
+// Mip pyramid of a world's block types for the minimap and zoomed-out views. Level 0 nodes
+// cover 2^base_shift() x 2^base_shift() cells, each level up halves both sides, and the top
+// level is one node over the whole map. Every node counts the blocks of each type under it and
+// keeps the color they blend to (the tile color mixed with each type's registry color by its
+// share of the node's cells, so sparse rock reads dim and solid rock reads as its material).
+// A view at any zoom reads one node color per pixel from the level that matches it instead of
+// rescanning the world. A block type change walks one node per level: O(log map size).
+// The base shift is the smallest that keeps level 0 within SUMMARY_MAX_BASE_NODES, so memory
+// stays bounded on 100k x 100k maps (where level 0 is 256 x 256 cells) and small maps keep
+// fine nodes (2 x 2 cells up to 1024 x 1024 maps).
+static const int SUMMARY_MIN_BASE_SHIFT = 1;
+static const int SUMMARY_MAX_BASE_NODES = 1 << 18;
+static const int SUMMARY_TYPES = BLOCK_TYPE_COUNT - 1; // counted per node: every type but empty
+
+class WorldSummary {
+public:
+    WorldSummary();
+
+    // empty map of this size
+    void reset(int rows, int cols);
+    // recount from scratch: O(occupied chunks x chunk cells + nodes)
+    void build(const WorldGrid& world);
+    // cell (r,c) went from one block type to another; cells outside the map are ignored
+    void change(int r, int c, BlockType from, BlockType to);
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    int levels() const { return (int)m_levels.size(); }
+    int base_shift() const { return m_baseShift; }
+    // level k nodes are 2^level_shift(k) cells on a side
+    int level_shift(int k) const { return m_baseShift + k; }
+    int level_rows(int k) const { return m_levels[k].rows; }
+    int level_cols(int k) const { return m_levels[k].cols; }
+    // per-type block counts of node (nr,nc) of level k, SUMMARY_TYPES of them, BLOCK_ARMOR first
+    const uint32_t* counts(int k, int nr, int nc) const { return &m_levels[k].counts[((size_t)nr * m_levels[k].cols + nc) * SUMMARY_TYPES]; }
+    uint32_t occupied(int k, int nr, int nc) const;
+    // blended 0xRRGGBB of node (nr,nc) of level k
+    uint32_t color(int k, int nr, int nc) const { return m_levels[k].colors[(size_t)nr * m_levels[k].cols + nc]; }
+    const uint32_t* color_row(int k, int nr) const { return &m_levels[k].colors[(size_t)nr * m_levels[k].cols]; }
+    // map cells under node (nr,nc) of level k (less than a full square at the map's far edges)
+    uint32_t area(int k, int nr, int nc) const;
+    // the finest level whose nodes are at least cellsPerPixel cells across, so sampling one
+    // node per pixel skips no cells (the top level if none is that coarse)
+    int level_for(double cellsPerPixel) const;
+
+    size_t memory_bytes() const;
+
+private:
+    struct Level { int rows, cols; std::vector<uint32_t> counts, colors; };
+    void recolor(int k, size_t node);
+    int m_rows, m_cols;
+    int m_baseShift;
+    std::vector<Level> m_levels;
+};
+
+// Draws map cells [r0, r0 + h*cellsPerPixel) x [c0, c0 + w*cellsPerPixel) into the w x h pixels
+// at (x, y) of fb from level sum.level_for(cellsPerPixel), one node color per pixel. Pixels off
+// the map get `outside`. Constant cost per pixel at any zoom and map size; returns the level drawn.
+int world_summary_draw(Framebuffer& fb, const WorldSummary& sum, int x, int y, int w, int h,
+    double r0, double c0, double cellsPerPixel, uint32_t outside);
+// cells per pixel and pixel size that fit the whole map into maxW x maxH keeping its aspect
+double world_summary_fit(const WorldSummary& sum, int maxW, int maxH, int& w, int& h);
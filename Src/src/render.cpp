@@ -1,93 +1,240 @@
 // src/render.cpp
 #include "render.hpp"
-#include "game.hpp"
+#include "draw_list.hpp"
+#include "profiler.hpp"
 #include <string>
 #include <sstream>
+#include <cstring>
+#include <cstdio>
 #include <cmath>
+#include <algorithm>
 
-static double camX = 0, camY = 0;
-static const int GRID_CELL = 24;
+static Camera g_cam;
 static const int HUD_WIDTH = 260;
 
-void render_init(HWND hwnd){ /* nothing yet */ }
-void render_shutdown(){ /* nothing yet */ }
+// World tile cache: the static world around the camera is pre-rasterized into an offscreen
+// bitmap somewhat larger than the view. Each frame only the cells the game reports dirty are
+// redrawn into it and the camera window is blitted out; the whole cache is rebuilt only when
+// the view leaves it or the world is replaced.
+static const int CACHE_COLS = 64;
+static const int CACHE_ROWS = 48;
+static HDC g_cacheDC = nullptr;
+static HBITMAP g_cacheBmp = nullptr, g_cacheOldBmp = nullptr;
+static int g_cacheR0 = 0, g_cacheC0 = 0;
+static bool g_cacheValid = false;
+static unsigned g_cacheGeneration = 0;
+static HBRUSH g_bgBrush = nullptr;
+// one brush per draw-list material, created once; draw lists are submitted material by material
+static HBRUSH g_matBrush[MAT_COUNT];
+static DrawList g_drawList;
+
+// world pass timing, shown in the HUD
+static LARGE_INTEGER g_perfFreq;
+static double g_worldMs = 0;
+static int g_worldCellsDrawn = 0;
+
+// Minimap and map view: rasterized from the world summary into g_mapPixels, then blitted.
+// g_view* are the cells the last world or map pass showed, [r0,r1) x [c0,c1).
+static std::vector<uint32_t> g_mapPixels;
+static double g_viewR0 = 0, g_viewC0 = 0, g_viewR1 = 0, g_viewC1 = 0;
+static const uint32_t SPACE_COLOR = 0x0A0A1C;
+static const int MINIMAP_TOP = 252, MINIMAP_MAX_H = 160;
+
+void render_init(HWND hwnd){
+    QueryPerformanceFrequency(&g_perfFreq);
+    HDC wnd = GetDC(hwnd);
+    g_cacheDC = CreateCompatibleDC(wnd);
+    g_cacheBmp = CreateCompatibleBitmap(wnd, CACHE_COLS*GRID_CELL, CACHE_ROWS*GRID_CELL);
+    g_cacheOldBmp = (HBITMAP)SelectObject(g_cacheDC, g_cacheBmp);
+    ReleaseDC(hwnd, wnd);
+    g_bgBrush = CreateSolidBrush(RGB(10,10,28));
+    for(int m=0;m<MAT_COUNT;m++){
+        uint32_t c = draw_material_color(m);
+        g_matBrush[m] = CreateSolidBrush(RGB((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF));
+    }
+    g_cacheValid = false;
+}
+
+void render_shutdown(){
+    if(g_cacheDC){ SelectObject(g_cacheDC, g_cacheOldBmp); DeleteObject(g_cacheBmp); DeleteDC(g_cacheDC); g_cacheDC = nullptr; }
+    DeleteObject(g_bgBrush);
+    for(int m=0;m<MAT_COUNT;m++) DeleteObject(g_matBrush[m]);
+}
+
+void render_invalidate_cache(){ g_cacheValid = false; }
 
 void render_draw_text(HDC hdc, int x, int y, const char* s, COLORREF color){ SetTextColor(hdc,color); SetBkMode(hdc,TRANSPARENT); TextOutA(hdc,x,y,s,(int)strlen(s)); }
 void render_draw_text(HDC hdc, int x, int y, const std::string &s, COLORREF color){ render_draw_text(hdc,x,y,s.c_str(),color); }
 
-void render_draw_world(HDC hdc){
+// submit a sorted draw list: each material's items go out back to back with its one brush
+static void submitDrawList(HDC hdc, const DrawList &dl){
+    for(int m=0;m<MAT_COUNT;m++){
+        if(dl.batchStart[m] == dl.batchStart[m+1]) continue;
+        HBRUSH br = g_matBrush[m];
+        HBRUSH oldb = (HBRUSH)SelectObject(hdc, br);
+        for(int i=dl.batchStart[m]; i<dl.batchStart[m+1]; i++){
+            const DrawItem &it = dl.items[i];
+            RECT rr = {it.x0, it.y0, it.x1, it.y1};
+            if(it.shape == SHAPE_RECT) FillRect(hdc, &rr, br);
+            else if(it.shape == SHAPE_FRAME) FrameRect(hdc, &rr, br);
+            else { POINT pts[3] = {{it.x0, it.y0}, {it.x1, it.y1}, {it.x2, it.y2}}; Polygon(hdc, pts, 3); }
+        }
+        SelectObject(hdc, oldb);
+    }
+}
+
+static void drawCacheBlock(int sx, int sy, const Block &b){
+    if(b.empty()) return;
+    HBRUSH br = g_matBrush[draw_block_material(b.type())];
+    RECT cellR = {sx, sy, sx+GRID_CELL, sy+GRID_CELL};
+    FrameRect(g_cacheDC, &cellR, br);
+    RECT inner = {sx+3, sy+3, sx+GRID_CELL-3, sy+GRID_CELL-3};
+    FillRect(g_cacheDC, &inner, br);
+}
+
+static void drawCacheCell(const WorldGrid &world, int r, int c){
+    int sx = (c - g_cacheC0) * GRID_CELL, sy = (r - g_cacheR0) * GRID_CELL;
+    RECT cellR = {sx, sy, sx+GRID_CELL, sy+GRID_CELL};
+    if(!world.in_grid(r,c)){ FillRect(g_cacheDC, &cellR, g_bgBrush); return; }
+    FillRect(g_cacheDC, &cellR, g_matBrush[MAT_TILE]);
+    drawCacheBlock(sx, sy, world.get(r,c));
+}
+
+// re-center the cache on the view and rasterize it from scratch
+static void rebuildCache(const WorldGrid &world, int vr0, int vc0, int vr1, int vc1){
+    g_cacheC0 = vc0 - (CACHE_COLS - (vc1 - vc0 + 1)) / 2;
+    g_cacheR0 = vr0 - (CACHE_ROWS - (vr1 - vr0 + 1)) / 2;
+    int r1 = g_cacheR0 + CACHE_ROWS - 1, c1 = g_cacheC0 + CACHE_COLS - 1;
+    RECT all = {0, 0, CACHE_COLS*GRID_CELL, CACHE_ROWS*GRID_CELL};
+    FillRect(g_cacheDC, &all, g_bgBrush);
+    // empty tiles are one solid color, so the in-world part is a single fill
+    int tr0 = std::max(g_cacheR0, 0), tc0 = std::max(g_cacheC0, 0);
+    int tr1 = std::min(r1, world.rows()-1), tc1 = std::min(c1, world.cols()-1);
+    if(tr0 <= tr1 && tc0 <= tc1){
+        RECT tiles = {(tc0-g_cacheC0)*GRID_CELL, (tr0-g_cacheR0)*GRID_CELL, (tc1-g_cacheC0+1)*GRID_CELL, (tr1-g_cacheR0+1)*GRID_CELL};
+        FillRect(g_cacheDC, &tiles, g_matBrush[MAT_TILE]);
+    }
+    g_drawList.clear();
+    draw_list_add_cells(g_drawList, world, g_cacheR0, g_cacheC0, r1, c1, g_cacheC0*GRID_CELL, g_cacheR0*GRID_CELL);
+    draw_list_sort(g_drawList);
+    submitDrawList(g_cacheDC, g_drawList);
+    g_worldCellsDrawn += g_drawList.cells;
+    g_cacheValid = true;
+    g_cacheGeneration = sim_view_generation();
+}
+
+void render_draw_world(HDC hdc, double alpha){
+    PROFILE_ZONE("render_world");
+    LARGE_INTEGER t0, t1; QueryPerformanceCounter(&t0);
     // camera follow player
-    double pwx, pwy; game_get_player_pos(pwx, pwy);
+    const SimSnapshot &snap = sim_view();
+    double pwx, pwy; snapshot_ship_lerp(snap, alpha, pwx, pwy);
     int window_w = game_get_window_width();
     int window_h = game_get_window_height();
+    g_cam.viewW = window_w - HUD_WIDTH;
+    g_cam.viewH = window_h;
+    camera_follow(g_cam, pwx, pwy);
 
-    double targetCamX = pwx - (window_w - HUD_WIDTH)/2.0;
-    double targetCamY = pwy - window_h/2.0;
-    camX += (targetCamX - camX) * 0.12;
-    camY += (targetCamY - camY) * 0.12;
-
-    RECT rc; rc.left=0; rc.top=0; rc.right=window_w-HUD_WIDTH; rc.bottom=window_h;
-    HBRUSH bg = CreateSolidBrush(RGB(10,10,28));
-    FillRect(hdc, &rc, bg); DeleteObject(bg);
-
-    const int WORLD_COLS = game_world_cols();
-    const int WORLD_ROWS = game_world_rows();
-
-    const Block* worldPtr = game_get_world_ptr();
-    for(int r=0;r<WORLD_ROWS;r++){
-        for(int c=0;c<WORLD_COLS;c++){
-            int sx = (int)(c*GRID_CELL - camX);
-            int sy = (int)(r*GRID_CELL - camY);
-            RECT cellR = {sx, sy, sx+GRID_CELL, sy+GRID_CELL};
-            HBRUSH tileBrush = CreateSolidBrush(RGB(14,14,24));
-            FillRect(hdc, &cellR, tileBrush);
-            DeleteObject(tileBrush);
-            const Block &b = worldPtr[r*WORLD_COLS + c];
-            if(b.type != BLOCK_EMPTY){
-                HBRUSH br;
-                switch(b.type){
-                    case BLOCK_ARMOR: br = CreateSolidBrush(RGB(120,110,80)); break;
-                    case BLOCK_THRUSTER: br = CreateSolidBrush(RGB(180,60,40)); break;
-                    case BLOCK_MINER: br = CreateSolidBrush(RGB(100,180,200)); break;
-                    default: br = CreateSolidBrush(RGB(180,180,180)); break;
-                }
-                FrameRect(hdc, &cellR, br);
-                RECT inner = {sx+3, sy+3, sx+GRID_CELL-3, sy+GRID_CELL-3};
-                FillRect(hdc, &inner, br);
-                DeleteObject(br);
+    const WorldGrid &world = sim_view_world();
+    int viewW = g_cam.viewW;
+    int ox = camera_ox(g_cam), oy = camera_oy(g_cam);
+    int vr0, vc0, vr1, vc1;
+    camera_visible_cells(g_cam, GRID_CELL, vr0, vc0, vr1, vc1);
+
+    g_worldCellsDrawn = 0;
+    {
+        PROFILE_ZONE("world_cache");
+        bool inside = vc0 >= g_cacheC0 && vr0 >= g_cacheR0 && vc1 < g_cacheC0 + CACHE_COLS && vr1 < g_cacheR0 + CACHE_ROWS;
+        if(!g_cacheValid || !inside || g_cacheGeneration != sim_view_generation()){
+            rebuildCache(world, vr0, vc0, vr1, vc1);
+        } else {
+            for(const CellPos &p : sim_view_dirty_cells()){
+                if(p.r < g_cacheR0 || p.r >= g_cacheR0 + CACHE_ROWS || p.c < g_cacheC0 || p.c >= g_cacheC0 + CACHE_COLS) continue;
+                drawCacheCell(world, p.r, p.c);
+                g_worldCellsDrawn++;
             }
         }
+        sim_view_clear_dirty_cells();
+    }
+    {
+        PROFILE_ZONE("world_blit");
+        BitBlt(hdc, 0, 0, viewW, window_h, g_cacheDC, ox - g_cacheC0*GRID_CELL, oy - g_cacheR0*GRID_CELL, SRCCOPY);
     }
 
-    // draw ship blocks (simple)
-    double sxp, syp; game_get_player_pos(sxp,syp);
-    double angled = game_get_player_angle();
-    // we don't have the ship block offsets here (they are internal), so render player as small ship icon
-    int sx = (int)(sxp - camX);
-    int sy = (int)(syp - camY);
-    POINT pts[3];
-    pts[0].x = sx; pts[0].y = sy - 12;
-    pts[1].x = sx - 10; pts[1].y = sy + 12;
-    pts[2].x = sx + 10; pts[2].y = sy + 12;
-    HBRUSH sb = CreateSolidBrush(RGB(220,200,60));
-    HBRUSH oldb = (HBRUSH)SelectObject(hdc, sb);
+    g_viewR0 = (double)oy / GRID_CELL; g_viewC0 = (double)ox / GRID_CELL;
+    g_viewR1 = (double)(oy + window_h) / GRID_CELL; g_viewC1 = (double)(ox + viewW) / GRID_CELL;
+
+    QueryPerformanceCounter(&t1);
+    double ms = (double)(t1.QuadPart - t0.QuadPart) * 1000.0 / (double)g_perfFreq.QuadPart;
+    g_worldMs += (ms - g_worldMs) * 0.1;
+
+    // ship and on-screen drones: culled against the view, one brush per material
+    PROFILE_ZONE("entities");
+    g_drawList.clear();
+    draw_list_add_entities(g_drawList, g_cam, snap, alpha);
+    draw_list_sort(g_drawList);
+    submitDrawList(hdc, g_drawList);
+}
+
+// rasterize w x h pixels of the summary into g_mapPixels and copy them to (x,y)
+static int blitSummary(HDC hdc, int x, int y, int w, int h, double r0, double c0, double cellsPerPixel){
+    g_mapPixels.resize((size_t)w * h);
+    Framebuffer fb = { g_mapPixels.data(), w, h, w };
+    int level = world_summary_draw(fb, sim_view_summary(), 0, 0, w, h, r0, c0, cellsPerPixel, SPACE_COLOR);
+    BITMAPINFO bi; ZeroMemory(&bi, sizeof(bi));
+    bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bi.bmiHeader.biWidth = w;
+    bi.bmiHeader.biHeight = -h; // top-down
+    bi.bmiHeader.biPlanes = 1;
+    bi.bmiHeader.biBitCount = 32;
+    bi.bmiHeader.biCompression = BI_RGB;
+    SetDIBitsToDevice(hdc, x, y, w, h, 0, 0, 0, h, g_mapPixels.data(), &bi, DIB_RGB_COLORS);
+    return level;
+}
+
+void render_draw_map(HDC hdc, double cellsPerPixel, double alpha){
+    PROFILE_ZONE("render_map");
+    // the tile cache misses the changes skipped here; rebuild it when the world view is back
+    sim_view_clear_dirty_cells();
+    g_cacheValid = false;
+    const SimSnapshot &snap = sim_view();
+    double pwx, pwy; snapshot_ship_lerp(snap, alpha, pwx, pwy);
+    int viewW = game_get_window_width() - HUD_WIDTH, viewH = game_get_window_height();
+    g_viewC0 = pwx / GRID_CELL - viewW / 2.0 * cellsPerPixel;
+    g_viewR0 = pwy / GRID_CELL - viewH / 2.0 * cellsPerPixel;
+    g_viewC1 = g_viewC0 + viewW * cellsPerPixel; g_viewR1 = g_viewR0 + viewH * cellsPerPixel;
+    int level = blitSummary(hdc, 0, 0, viewW, viewH, g_viewR0, g_viewC0, cellsPerPixel);
+
+    int sx = viewW / 2, sy = viewH / 2;
+    HBRUSH oldb = (HBRUSH)SelectObject(hdc, g_matBrush[MAT_SHIP]);
+    POINT pts[3] = {{sx, sy - 6}, {sx - 5, sy + 6}, {sx + 5, sy + 6}};
     Polygon(hdc, pts, 3);
     SelectObject(hdc, oldb);
-    DeleteObject(sb);
-
-    // draw drones
-    const std::vector<Drone> &drones = game_get_drones();
-    for(const auto &d: drones){
-        int dx = (int)(d.x - camX);
-        int dy = (int)(d.y - camY);
-        HBRUSH db = CreateSolidBrush(RGB(180,80,90));
-        RECT rr = {dx-8, dy-8, dx+8, dy+8};
-        FillRect(hdc, &rr, db);
-        DeleteObject(db);
-    }
+    char line[64];
+    snprintf(line, sizeof(line), "Map: %g cells/px, level %d", cellsPerPixel, level);
+    render_draw_text(hdc, 12, 12, line, RGB(170,170,200));
+}
+
+// the whole map from the summary, framed where the view is, with the ship as a dot
+static int drawMinimap(HDC hdc, int x, int y, int maxW){
+    int w, h;
+    double cpp = world_summary_fit(sim_view_summary(), maxW, MINIMAP_MAX_H, w, h);
+    if(w <= 0 || h <= 0) return 0;
+    blitSummary(hdc, x, y, w, h, 0, 0, cpp);
+    // overlays are clamped to the minimap
+    RECT vr = {std::max(x, x + (int)floor(g_viewC0 / cpp)), std::max(y, y + (int)floor(g_viewR0 / cpp)),
+        std::min(x + w, x + (int)ceil(g_viewC1 / cpp)), std::min(y + h, y + (int)ceil(g_viewR1 / cpp))};
+    HBRUSH frame = CreateSolidBrush(RGB(200,200,230));
+    if(vr.left < vr.right && vr.top < vr.bottom) FrameRect(hdc, &vr, frame);
+    DeleteObject(frame);
+    int sx = x + (int)(sim_view().shipX / GRID_CELL / cpp), sy = y + (int)(sim_view().shipY / GRID_CELL / cpp);
+    RECT ship = {std::max(x, sx - 1), std::max(y, sy - 1), std::min(x + w, sx + 2), std::min(y + h, sy + 2)};
+    FillRect(hdc, &ship, g_matBrush[MAT_SHIP]);
+    return h;
 }
 
 void render_draw_hud(HDC hdc){
+    PROFILE_ZONE("render_hud");
     int left = game_get_window_width() - HUD_WIDTH;
     RECT r = {left,0,left+HUD_WIDTH, game_get_window_height()};
     HBRUSH bg = CreateSolidBrush(RGB(25,25,40));
@@ -97,10 +244,10 @@ void render_draw_hud(HDC hdc){
     ss << "SPACE ENGINEERS LITE (Mobile Demo)";
     render_draw_text(hdc,left+12,12, ss.str());
     ss.str(""); ss.clear();
-    ss << "Resources: " << game_get_resources();
+    ss << "Resources: " << sim_view().resources;
     render_draw_text(hdc,left+12,44, ss.str());
     ss.str(""); ss.clear();
-    ss << "Score: " << game_get_score();
+    ss << "Score: " << sim_view().score;
     render_draw_text(hdc,left+12,68, ss.str());
 
     render_draw_text(hdc,left+12,110, "Build Palette:");
@@ -115,6 +262,30 @@ void render_draw_hud(HDC hdc){
     RECT r3 = {left+12, 220, left+12+24, 220+24};
     HBRUSH b3 = CreateSolidBrush(RGB(80,160,200)); FillRect(hdc,&r3,b3); DeleteObject(b3);
     render_draw_text(hdc,left+12+24+8,230, "3 - Miner (10 res)");
+
+    int mapH = drawMinimap(hdc, left+12, MINIMAP_TOP, HUD_WIDTH - 24);
+
+    // live zone timings (profiled builds only)
+    char perf[64];
+    const std::vector<ProfileZoneStats> &zones = profiler_rolling_stats();
+    if(!zones.empty()){
+        render_draw_text(hdc,left+12,MINIMAP_TOP + mapH + 14, "Zone            p50 / p99 ms", RGB(170,170,200));
+        int y = MINIMAP_TOP + mapH + 34;
+        for(const ProfileZoneStats &z : zones){
+            if(y > game_get_window_height() - 110) break;
+            snprintf(perf, sizeof(perf), "%-14.14s %6.3f %7.3f", z.name, z.p50Ms, z.p99Ms);
+            render_draw_text(hdc,left+12,y, perf, RGB(140,140,170));
+            y += 18;
+        }
+    }
+
+    snprintf(perf, sizeof(perf), "World: %.3f ms (%d cells)", g_worldMs, g_worldCellsDrawn);
+    render_draw_text(hdc,left+12,game_get_window_height()-60, perf, RGB(140,140,170));
+    const InputLatencyStats &lat = sim_view_input_latency();
+    if(lat.count > 0){
+        snprintf(perf, sizeof(perf), "Input: %.1f / %.1f ms p50/p99", lat.p50Ms, lat.p99Ms);
+        render_draw_text(hdc,left+12,game_get_window_height()-80, perf, RGB(140,140,170));
+    }
 }
 
 static POINT joystickCenter = {120, 720 - 120};
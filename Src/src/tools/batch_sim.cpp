@@ -0,0 +1,81 @@
+// tools/batch_sim.cpp
+// Batch simulator: runs many independent seeded sessions on a work-stealing pool and prints
+// per-session results (CSV) plus throughput. With --scaling it repeats the batch at 1..N
+// threads and reports speedup.
+//   batch_sim [sessions=2000] [maxTicks=3600] [threads=0] [--csv file] [--scaling]
+#include "batch.hpp"
+#include "thread_pool.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static Vec2 scriptedThrust(int tick, void*){
+    double t = tick / 60.0;
+    return Vec2(cos(t * 0.35), sin(t * 0.21));
+}
+
+static double runBatch(int threads, const BatchConfig &cfg, std::vector<BatchResult> &results){
+    ThreadPool pool(threads);
+    typedef std::chrono::steady_clock clk;
+    clk::time_point t0 = clk::now();
+    batch_run(pool, cfg, results);
+    return std::chrono::duration<double>(clk::now() - t0).count();
+}
+
+int main(int argc, char** argv){
+    BatchConfig cfg;
+    cfg.sessions = 2000; cfg.maxTicks = 60*60; cfg.input = scriptedThrust;
+    int threads = 0;
+    const char* csvPath = nullptr;
+    bool scaling = false;
+    int positional = 0;
+    for(int i=1;i<argc;i++){
+        if(!strcmp(argv[i], "--csv") && i+1 < argc) csvPath = argv[++i];
+        else if(!strcmp(argv[i], "--scaling")) scaling = true;
+        else if(positional == 0){ cfg.sessions = atoi(argv[i]); positional++; }
+        else if(positional == 1){ cfg.maxTicks = atoi(argv[i]); positional++; }
+        else if(positional == 2){ threads = atoi(argv[i]); positional++; }
+    }
+    if(threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if(threads <= 0) threads = 1;
+
+    std::vector<BatchResult> results;
+    if(scaling){
+        // powers of two below the thread count, then always the full count
+        double base = 0;
+        for(int t=1;t<threads;t*=2){
+            double secs = runBatch(t, cfg, results);
+            if(t == 1) base = secs;
+            printf("threads %3d: %.3f s  %.0f sessions/s  speedup %.2fx\n", t, secs, cfg.sessions / secs, base / secs);
+        }
+        double secs = runBatch(threads, cfg, results);
+        if(threads == 1) base = secs;
+        printf("threads %3d: %.3f s  %.0f sessions/s  speedup %.2fx\n", threads, secs, cfg.sessions / secs, base / secs);
+    } else {
+        double secs = runBatch(threads, cfg, results);
+        long long ticks = 0;
+        for(auto &r : results) ticks += r.ticks;
+        printf("sessions: %d  threads: %d  wall: %.3f s\n", cfg.sessions, threads, secs);
+        printf("%.0f sessions/s  %.0f ticks/s\n", cfg.sessions / secs, ticks / secs);
+    }
+
+    int counts[3] = {0,0,0};
+    long long scoreSum = 0, resSum = 0;
+    for(auto &r : results){ counts[r.outcome]++; scoreSum += r.score; resSum += r.resources; }
+    if(!results.empty())
+        printf("outcomes: won %d  lost %d  timeout %d  mean score %.1f  mean resources %.1f\n",
+            counts[OUTCOME_WON], counts[OUTCOME_LOST], counts[OUTCOME_TIMEOUT],
+            (double)scoreSum / results.size(), (double)resSum / results.size());
+
+    if(csvPath){
+        FILE* f = fopen(csvPath, "w");
+        if(!f){ fprintf(stderr, "cannot write %s\n", csvPath); return 1; }
+        fprintf(f, "seed,ticks,score,resources,drones,outcome\n");
+        for(auto &r : results)
+            fprintf(f, "%u,%d,%d,%d,%d,%s\n", r.seed, r.ticks, r.score, r.resources, r.drones, batch_outcome_name(r.outcome));
+        fclose(f);
+    }
+    return 0;
+}
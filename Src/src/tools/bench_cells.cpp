@@ -0,0 +1,128 @@
+// tools/bench_cells.cpp
+// Packed cell benchmark. The world holds 16-bit cells (blocks.hpp); this compares them with
+// the previous 8-byte {BlockType, int hp} layout, rebuilt here from the same cells:
+//  1. full-grid sweep: every cell of every resident chunk read once (solid count and hp sum),
+//     for growing resident areas until the old layout no longer fits in cache
+//  2. whole-world copy (the render mirror's sync) per layout
+//  3. mining throughput: a resting ship of n miners all over rock, so every miner hits every
+//     tick; cells broken and the mining + apply phases per tick
+//   bench_cells [sweeps=20] [seed=1]
+#include "game.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+struct WideBlock { BlockType type; int hp; }; // the layout before packing
+static_assert(sizeof(WideBlock) == 8, "old cell layout");
+
+static const int MAP = 100000;
+
+// a session whose resident world is a side x side square of rock around the ship
+static Session* rockSession(uint32_t seed, int side, int percent){
+    Session *s = new Session();
+    session_reset(*s, seed, MAP, MAP);
+    int r0 = MAP / 2, c0 = MAP / 2;
+    s->ships.x[PLAYER_SHIP] = c0 * GRID_CELL + GRID_CELL / 2; s->ships.y[PLAYER_SHIP] = r0 * GRID_CELL + GRID_CELL / 2;
+    s->ships.prevX[PLAYER_SHIP] = s->ships.x[PLAYER_SHIP]; s->ships.prevY[PLAYER_SHIP] = s->ships.y[PLAYER_SHIP];
+    s->ships.coreR[PLAYER_SHIP] = r0; s->ships.coreC[PLAYER_SHIP] = c0;
+    s->stream.update(s->world, r0, c0, side / 2 + CHUNK_SIZE);
+    Rng rng(seed);
+    for(int r=r0-side/2;r<r0+side/2;r++) for(int c=c0-side/2;c<c0+side/2;c++){
+        if(rng.range(100) < percent) s->world.set(r, c, Block(BLOCK_ARMOR, 20 + rng.range(60)));
+        else s->world.clear(r, c);
+    }
+    s->stream.record_writes(s->world);
+    s->world.clear_changes();
+    return s;
+}
+
+int main(int argc, char** argv){
+    int sweeps = argc > 1 ? atoi(argv[1]) : 20;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    const int CELLS = CHUNK_SIZE * CHUNK_SIZE;
+    bool ok = true;
+
+    printf("full-grid sweep and copy, 16-bit cells vs the old 8-byte cells (%d sweeps each):\n", sweeps);
+    const int sides[] = { 256, 1024, 2048, 4096 };
+    for(int side : sides){
+        Session *s = rockSession(seed, side, 40);
+        const WorldGrid &w = s->world;
+        int chunks = w.chunk_count();
+        std::vector<WideBlock> wide((size_t)chunks * CELLS);
+        for(int i=0;i<chunks;i++) for(int k=0;k<CELLS;k++){
+            const Block &b = w.chunk(i).cells[k];
+            wide[(size_t)i * CELLS + k].type = b.type(); wide[(size_t)i * CELLS + k].hp = b.hp();
+        }
+        long cells = (long)chunks * CELLS;
+
+        long solidP = 0, hpP = 0;
+        clk::time_point t0 = clk::now();
+        for(int n=0;n<sweeps;n++) for(int i=0;i<chunks;i++){
+            const Block *c = w.chunk(i).cells;
+            for(int k=0;k<CELLS;k++){ solidP += !c[k].empty(); hpP += c[k].hp(); }
+        }
+        double packedNs = since(t0) * 1e9 / ((double)sweeps * cells);
+        long solidW = 0, hpW = 0;
+        t0 = clk::now();
+        for(int n=0;n<sweeps;n++) for(size_t k=0;k<wide.size();k++){ solidW += wide[k].type != BLOCK_EMPTY; hpW += wide[k].hp; }
+        double wideNs = since(t0) * 1e9 / ((double)sweeps * cells);
+        if(solidP != solidW || hpP != hpW) ok = false;
+
+        WorldGrid *copy = new WorldGrid();
+        copy->copy_from(w); // chunk slabs allocated outside the timing
+        t0 = clk::now();
+        for(int n=0;n<sweeps;n++) copy->copy_from(w);
+        double copyMs = since(t0) * 1e3 / sweeps;
+        std::vector<WideBlock> wideCopy(wide);
+        t0 = clk::now();
+        for(int n=0;n<sweeps;n++) memcpy(wideCopy.data(), wide.data(), wide.size() * sizeof(WideBlock));
+        double wideCopyMs = since(t0) * 1e3 / sweeps;
+        delete copy;
+
+        printf("  %4d x %-4d  %6.1f MB vs %6.1f MB  sweep %5.2f vs %5.2f ns/cell (%.1fx)  copy %7.2f vs %7.2f ms%s\n",
+            side, side, cells * sizeof(Block) / 1048576.0, cells * sizeof(WideBlock) / 1048576.0,
+            packedNs, wideNs, wideNs / packedNs, copyMs, wideCopyMs, solidP == solidW && hpP == hpW ? "" : "  SUMS DIFFER");
+        delete s;
+    }
+
+    printf("mining throughput, a resting ship whose every miner sits on rock (broken rock refilled after each tick), 240 ticks:\n");
+    const int miners[] = { 16, 256, 4096 };
+    for(int n : miners){
+        Session *s = rockSession(seed, 512, 100);
+        ShipStore &sh = s->ships;
+        const int P = PLAYER_SHIP;
+        int side = (int)ceil(sqrt((double)n)), half = side / 2;
+        sh.grid[P].clear(); sh.grid[P].reserve(n + 1);
+        sh.grid[P].add(-half - 1, 0, BLOCK_CORE);
+        for(int r=-half;r<side-half && (int)sh.grid[P].miners().size()<n;r++)
+            for(int c=-half;c<side-half && (int)sh.grid[P].miners().size()<n;c++) sh.grid[P].add(r, c, BLOCK_MINER);
+        sh.grid[P].update_transforms(sh.x[P], sh.y[P], sh.angle[P], GRID_CELL);
+        s->drones.clear();
+        uint64_t phaseNs[PHASE_COUNT] = {0};
+        const int ticks = 240;
+        long mined = 0;
+        for(int t=0;t<ticks;t++){
+            // a big ship mines the 300 resources that win the game in one tick
+            sh.vx[P] = 0; sh.vy[P] = 0; sh.angVel[P] = 0;
+            s->resources = 0; s->gameOver = false; s->paused = false;
+            session_update_timed(*s, phaseNs);
+            std::vector<CellPos> broken(s->world.changes());
+            mined += (long)broken.size();
+            for(const CellPos &p : broken) s->world.set(p.r, p.c, Block(BLOCK_ARMOR, 20 + (p.r * 7 + p.c) % 60));
+            s->stream.record_writes(s->world);
+            s->world.clear_changes();
+        }
+        double ns = (double)(phaseNs[PHASE_MINING] + phaseNs[PHASE_APPLY]) / ticks;
+        int m = (int)sh.grid[P].miners().size();
+        printf("  %5d miners: %7ld cells broken  mining+apply %9.0f ns/tick (%5.1f ns/miner hit)  %6.2f M miner hits/s\n",
+            m, mined, ns, ns / m, m / ns * 1e3);
+        delete s;
+    }
+    return ok ? 0 : 1;
+}
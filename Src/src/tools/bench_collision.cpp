@@ -0,0 +1,130 @@
+// tools/bench_collision.cpp
+// Swept ship-vs-grid collision check and benchmark:
+//  1. walls one cell thick, hit head-on at 6 to 4000 px/tick: the ship must stop in front
+//     every time (sampling only block centers after each tick misses the wall once a block
+//     moves more than a cell per tick)
+//  2. a ship nudged against a wall and left alone: the contact resolves once instead of
+//     firing every tick while the blocks overlap
+//  3. cost per tick in a dense random field (half the cells solid) by speed and ship size
+//   bench_collision [ticks=2000] [seed=1]
+#include "game.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static const int MAP_ROWS = 400, MAP_COLS = 40000;
+static const int WALL_HP = BLOCK_HP_MAX;
+
+// makes the area resident and writes it (writes go through the stream's modification log)
+static void fillBox(Session& s, int r0, int c0, int r1, int c1, int percent, Rng& rng){
+    s.stream.update(s.world, (r0 + r1) / 2, (c0 + c1) / 2, std::max(r1 - r0, c1 - c0) / 2 + 1);
+    Block wall(BLOCK_ARMOR, WALL_HP);
+    for(int r=r0;r<=r1;r++) for(int c=c0;c<=c1;c++){
+        if(percent > 0 && rng.range(100) < percent) s.world.set(r, c, wall);
+        else s.world.clear(r, c);
+    }
+}
+
+static void fly(Session& s, double vx, double vy){
+    s.ships.vx[PLAYER_SHIP] = vx; s.ships.vy[PLAYER_SHIP] = vy;
+    s.resources = 0;
+    session_update(s);
+}
+
+// largest x any block reached, over ticks of flying at speed toward +x
+static double wallRun(uint32_t seed, double speed, int wallC, int ticks){
+    Session *s = new Session();
+    session_reset(*s, seed, MAP_ROWS, MAP_COLS);
+    Rng rng(seed);
+    int r0 = s->ships.coreR[PLAYER_SHIP];
+    fillBox(*s, r0 - 20, 0, r0 + 20, wallC - 1, 0, rng);
+    fillBox(*s, r0 - 20, wallC, r0 + 20, wallC, 100, rng);
+    double maxX = 0;
+    for(int i=0;i<ticks;i++){
+        fly(*s, speed, 0);
+        const ShipGrid &g = s->ships.grid[PLAYER_SHIP];
+        for(int b=0;b<g.size();b++) maxX = std::max(maxX, g.world_x(b));
+    }
+    delete s;
+    return maxX;
+}
+
+// would sampling block centers after each tick ever land in the wall? (the old test)
+static bool pointSamplingHits(double startX, double speed, int wallC){
+    for(double x=startX; x < (wallC + 2) * GRID_CELL; x += speed)
+        if((int)(x / GRID_CELL) == wallC) return true;
+    return false;
+}
+
+int main(int argc, char** argv){
+    int ticks = argc > 1 ? atoi(argv[1]) : 2000;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    bool ok = true;
+
+    printf("head-on into a one-cell wall:\n");
+    const double speeds[] = { 6, 20, 30, 100, 500, 4000 };
+    for(double v : speeds){
+        int wallC = 60 + (int)(v * 3 / GRID_CELL);
+        double maxX = wallRun(seed, v, wallC, 30);
+        double frontX = 11.5 * GRID_CELL;  // front blocks at the start, for the old-test estimate
+        bool stopped = maxX < wallC * GRID_CELL;
+        printf("  %6.0f px/tick: swept %-8s  center sampling would %s\n", v, stopped ? "stopped" : "TUNNELED",
+            pointSamplingHits(frontX, v, wallC) ? "hit" : "tunnel");
+        if(!stopped) ok = false;
+    }
+
+    {
+        Session *s = new Session();
+        session_reset(*s, seed, MAP_ROWS, MAP_COLS);
+        Rng rng(seed);
+        int r0 = s->ships.coreR[PLAYER_SHIP], wallC = s->ships.coreC[PLAYER_SHIP] + 4;
+        fillBox(*s, r0 - 20, 0, r0 + 20, wallC - 1, 0, rng);
+        fillBox(*s, r0 - 20, wallC, r0 + 20, wallC, 100, rng);
+        fly(*s, 30, 0);
+        int resolved = 0;
+        for(int i=0;i<600;i++){
+            int before = 0, after = 0;
+            for(int r=r0-20;r<=r0+20;r++) before += WALL_HP - s->world.get(r, wallC).hp();
+            s->resources = 0;
+            session_update(*s);
+            for(int r=r0-20;r<=r0+20;r++) after += WALL_HP - s->world.get(r, wallC).hp();
+            if(after != before) resolved++;
+        }
+        printf("nudged into a wall, then 600 ticks coasting: %d tick%s resolved a contact\n",
+            resolved, resolved == 1 ? "" : "s");
+        if(resolved != 1) ok = false;
+        delete s;
+    }
+
+    printf("dense field (50%% solid), ns per collision phase:\n");
+    const double fieldSpeeds[] = { 4, 24, 100, 400 };
+    const int blocks[] = { 6, 400 };
+    for(int n : blocks){
+        for(double v : fieldSpeeds){
+            Session *s = new Session();
+            session_reset(*s, seed, MAP_ROWS, MAP_COLS);
+            if(n > 6){
+                ShipGrid &g = s->ships.grid[PLAYER_SHIP];
+                g.clear(); g.add(0, 0, BLOCK_CORE, 100);
+                for(int r=-10;r<10;r++) for(int c=-10;c<10;c++) g.add(r, c, r == -10 ? BLOCK_MINER : BLOCK_ARMOR, 60);
+                g.update_transforms(s->ships.x[PLAYER_SHIP], s->ships.y[PLAYER_SHIP], s->ships.angle[PLAYER_SHIP], GRID_CELL);
+            }
+            Rng rng(seed);
+            int r0 = s->ships.coreR[PLAYER_SHIP], c0 = s->ships.coreC[PLAYER_SHIP];
+            fillBox(*s, r0 - 150, c0 - 10, r0 + 150, c0 + 290, 50, rng);
+            fillBox(*s, r0 - 15, c0 - 10, r0 + 15, c0 + 15, 0, rng);
+            uint64_t phaseNs[PHASE_COUNT] = {0};
+            int done = 0;
+            for(int i=0;i<ticks && !s->gameOver;i++,done++){
+                double a = rng.range(6283) * 0.001;
+                s->ships.vx[PLAYER_SHIP] = cos(a) * v; s->ships.vy[PLAYER_SHIP] = sin(a) * v;
+                s->resources = 0;
+                session_update_timed(*s, phaseNs);
+            }
+            printf("  %4d blocks %5.0f px/tick: %8.0f ns/tick\n", s->ships.grid[PLAYER_SHIP].size(), v, (double)phaseNs[PHASE_COLLISIONS] / done);
+            delete s;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+// tools/bench_draw_list.cpp
+// Draw-list benchmark: builds the culled, material-sorted draw list for a fixed 1020x720 view
+// on maps from 80x50 up to 100k x 100k with drones scattered over the whole map, and reports
+// build cost and item counts. Cost should follow what is on screen, not map or drone count.
+//   bench_draw_list [frames=2000] [seed=1]
+#include "draw_list.hpp"
+#include "sim_thread.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+int main(int argc, char** argv){
+    int frames = argc > 1 ? atoi(argv[1]) : 2000;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    const int sizes[][2] = { {WORLD_ROWS, WORLD_COLS}, {1000, 1000}, {10000, 10000}, {100000, 100000} };
+
+    Session &s = game_session();
+    DrawList dl;
+    for(auto &sz : sizes){
+        session_reset(s, seed, sz[0], sz[1]);
+        // 100 drones per 1000x1000 cells, at least the session's own
+        Rng rng(seed);
+        long extra = (long)sz[0] / 100 * (sz[1] / 100);
+        if(extra > 200000) extra = 200000;
+        for(long i=0;i<extra;i++){
+            Drone d; d.x = rng.range(sz[1]) * (double)GRID_CELL; d.y = rng.range(sz[0]) * (double)GRID_CELL;
+            d.angle = 0; d.hp = 30; d.cooldown = 0; s.drones.push(d);
+        }
+
+        sim_view_update();
+        sim_view_clear_dirty_cells();
+        Camera cam; cam.viewW = game_get_window_width() - game_get_hud_width(); cam.viewH = game_get_window_height();
+        double px, py; game_get_player_pos(px, py);
+        cam.x = px - cam.viewW/2.0; cam.y = py - cam.viewH/2.0;
+        size_t items = 0; long cells = 0, drones = 0;
+        clk::time_point t0 = clk::now();
+        for(int f=0;f<frames;f++){
+            // pan around the ship so the visible cell range changes every frame
+            cam.x += (f & 64) ? 3 : -3;
+            int r0, c0, r1, c1;
+            camera_visible_cells(cam, GRID_CELL, r0, c0, r1, c1);
+            dl.clear();
+            draw_list_add_cells(dl, s.world, r0, c0, r1, c1, camera_ox(cam), camera_oy(cam));
+            draw_list_add_entities(dl, cam, sim_view());
+            draw_list_sort(dl);
+            items += dl.items.size(); cells += dl.cells; drones += dl.drones;
+        }
+        double us = since(t0) * 1e6 / frames;
+        printf("%6d x %-6d drones %7d  build %8.1f us/frame  items %6.0f  cells %6.0f  visible drones %5.1f\n",
+            sz[0], sz[1], s.drones.size(), us, (double)items / frames, (double)cells / frames, (double)drones / frames);
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// tools/bench_drone_kernel.cpp
+// Drone steering kernel benchmark and equivalence check. Runs the same swarm through
+//   aos    - the old per-Drone Vec2 loop (array of structs, len()/normalized() calls)
+//   scalar - drone_steer_scalar() over the SoA store
+//   simd   - drone_steer() (widest SIMD path compiled in)
+// and fails if the SoA paths drift from the AoS reference by more than the tolerance
+// (0 = bitwise; pass a small value when the compiler contracts the scalar code into FMAs).
+// All three read the same per-drone targets and pushes. Every drone costs a sqrt and two
+// divides, and those set the floor: the AVX path already runs at the divider's throughput.
+// Bitwise equality rules out the usual ways around it (rsqrt, multiplying by a reciprocal,
+// FMA), so expect about 2x over aos with AVX, not more. gcc also packs the aos loop's x/y
+// pair into one SSE2 divide, so aos is effectively two lanes wide and soa scalar, which has
+// no adjacent pair to pack, runs slower than it; it is the reference, not a fast path.
+//   bench_drone_kernel [ticks=50] [tolerance=0]
+#include "game.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+// the pre-SoA drone loop, kept as the reference implementation
+static void steerAos(std::vector<Drone> &drones, const double* targetX, const double* targetY, const double* pushX, const double* pushY, double gain){
+    for(size_t i=0;i<drones.size();i++){
+        Drone &d = drones[i];
+        Vec2 dir = Vec2(targetX[i], targetY[i]) - Vec2(d.x, d.y);
+        dir = dir.normalized();
+        Vec2 desired = dir * 40.0;
+        desired += Vec2(pushX[i], pushY[i]) * gain;
+        d.vel = d.vel + (desired - d.vel) * 0.06;
+        d.x += d.vel.x * (1.0/60.0) * 60.0;
+        d.y += d.vel.y * (1.0/60.0) * 60.0;
+    }
+}
+
+static double maxDiff(const std::vector<Drone> &a, const DroneStore &b){
+    double m = 0;
+    for(int i=0;i<b.size();i++){
+        m = std::max(m, fabs(a[i].x - b.x[i])); m = std::max(m, fabs(a[i].y - b.y[i]));
+        m = std::max(m, fabs(a[i].vel.x - b.vx[i])); m = std::max(m, fabs(a[i].vel.y - b.vy[i]));
+    }
+    return m;
+}
+
+int main(int argc, char** argv){
+    int ticks = argc > 1 ? atoi(argv[1]) : 50;
+    double tolerance = argc > 2 ? atof(argv[2]) : 0.0;
+    const int counts[] = { 1000, 10000, 100000, 1000000 };
+    bool ok = true;
+
+    printf("kernel isa: %s\n", drone_steer_isa());
+    printf("%8s %12s %12s %12s %8s %12s\n", "drones", "aos ns/drone", "soa scalar", "simd", "speedup", "max diff");
+    for(int n : counts){
+        Rng rng(7);
+        std::vector<Drone> aos(n);
+        DroneStore scalar, simd;
+        std::vector<double> pushX(n), pushY(n), targetX(n, 5000.0), targetY(n, 6000.0);
+        for(int i=0;i<n;i++){
+            Drone &d = aos[i];
+            d.x = rng.range(100000) * 0.37; d.y = rng.range(100000) * 0.41;
+            d.vel = Vec2(rng.range(80) - 40.0, rng.range(80) - 40.0);
+            d.angle = 0; d.hp = 50; d.cooldown = 0;
+            pushX[i] = (rng.range(2001) - 1000) / 1000.0; pushY[i] = (rng.range(2001) - 1000) / 1000.0;
+            scalar.push(d); simd.push(d);
+        }
+        // one drone sits exactly on the target to cover the zero-length direction case
+        aos[0].x = scalar.x[0] = simd.x[0] = 5000.0;
+        aos[0].y = scalar.y[0] = simd.y[0] = 6000.0;
+        const double gain = 20.0;
+
+        clk::time_point t0 = clk::now();
+        for(int t=0;t<ticks;t++) steerAos(aos, targetX.data(), targetY.data(), pushX.data(), pushY.data(), gain);
+        double aosNs = since(t0) * 1e9 / ((double)ticks * n);
+        t0 = clk::now();
+        for(int t=0;t<ticks;t++) drone_steer_scalar(scalar, 0, n, targetX.data(), targetY.data(), pushX.data(), pushY.data(), gain);
+        double scalarNs = since(t0) * 1e9 / ((double)ticks * n);
+        t0 = clk::now();
+        for(int t=0;t<ticks;t++) drone_steer(simd, 0, n, targetX.data(), targetY.data(), pushX.data(), pushY.data(), gain);
+        double simdNs = since(t0) * 1e9 / ((double)ticks * n);
+
+        double diff = std::max(maxDiff(aos, scalar), maxDiff(aos, simd));
+        printf("%8d %12.2f %12.2f %12.2f %7.1fx %12.3g\n", n, aosNs, scalarNs, simdNs, aosNs / simdNs, diff);
+        if(diff > tolerance) ok = false;
+    }
+    if(!ok){ printf("FAIL: SoA kernels drifted from the AoS reference beyond %g\n", tolerance); return 1; }
+    printf("OK: SoA kernels match the AoS reference (tolerance %g)\n", tolerance);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// tools/bench_drones.cpp
+// Drone broadphase benchmark: sweeps 10 to 100k drones and reports spatial-hash build and
+// query cost against a brute-force scan, then the full drone tick phase at that count.
+//   bench_drones [ticks=20] [seed=1]
+#include "game.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+int main(int argc, char** argv){
+    int ticks = argc > 1 ? atoi(argv[1]) : 20;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    const int counts[] = { 10, 100, 1000, 10000, 100000 };
+    const double sepRadius = 16.0;
+
+    printf("%7s %10s %12s %14s %14s %12s\n", "drones", "build ns", "ship query", "sep all (hash)", "sep all (scan)", "drone phase");
+    for(int n : counts){
+        // about one drone per four cells, so neighbour counts stay flat as n grows
+        double side = sqrt((double)n * 4.0) * GRID_CELL;
+        Rng rng(seed);
+        std::vector<double> xs(n), ys(n);
+        for(int i=0;i<n;i++){ xs[i] = rng.next() / 4294967296.0 * side; ys[i] = rng.next() / 4294967296.0 * side; }
+
+        SpatialHash hash(GRID_CELL);
+        const int reps = n >= 10000 ? 5 : 200;
+        clk::time_point t0 = clk::now();
+        for(int k=0;k<reps;k++) hash.build(n, [&](int i, double &x, double &y){ x = xs[i]; y = ys[i]; });
+        double buildNs = since(t0) * 1e9 / reps;
+
+        std::vector<int> hits;
+        t0 = clk::now();
+        for(int k=0;k<reps;k++){ hits.clear(); hash.collect_radius(side/2, side/2, GRID_CELL*2.0, hits); }
+        double shipNs = since(t0) * 1e9 / reps;
+
+        long pairs = 0;
+        t0 = clk::now();
+        for(int i=0;i<n;i++) hash.query_radius(xs[i], ys[i], sepRadius, [&](int, SimReal, SimReal, SimReal){ pairs++; });
+        double sepHashUs = since(t0) * 1e6;
+
+        // brute force is quadratic; skip it where it would take minutes
+        double sepScanUs = -1; long scanPairs = 0;
+        if(n <= 10000){
+            t0 = clk::now();
+            for(int i=0;i<n;i++) for(int j=0;j<n;j++){
+                double dx = xs[j]-xs[i], dy = ys[j]-ys[i];
+                if(dx*dx + dy*dy < sepRadius*sepRadius) scanPairs++;
+            }
+            sepScanUs = since(t0) * 1e6;
+            if(scanPairs != pairs){ fprintf(stderr, "mismatch at %d drones: hash %ld scan %ld\n", n, pairs, scanPairs); return 1; }
+        }
+
+        // the real drone phase, with the drone swarm around the ship on a map big enough for it
+        Session *s = new Session();
+        int cells = (int)(side / GRID_CELL) + 64;
+        session_reset(*s, seed, cells, cells);
+        s->ships.x[PLAYER_SHIP] = side/2; s->ships.y[PLAYER_SHIP] = side/2;
+        s->drones.clear();
+        for(int i=0;i<n;i++){ Drone d; d.x = xs[i]; d.y = ys[i]; d.angle = 0; d.hp = 1000000; d.cooldown = 0; s->drones.push(d); }
+        uint64_t phaseNs[PHASE_COUNT] = {0};
+        for(int k=0;k<ticks;k++) session_update_timed(*s, phaseNs);
+        delete s;
+
+        printf("%7d %10.0f %10.0f ns %11.0f us ", n, buildNs, shipNs, sepHashUs);
+        if(sepScanUs >= 0) printf("%11.0f us ", sepScanUs); else printf("%14s ", "-");
+        printf("%9.0f us\n", phaseNs[PHASE_DRONES] / 1e3 / ticks);
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+// tools/bench_fixed.cpp
+// Fixed-point benchmark (sim_real.hpp). Compares the Fixed kernels with the double ones they
+// replace in a SIM_FIXED_POINT build:
+//  1. sin/cos: fixed_sin_cos() (quarter-wave table) vs std::sin + std::cos, ns/call, max error
+//  2. sqrt: fixed_sqrt() vs std::sqrt, ns/call, max error
+//  3. drone steering: drone_steer_fixed() vs drone_steer_scalar() and drone_steer(), ns/drone,
+//     and how far the fixed swarm ends up from the double one
+//  4. whole ticks in the mode this binary was built in: a session with an AI fleet, ms/tick and
+//     a hash over every tick's state hash. Build it once with -DSIM_FIXED_POINT under different
+//     compilers and flags and the hashes agree; built without, they need not.
+//   bench_fixed [ticks=3000] [expected hash]   (exit 1 if the tick hash differs from expected)
+#include "game.hpp"
+#include "replay.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+static Vec2 scriptedThrust(int tick, void*){
+    double t = tick / 60.0;
+    return Vec2(cos(t * 0.35), sin(t * 0.21));
+}
+
+static void trig(int n){
+    std::vector<double> a(n);
+    std::vector<Fixed> fa(n);
+    Rng rng(3);
+    for(int i=0;i<n;i++){ a[i] = (rng.range(2000001) - 1000000) * 1e-4; fa[i] = Fixed(a[i]); }
+    double sum = 0, err = 0;
+    clk::time_point t0 = clk::now();
+    for(int i=0;i<n;i++) sum += std::sin(a[i]) + std::cos(a[i]);
+    double stdNs = since(t0) * 1e9 / n;
+    Fixed fsum;
+    t0 = clk::now();
+    for(int i=0;i<n;i++){ Fixed s, c; fixed_sin_cos(fa[i], s, c); fsum += s + c; }
+    double fixNs = since(t0) * 1e9 / n;
+    for(int i=0;i<n;i++){
+        Fixed s, c; fixed_sin_cos(fa[i], s, c);
+        double x = fa[i].to_double();
+        err = std::max(err, std::max(fabs(s.to_double() - std::sin(x)), fabs(c.to_double() - std::cos(x))));
+    }
+    printf("  sin+cos  std %6.2f ns  fixed %6.2f ns  max error %.2g  (sums %.3f %.3f)\n", stdNs, fixNs, err, sum, fsum.to_double());
+}
+
+static void roots(int n){
+    std::vector<double> v(n);
+    std::vector<Fixed> fv(n);
+    Rng rng(5);
+    for(int i=0;i<n;i++){ v[i] = rng.range(1 << 30) * 1e-3; fv[i] = Fixed(v[i]); }
+    double sum = 0, err = 0;
+    clk::time_point t0 = clk::now();
+    for(int i=0;i<n;i++) sum += std::sqrt(v[i]);
+    double stdNs = since(t0) * 1e9 / n;
+    Fixed fsum;
+    t0 = clk::now();
+    for(int i=0;i<n;i++) fsum += fixed_sqrt(fv[i]);
+    double fixNs = since(t0) * 1e9 / n;
+    for(int i=0;i<n;i++) err = std::max(err, fabs(fixed_sqrt(fv[i]).to_double() - std::sqrt(fv[i].to_double())));
+    printf("  sqrt     std %6.2f ns  fixed %6.2f ns  max error %.2g  (sums %.1f %.1f)\n", stdNs, fixNs, err, sum, fsum.to_double());
+}
+
+static void steering(int n, int ticks){
+    Rng rng(7);
+    DroneStore base;
+    std::vector<double> pushX(n), pushY(n), targetX(n, 5000.0), targetY(n, 6000.0);
+    for(int i=0;i<n;i++){
+        Drone d;
+        d.x = rng.range(20000) * 0.37; d.y = rng.range(20000) * 0.41;
+        d.vel = Vec2(rng.range(80) - 40.0, rng.range(80) - 40.0);
+        d.angle = 0; d.hp = 50; d.cooldown = 0;
+        base.push(d);
+        pushX[i] = (rng.range(2001) - 1000) / 1000.0; pushY[i] = (rng.range(2001) - 1000) / 1000.0;
+    }
+    DroneStore scalar(base), simd(base), fixed(base);
+    clk::time_point t0 = clk::now();
+    for(int t=0;t<ticks;t++) drone_steer_scalar(scalar, 0, n, targetX.data(), targetY.data(), pushX.data(), pushY.data(), 20.0);
+    double scalarNs = since(t0) * 1e9 / ((double)ticks * n);
+    t0 = clk::now();
+    for(int t=0;t<ticks;t++) drone_steer(simd, 0, n, targetX.data(), targetY.data(), pushX.data(), pushY.data(), 20.0);
+    double simdNs = since(t0) * 1e9 / ((double)ticks * n);
+    t0 = clk::now();
+    for(int t=0;t<ticks;t++) drone_steer_fixed(fixed, 0, n, targetX.data(), targetY.data(), pushX.data(), pushY.data(), 20.0);
+    double fixNs = since(t0) * 1e9 / ((double)ticks * n);
+    double diff = 0;
+    for(int i=0;i<n;i++) diff = std::max(diff, std::max(fabs(fixed.x[i] - scalar.x[i]), fabs(fixed.y[i] - scalar.y[i])));
+    printf("  steer    double %6.2f ns  drone_steer (%s) %6.2f ns  fixed %6.2f ns per drone; after %d ticks fixed is within %.2g px\n",
+        scalarNs, drone_steer_isa(), simdNs, fixNs, ticks, diff);
+}
+
+// the player plus a fleet of 6x6 AI ships over a resident field: every ship, drone and piece of
+// debris a tick moves goes through SimReal
+static uint64_t session(int ticks, double& msPerTick, Session*& out){
+    Session *s = new Session();
+    s->inputSource = scriptedThrust;
+    session_reset(*s, 1, 600, 600);
+    ShipGrid hull;
+    hull.add(0, 0, BLOCK_CORE);
+    for(int r=-3;r<3;r++) for(int c=-3;c<3;c++)
+        if(r || c) hull.add(r, c, r == -3 ? BLOCK_MINER : (r == 2 && c > 0) ? BLOCK_THRUSTER : BLOCK_ARMOR);
+    int r0 = s->ships.coreR[PLAYER_SHIP], c0 = s->ships.coreC[PLAYER_SHIP];
+    s->stream.set_radius(0, 1200);
+    s->stream.update(s->world, r0, c0, 120);
+    for(int k=0;k<100;k++)
+        session_add_ship(*s, hull, (c0 + (k % 10 - 5) * 10 + 5) * GRID_CELL + GRID_CELL / 2, (r0 + (k / 10 - 5) * 10 + 5) * GRID_CELL + GRID_CELL / 2, k * 0.37);
+    uint64_t h = 0xCBF29CE484222325ull;
+    clk::time_point t0 = clk::now();
+    int done = 0;
+    for(;done<ticks && !s->gameOver;done++){
+        session_update(*s);
+        h = (h ^ replay_state_hash(*s)) * 0x100000001B3ull;
+    }
+    msPerTick = since(t0) * 1e3 / (done ? done : 1);
+    out = s;
+    return h;
+}
+
+int main(int argc, char** argv){
+    int ticks = argc > 1 ? atoi(argv[1]) : 3000;
+    const char* expected = argc > 2 ? argv[2] : nullptr;
+    printf("kernels (Fixed is Q32.32, sin/cos table of %d steps per quarter turn):\n", FIXED_TRIG_SIZE);
+    trig(1 << 20);
+    roots(1 << 20);
+    steering(100000, 50);
+
+    double ms;
+    Session *s;
+    uint64_t h = session(ticks, ms, s);
+    printf("session (%s build): %d ticks, 101 ships, %.3f ms/tick  final: tick=%d resources=%d score=%d drones=%d debris=%d\n",
+        SIM_NUMERIC ? "SIM_FIXED_POINT" : "double", s->tickCount, ms, s->tickCount, s->resources, s->score, s->drones.size(), s->debris.size());
+    printf("tick hash %016llx\n", (unsigned long long)h);
+    delete s;
+    if(expected){
+        bool same = strtoull(expected, nullptr, 16) == h;
+        printf(same ? "matches the expected hash\n" : "DIFFERS from the expected hash %s\n", expected);
+        return same ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+// tools/bench_fleet.cpp
+// Fleet benchmark: AI ships of 100 blocks (10x10: miners across the bow, thrusters on one side
+// of the stern, so thrust also turns them) fly between random targets over a resident asteroid
+// field, mining and bouncing off rock. Runs the same ticks with worker pools of 1, 2, 4 and 8
+// threads, times every phase against the 60 Hz budget and checks that every tick's state hash
+// is the same at every thread count. Then a smaller fleet is scattered around the player beyond
+// its reach, with nothing pre-generated, and run with the world generated inline, on two stream
+// workers, and on two workers with the ticks paced 2 ms apart: the hashes must match, however
+// late the workers deliver.
+//   bench_fleet [ships=1000] [ticks=300] [seed=1]
+#include "game.hpp"
+#include "replay.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+static const int MAP = 4096;
+static const int SPACING = 14; // cells between fleet ships at the start
+static const int SCATTER_SHIPS = 60;
+static const int SCATTER_NEAR = 40, SCATTER_FAR = 400; // cells east of the player's ship, and up to FAR north or south
+
+static void buildHull(ShipGrid& g){
+    g.clear(); g.reserve(100);
+    g.add(0, 0, BLOCK_CORE);
+    for(int r=-5;r<5;r++) for(int c=-5;c<5;c++){
+        if(r == 0 && c == 0) continue;
+        g.add(r, c, r == -5 ? BLOCK_MINER : (r == 4 && c > 0) ? BLOCK_THRUSTER : BLOCK_ARMOR);
+    }
+}
+
+struct Run { std::vector<uint64_t> hashes; uint64_t phaseNs[PHASE_COUNT]; double secs, moved; long broken; };
+
+// packed: a grid of ships around the player over a pre-generated area (the timing runs);
+// scattered: ships placed beyond the player's reach and only the stream generating the world,
+// inline or on streamWorkers threads, with pauseSec between ticks
+struct FleetSetup { bool scattered; int streamWorkers; double pauseSec; };
+
+static void runFleet(ThreadPool* pool, int ships, int ticks, uint32_t seed, const FleetSetup& setup, Run& out){
+    Session *s = new Session();
+    session_reset(*s, seed, MAP, MAP);
+    s->pool = pool;
+    int r0 = s->ships.coreR[PLAYER_SHIP], c0 = s->ships.coreC[PLAYER_SHIP];
+    ShipGrid hull;
+    buildHull(hull);
+    Rng rng(seed);
+    if(!setup.scattered){
+        // generated up front so the timed ticks measure the fleet, not world generation
+        int side = (int)ceil(sqrt((double)ships));
+        int reach = side * SPACING / 2 + SPACING * 4;
+        s->stream.set_radius(0, MAP * 2);
+        s->stream.update(s->world, r0, c0, reach);
+        for(int k=0;k<ships;k++){
+            int r = r0 + (k / side - side / 2) * SPACING, c = c0 + (k % side - side / 2) * SPACING;
+            if(r == r0 && c == c0) c += SPACING / 2; // leave the player's ship its spot
+            session_add_ship(*s, hull, c * GRID_CELL + GRID_CELL / 2, r * GRID_CELL + GRID_CELL / 2, rng.range(628) * 0.01);
+        }
+    } else {
+        // workers prefetch over the whole fleet area, so their installs land where AI ships read
+        s->stream.set_radius(SCATTER_FAR + REGION_SIZE, MAP * 2);
+        if(setup.streamWorkers > 0) s->stream.start_workers(setup.streamWorkers);
+        // the player starts at the map's west edge, so the fleet goes east of it
+        for(int k=0;k<ships;k++){
+            int r = r0 + rng.range(2 * SCATTER_FAR + 1) - SCATTER_FAR, c = c0 + SCATTER_NEAR + rng.range(SCATTER_FAR - SCATTER_NEAR + 1);
+            session_add_ship(*s, hull, c * GRID_CELL + GRID_CELL / 2, r * GRID_CELL + GRID_CELL / 2, rng.range(628) * 0.01);
+        }
+    }
+
+    std::vector<double> startX(s->ships.x), startY(s->ships.y);
+    for(int p=0;p<PHASE_COUNT;p++) out.phaseNs[p] = 0;
+    out.hashes.clear();
+    out.broken = 0;
+    out.secs = 0;
+    for(int t=0;t<ticks && !s->gameOver;t++){
+        s->resources = 0;
+        clk::time_point t0 = clk::now();
+        session_update_timed(*s, out.phaseNs);
+        out.secs += since(t0);
+        out.hashes.push_back(replay_state_hash(*s));
+        out.broken += (long)s->world.changes().size();
+        if(setup.pauseSec > 0) std::this_thread::sleep_for(std::chrono::duration<double>(setup.pauseSec));
+    }
+    // how far the fleet got: the average ship's distance from where it started, in cells
+    double moved = 0;
+    for(int i=PLAYER_SHIP+1;i<s->ships.size();i++) moved += hypot(s->ships.x[i] - startX[i], s->ships.y[i] - startY[i]);
+    out.moved = moved / std::max(1, ships) / GRID_CELL;
+    s->pool = nullptr;
+    s->stream.stop_workers();
+    delete s;
+}
+
+static int firstDifference(const Run& a, const Run& b){
+    size_t n = std::min(a.hashes.size(), b.hashes.size());
+    for(size_t t=0;t<n;t++) if(a.hashes[t] != b.hashes[t]) return (int)t + 1;
+    return a.hashes.size() == b.hashes.size() ? 0 : (int)n + 1;
+}
+
+int main(int argc, char** argv){
+    int ships = argc > 1 ? atoi(argv[1]) : 1000;
+    int ticks = argc > 2 ? atoi(argv[2]) : 300;
+    uint32_t seed = argc > 3 ? (uint32_t)strtoul(argv[3], nullptr, 10) : 1;
+    unsigned hw = std::thread::hardware_concurrency();
+    printf("%d AI ships of 100 blocks, %d ticks, %u hardware threads%s\n", ships, ticks, hw,
+        hw < 8 ? " (pools larger than that share cores; their times say nothing about scaling)" : "");
+    const int threads[] = { 1, 2, 4, 8 };
+    Run base;
+    bool ok = true;
+    for(int n : threads){
+        ThreadPool pool(n);
+        Run run;
+        FleetSetup packed = { false, 0, 0.0 };
+        runFleet(&pool, ships, ticks, seed, packed, run);
+        int done = (int)run.hashes.size();
+        bool same = n == 1 || run.hashes == base.hashes;
+        double ms = run.secs * 1e3 / done;
+        printf("  %d threads: %7.2f ms/tick  %6.1f ticks/s  %s  %6ld cells broken  moved %5.1f cells  hashes %s\n    ",
+            n, ms, 1e3 / ms, ms < 1e3 / 60 ? "fits 60 Hz" : "OVER BUDGET", run.broken, run.moved, n == 1 ? "(reference)" : same ? "identical" : "DIFFER");
+        for(int p=0;p<PHASE_COUNT;p++) printf(" %s %.2f", game_phase_name(p), (double)run.phaseNs[p] / done * 1e-6);
+        printf(" ms\n");
+        if(n == 1) base = run;
+        ok &= same;
+    }
+
+    printf("%d AI ships scattered %d-%d cells from the player, world streamed:\n", SCATTER_SHIPS, SCATTER_NEAR, SCATTER_FAR);
+    const FleetSetup streamed[] = { { true, 0, 0.0 }, { true, 2, 0.0 }, { true, 2, 0.002 } };
+    const char* names[] = { "inline", "2 workers", "2 workers, ticks 2 ms apart" };
+    Run inlineRun;
+    for(int k=0;k<3;k++){
+        Run run;
+        runFleet(nullptr, SCATTER_SHIPS, ticks, seed, streamed[k], run);
+        int diff = k == 0 ? 0 : firstDifference(inlineRun, run);
+        printf("  %-28s %6ld cells broken  moved %5.1f cells  ", names[k], run.broken, run.moved);
+        if(k == 0) printf("hashes (reference)\n");
+        else if(diff) printf("hashes DIFFER from tick %d\n", diff);
+        else printf("hashes identical\n");
+        if(k == 0) inlineRun = run;
+        ok &= diff == 0;
+    }
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// tools/bench_flow.cpp
+// Drone flow-field check and benchmark:
+//  1. random block edits and source moves (steps and jumps) around a rocky window: after every
+//     update the repaired field must equal a plain Dijkstra over the same window
+//  2. cost of one update by kind: a block placed or destroyed, the player stepping to the next
+//     cell, against rebuilding the whole window
+//  3. the drone phase with 1k to 50k drones in the window: the field update is the same work
+//     at every count, only the O(1) per-drone sampling and steering grow
+//   bench_flow [iterations=400] [seed=1]
+#include "game.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <vector>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+static const int MAP = 4000;
+
+static bool solidAt(const WorldGrid& w, int r, int c){ return !w.in_grid(r, c) || !w.get(r, c).empty(); }
+
+// the reference: Dijkstra with a binary heap over f's window, same moves and costs
+static int checkField(const Session& s, const FlowField& f){
+    const int r0 = f.window_r(), c0 = f.window_c();
+    const int sr = f.source_r() - r0, sc = f.source_c() - c0;
+    auto solid = [&](int r, int c){ return r < 0 || c < 0 || r >= FLOW_SIZE || c >= FLOW_SIZE || solidAt(s.world, r0 + r, c0 + c); };
+    std::vector<int32_t> dist(FLOW_SIZE * FLOW_SIZE, FLOW_UNREACHED);
+    typedef std::pair<int32_t,int> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+    dist[sr * FLOW_SIZE + sc] = 0; pq.push(Item(0, sr * FLOW_SIZE + sc));
+    while(!pq.empty()){
+        Item it = pq.top(); pq.pop();
+        if(it.first != dist[it.second]) continue;
+        int r = it.second / FLOW_SIZE, c = it.second % FLOW_SIZE;
+        if(solid(r, c) && !(r == sr && c == sc)) continue;
+        for(int dr=-1;dr<=1;dr++) for(int dc=-1;dc<=1;dc++){
+            if(!dr && !dc) continue;
+            if(solid(r + dr, c + dc) || (dr && dc && (solid(r + dr, c) || solid(r, c + dc)))) continue;
+            int32_t nd = it.first + (dr && dc ? FLOW_DIAG : FLOW_ORTHO);
+            int n = (r + dr) * FLOW_SIZE + c + dc;
+            if(nd < dist[n]){ dist[n] = nd; pq.push(Item(nd, n)); }
+        }
+    }
+    int bad = 0;
+    for(int i=0;i<FLOW_SIZE*FLOW_SIZE;i++) if(f.distance(r0 + i / FLOW_SIZE, c0 + i % FLOW_SIZE) != dist[i]) bad++;
+    return bad;
+}
+
+// a session whose ship sits in a resident, percent-solid square of radius cells
+static Session* rockySession(uint32_t seed, int radius, int percent){
+    Session *s = new Session();
+    session_reset(*s, seed, MAP, MAP);
+    int r0 = MAP / 2, c0 = MAP / 2;
+    s->ships.x[PLAYER_SHIP] = c0 * GRID_CELL + GRID_CELL / 2; s->ships.y[PLAYER_SHIP] = r0 * GRID_CELL + GRID_CELL / 2;
+    s->ships.prevX[PLAYER_SHIP] = s->ships.x[PLAYER_SHIP]; s->ships.prevY[PLAYER_SHIP] = s->ships.y[PLAYER_SHIP];
+    s->ships.coreR[PLAYER_SHIP] = r0; s->ships.coreC[PLAYER_SHIP] = c0;
+    s->ships.grid[PLAYER_SHIP].update_transforms(s->ships.x[PLAYER_SHIP], s->ships.y[PLAYER_SHIP], s->ships.angle[PLAYER_SHIP], GRID_CELL);
+    s->stream.update(s->world, r0, c0, radius + 1);
+    Rng rng(seed);
+    Block rock(BLOCK_ARMOR, BLOCK_HP_MAX);
+    for(int r=r0-radius;r<=r0+radius;r++) for(int c=c0-radius;c<=c0+radius;c++){
+        if(abs(r - r0) < 3 && abs(c - c0) < 3) s->world.clear(r, c);
+        else if(rng.range(100) < percent) s->world.set(r, c, rock);
+        else s->world.clear(r, c);
+    }
+    s->stream.record_writes(s->world);
+    s->flow.reset();
+    return s;
+}
+
+// flips a random cell within spread of (r,c) and hands the write to the field
+static void toggleCell(Session& s, Rng& rng, int r, int c, int spread){
+    int rr = r + rng.range(2 * spread + 1) - spread, cc = c + rng.range(2 * spread + 1) - spread;
+    if(rr == r && cc == c) return;
+    if(s.world.get(rr, cc).empty()) s.world.set(rr, cc, Block::of(BLOCK_ARMOR));
+    else s.world.clear(rr, cc);
+    s.flow.note_writes(s.world, s.world.written());
+    s.stream.record_writes(s.world);
+}
+
+int main(int argc, char** argv){
+    int iterations = argc > 1 ? atoi(argv[1]) : 400;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    bool ok = true;
+
+    {
+        Session *s = rockySession(seed, 200, 30);
+        Rng rng(seed + 1);
+        int r = s->ships.coreR[PLAYER_SHIP], c = s->ships.coreC[PLAYER_SHIP], bad = 0, badAt = -1;
+        for(int i=0;i<iterations && !bad;i++){
+            int kind = rng.range(10);
+            if(kind < 5) for(int k=rng.range(4)+1;k>0;k--) toggleCell(*s, rng, r, c, 40);
+            else if(kind < 9){ r += rng.range(3) - 1; c += rng.range(3) - 1; }
+            else { r += rng.range(11) - 5; c += rng.range(11) - 5; }
+            s->flow.update(s->world, s->stream, r, c);
+            bad = checkField(*s, s->flow);
+            if(bad) badAt = i;
+        }
+        FlowStats st = s->flow.stats();
+        if(bad) printf("repaired field: %d cells DIFFER from Dijkstra after update %d\n", bad, badAt);
+        else printf("repaired field: %d random edits/moves, equal to Dijkstra after every one (%ld rebuilds, %ld repairs)\n",
+            iterations, st.rebuilds, st.repairs);
+        if(bad) ok = false;
+        delete s;
+    }
+
+    printf("update cost, %dx%d window, 25%% rock:\n", FLOW_SIZE, FLOW_SIZE);
+    {
+        Session *s = rockySession(seed, 200, 25);
+        Rng rng(seed + 2);
+        int r = s->ships.coreR[PLAYER_SHIP], c = s->ships.coreC[PLAYER_SHIP];
+        s->flow.update(s->world, s->stream, r, c);
+        const int reps = 200;
+        double tRebuild = 0; long cellsRebuild = 0;
+        for(int i=0;i<reps;i++){
+            s->flow.reset();
+            clk::time_point t0 = clk::now();
+            s->flow.update(s->world, s->stream, r, c);
+            tRebuild += since(t0); cellsRebuild += s->flow.stats().lastCells;
+        }
+        double tEdit = 0; long cellsEdit = 0;
+        for(int i=0;i<reps;i++){
+            toggleCell(*s, rng, r, c, 60);
+            clk::time_point t0 = clk::now();
+            s->flow.update(s->world, s->stream, r, c);
+            tEdit += since(t0); cellsEdit += s->flow.stats().lastCells;
+        }
+        double tStep = 0; long cellsStep = 0;
+        for(int i=0;i<reps;i++){
+            // back and forth along a row, so the window never moves
+            int nc = c + ((i / 20) & 1 ? -1 : 1);
+            if(solidAt(s->world, r, nc)){ s->world.clear(r, nc); s->flow.note_writes(s->world, s->world.written()); s->stream.record_writes(s->world); s->flow.update(s->world, s->stream, r, c); }
+            c = nc;
+            clk::time_point t0 = clk::now();
+            s->flow.update(s->world, s->stream, r, c);
+            tStep += since(t0); cellsStep += s->flow.stats().lastCells;
+        }
+        printf("  rebuild      %8.1f us  %6ld cells\n", tRebuild / reps * 1e6, cellsRebuild / reps);
+        printf("  block edit   %8.1f us  %6ld cells  (%.0fx cheaper)\n", tEdit / reps * 1e6, cellsEdit / reps, tRebuild / tEdit);
+        printf("  player step  %8.1f us  %6ld cells  (%.1fx cheaper)\n", tStep / reps * 1e6, cellsStep / reps, tRebuild / tStep);
+        delete s;
+    }
+
+    printf("drone phase, drones spread over the window, ship crossing a cell every 4 ticks:\n");
+    const int counts[] = { 1000, 5000, 10000, 20000, 50000 };
+    const int ticks = 60;
+    for(int n : counts){
+        Session *s = rockySession(seed, 140, 15);
+        Rng rng(seed + 3);
+        s->drones.clear();
+        s->drones.reserve(n);
+        while(s->drones.size() < n){
+            int rr = s->ships.coreR[PLAYER_SHIP] + rng.range(241) - 120, cc = s->ships.coreC[PLAYER_SHIP] + rng.range(241) - 120;
+            if(solidAt(s->world, rr, cc)) continue;
+            Drone d; d.x = cc * GRID_CELL + GRID_CELL / 2; d.y = rr * GRID_CELL + GRID_CELL / 2;
+            d.angle = 0; d.vel = Vec2(); d.hp = 1 << 30; d.cooldown = 0;
+            s->drones.push(d);
+        }
+        uint64_t phaseNs[PHASE_COUNT] = {0};
+        long fieldCells = 0;
+        for(int t=0;t<ticks;t++){
+            s->ships.vx[PLAYER_SHIP] = 6; s->ships.vy[PLAYER_SHIP] = 0;
+            s->resources = 0;
+            session_update_timed(*s, phaseNs);
+            fieldCells += s->flow.stats().lastCells;
+        }
+        // the per-drone part alone: one field lookup each
+        clk::time_point t0 = clk::now();
+        volatile int sink = 0;
+        for(int rep=0;rep<10;rep++) for(int i=0;i<s->drones.size();i++){
+            int nr, nc;
+            if(s->flow.step((int)(s->drones.y[i] / GRID_CELL), (int)(s->drones.x[i] / GRID_CELL), nr, nc)) sink = sink + nr;
+        }
+        double sampleNs = since(t0) * 1e9 / (10.0 * s->drones.size());
+        double phase = (double)phaseNs[PHASE_DRONES] / ticks;
+        printf("  %6d drones: drone phase %9.0f ns/tick (%5.1f ns/drone)  field %6ld cells/tick  sampling %4.1f ns/drone\n",
+            n, phase, phase / n, fieldCells / ticks, sampleNs);
+        delete s;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// tools/bench_minimap.cpp
+// World summary benchmark (world_summary.hpp): fully generated maps from 256 x 256 up to
+// 8192 x 8192, each frame changing random cells through WorldSummary::change() and drawing the
+// HUD minimap (whole map) plus a 1020x720 map view at 4 cells per pixel from the pyramid.
+// Reports build cost, ns per change, and frame time next to rescanning the world for the
+// minimap the naive way. The summary frame should stay flat as the map grows; the rescan
+// grows with it. At the end every node of the updated pyramid is checked against a rebuild.
+//   bench_minimap [frames=500] [changes per frame=64] [seed=1]
+// exit 1 if an updated pyramid differs from a rebuild
+#include "world_gen.hpp"
+#include "world_summary.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+static const int MINIMAP_W = 236, MINIMAP_H = 160;
+static const int VIEW_W = 1020, VIEW_H = 720;
+
+// the minimap without a pyramid: every occupied cell binned into its pixel, then colored
+static void rescanMinimap(const WorldGrid& world, double cellsPerPixel, int w, int h, std::vector<uint32_t>& bins, Framebuffer& fb){
+    bins.assign((size_t)w * h * BLOCK_TYPE_COUNT, 0);
+    for(int i=0;i<world.chunk_count();i++){
+        const Chunk &ch = world.chunk(i);
+        for(int lr=0;lr<CHUNK_SIZE;lr++) for(int lc=0;lc<CHUNK_SIZE;lc++){
+            BlockType t = ch.at(lr, lc).type();
+            if(t == BLOCK_EMPTY) continue;
+            int px = std::min(w - 1, (int)((ch.col0() + lc) / cellsPerPixel));
+            int py = std::min(h - 1, (int)((ch.row0() + lr) / cellsPerPixel));
+            bins[((size_t)py * w + px) * BLOCK_TYPE_COUNT + t]++;
+        }
+    }
+    for(int py=0;py<h;py++) for(int px=0;px<w;px++){
+        const uint32_t *b = &bins[((size_t)py * w + px) * BLOCK_TYPE_COUNT];
+        BlockType best = BLOCK_EMPTY;
+        for(int t=1;t<BLOCK_TYPE_COUNT;t++) if(b[t] > b[best]) best = (BlockType)t;
+        fb.pixels[(size_t)py * fb.stride + px] = BLOCK_INFO[best].color;
+    }
+}
+
+struct Edit { int r, c; BlockType was, to; };
+
+static long mismatches(const WorldSummary& a, const WorldSummary& b){
+    if(a.levels() != b.levels()) return 1;
+    long bad = 0;
+    for(int k=0;k<a.levels();k++)
+        for(int nr=0;nr<a.level_rows(k);nr++) for(int nc=0;nc<a.level_cols(k);nc++)
+            for(int t=0;t<SUMMARY_TYPES;t++) bad += a.counts(k, nr, nc)[t] != b.counts(k, nr, nc)[t];
+    return bad;
+}
+
+int main(int argc, char** argv){
+    int frames = argc > 1 ? atoi(argv[1]) : 500;
+    int changes = argc > 2 ? atoi(argv[2]) : 64;
+    uint32_t seed = argc > 3 ? (uint32_t)strtoul(argv[3], nullptr, 10) : 1;
+    const int sizes[] = { 256, 1024, 4096, 8192 };
+    const int RESCAN_FRAMES = 3;
+
+    std::vector<uint32_t> pixels((size_t)VIEW_W * VIEW_H), bins;
+    Framebuffer fb = { pixels.data(), VIEW_W, VIEW_H, VIEW_W };
+    WorldGrid *world = new WorldGrid();
+    WorldSummary sum, check;
+    std::vector<Edit> edits;
+    int bad = 0;
+    for(int n : sizes){
+        world->reset(n, n);
+        WorldGenParams p = worldgen_default(seed, n, n);
+        int chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        for(int cr=0;cr<chunks;cr++) for(int cc=0;cc<chunks;cc++)
+            world->load_chunk(cr, cc, [&](Block* cells){ return worldgen_chunk(p, cr, cc, cells); });
+
+        clk::time_point t0 = clk::now();
+        sum.build(*world);
+        double buildMs = since(t0) * 1e3;
+
+        Rng rng(seed);
+        int mw, mh;
+        double mapCpp = world_summary_fit(sum, MINIMAP_W, MINIMAP_H, mw, mh);
+        double changeSecs = 0, drawSecs = 0;
+        int viewLevel = 0;
+        for(int f=0;f<frames;f++){
+            edits.clear();
+            for(int i=0;i<changes;i++){
+                Edit e; e.r = rng.range(n); e.c = rng.range(n);
+                e.was = world->get(e.r, e.c).type(); e.to = (BlockType)rng.range(BLOCK_TYPE_COUNT);
+                world->set(e.r, e.c, Block::of(e.to));
+                edits.push_back(e);
+            }
+            t0 = clk::now();
+            for(const Edit &e : edits) sum.change(e.r, e.c, e.was, e.to);
+            changeSecs += since(t0);
+            t0 = clk::now();
+            world_summary_draw(fb, sum, 0, 0, mw, mh, 0, 0, mapCpp, 0x0A0A1C);
+            double cr = n / 2.0 + (f % 64) - VIEW_H * 2.0, cc = n / 2.0 + (f % 64) - VIEW_W * 2.0; // a drifting view
+            viewLevel = world_summary_draw(fb, sum, 0, 0, VIEW_W, VIEW_H, cr, cc, 4.0, 0x0A0A1C);
+            drawSecs += since(t0);
+        }
+        world->clear_changes();
+
+        t0 = clk::now();
+        for(int f=0;f<RESCAN_FRAMES;f++) rescanMinimap(*world, mapCpp, mw, mh, bins, fb);
+        double rescanMs = since(t0) * 1e3 / RESCAN_FRAMES;
+
+        check.build(*world);
+        long wrong = mismatches(sum, check);
+        bad += wrong != 0;
+        printf("%5d x %-5d chunks %6d  summary %2d levels, base %3d cells, %6.2f MB, build %7.2f ms  change %5.1f ns  "
+            "frame %7.1f us (minimap %dx%d level %d, view level %d)  rescan minimap %8.2f ms  %s\n",
+            n, n, world->chunk_count(), sum.levels(), 1 << sum.base_shift(), sum.memory_bytes() / (1024.0*1024.0), buildMs,
+            changeSecs * 1e9 / ((double)frames * changes), drawSecs * 1e6 / frames, mw, mh, sum.level_for(mapCpp), viewLevel,
+            rescanMs, wrong ? "MISMATCH" : "ok");
+    }
+    delete world;
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,227 @@
+// tools/bench_net.cpp
+// State streaming benchmark over a real socket (state_server.hpp). A server thread runs a
+// session with an AI fleet headless and streams it; the main thread is a loopback viewer that
+// rebuilds it with a StateMirror and pilots the ship, sending one input per frame it receives.
+// Reports the keyframe size, bytes per tick (mean, p99, max) against copying the state a renderer
+// reads every tick, publish and decode time, drone spawns/deaths seen, and the input round trip
+// (input sent -> first frame of a tick that consumed it). At the end the mirror is checked
+// against the session: every resident world cell's type, each body's blocks, and every pose
+// within half a quantization step.
+//   bench_net [ticks=600] [tick rate Hz=60, 0 = as fast as possible] [addr=tcp:127.0.0.1:27961]
+// (addr may be unix:/path on POSIX); exit 1 if the mirror does not match
+#include "game.hpp"
+#include "frame_scheduler.hpp"
+#include "state_server.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+template<class T> static T pct(std::vector<T> v, double p){
+    if(v.empty()) return T();
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, (size_t)(p * v.size()))];
+}
+template<class T> static double mean(const std::vector<T>& v){
+    double sum = 0;
+    for(T x : v) sum += (double)x;
+    return v.empty() ? 0 : sum / v.size();
+}
+
+// what a renderer pulling whole state every tick reads: the occupied world chunks, drone
+// positions, and every body's pose and blocks
+static size_t fullStateBytes(const Session& s){
+    size_t bytes = (size_t)s.world.chunk_count() * CHUNK_SIZE * CHUNK_SIZE * sizeof(Block);
+    bytes += (size_t)s.drones.size() * 2 * sizeof(double);
+    const ShipStore *pools[2] = { &s.ships, &s.debris };
+    for(const ShipStore *sh : pools)
+        for(int i=0;i<sh->size();i++) bytes += 3 * sizeof(double) + (size_t)sh->grid[i].size() * 3 * sizeof(int);
+    return bytes;
+}
+
+static Vec2 pilotThrust(int tick){
+    double t = tick / 60.0;
+    return Vec2(cos(t * 0.35), sin(t * 0.21));
+}
+
+struct ServerRun {
+    Session* s;
+    StateServer* server;
+    int ticks, rate;
+    std::vector<double> publishUs;
+    std::vector<size_t> frameBytes, fullBytes;
+    std::atomic<bool> viewerDone;
+    std::atomic<int> lastTick;   // the session's tick once the server has published its last frame, -1 before
+};
+
+static void serverMain(ServerRun* run){
+    Session &s = *run->s;
+    StateServer &server = *run->server;
+    while(server.stats().joined == 0){ server.wait(50); server.poll(); }
+    double t0 = sched_default_now(nullptr);
+    for(int k=0;k<run->ticks;k++){
+        if(run->rate > 0){
+            double due = t0 + (double)k / run->rate - sched_default_now(nullptr);
+            if(due > 0) sched_precise_wait(due, nullptr);
+        }
+        server.poll();
+        session_update(s);
+        clk::time_point p0 = clk::now();
+        server.publish(s.world.changes());
+        run->publishUs.push_back(since(p0) * 1e6);
+        s.world.clear_changes();
+        run->frameBytes.push_back(server.stats().lastFrameBytes);
+        run->fullBytes.push_back(fullStateBytes(s));
+    }
+    run->lastTick = s.tickCount; // short of ticks if the game ended
+    // let the viewer drain its queue, then hang up
+    while(!run->viewerDone.load() && server.stats().viewers > 0){ server.wait(10); server.poll(); }
+}
+
+static bool sameBlocks(const ShipGrid& a, const ShipGrid& b){
+    if(a.size() != b.size()) return false;
+    for(int i=0;i<a.size();i++) if(a.row(i) != b.row(i) || a.col(i) != b.col(i) || a.type(i) != b.type(i)) return false;
+    return true;
+}
+
+static int checkBodies(const ShipStore& sh, const std::vector<MirrorBody>& m, const char* what){
+    if((int)m.size() != sh.size()){ printf("  %s: %d on the server, %d in the mirror\n", what, sh.size(), (int)m.size()); return 1; }
+    const double POS_TOL = 0.5 / STREAM_POS_SCALE + 1e-9, ANGLE_TOL = 3.14159265358979 / STREAM_ANGLE_STEPS + 1e-9;
+    int bad = 0;
+    for(int i=0;i<sh.size();i++){
+        double da = std::remainder(sh.angle[i] - m[i].angle, 6.283185307179586);
+        if(fabs(sh.x[i] - m[i].x) > POS_TOL || fabs(sh.y[i] - m[i].y) > POS_TOL || fabs(da) > ANGLE_TOL || !sameBlocks(sh.grid[i], m[i].blocks)) bad++;
+    }
+    if(bad) printf("  %s: %d of %d differ\n", what, bad, sh.size());
+    return bad;
+}
+
+static int checkMirror(const Session& s, const StateMirror& m){
+    int bad = 0;
+    if(m.tick() != s.tickCount || m.resources() != s.resources || m.score() != s.score){
+        printf("  counters: tick %d/%d resources %d/%d score %d/%d\n", s.tickCount, m.tick(), s.resources, m.resources(), s.score, m.score());
+        bad++;
+    }
+    std::vector<RegionPos> regions;
+    s.stream.resident_regions(regions);
+    long cells = 0, wrong = 0;
+    for(const RegionPos &rp : regions){
+        int r0 = rp.rr << REGION_SHIFT, c0 = rp.rc << REGION_SHIFT;
+        for(int r=r0;r<r0+REGION_SIZE;r++) for(int c=c0;c<c0+REGION_SIZE;c++){
+            cells++;
+            if(s.world.get(r, c).type() != m.world().get(r, c).type()) wrong++;
+        }
+    }
+    if(wrong) printf("  world: %ld of %ld resident cells differ\n", wrong, cells);
+    bad += wrong != 0;
+    bad += checkBodies(s.ships, m.ships(), "ships") != 0;
+    bad += checkBodies(s.debris, m.debris(), "debris") != 0;
+    const double POS_TOL = 0.5 / STREAM_POS_SCALE + 1e-9;
+    if((int)m.drone_x().size() != s.drones.size()){
+        printf("  drones: %d on the server, %d in the mirror\n", s.drones.size(), (int)m.drone_x().size());
+        bad++;
+    }else{
+        int off = 0;
+        for(int i=0;i<s.drones.size();i++)
+            if(fabs(s.drones.x[i] - m.drone_x()[i]) > POS_TOL || fabs(s.drones.y[i] - m.drone_y()[i]) > POS_TOL) off++;
+        if(off) printf("  drones: %d of %d off\n", off, s.drones.size());
+        bad += off != 0;
+    }
+    printf("mirror: %ld resident cells, %d ships, %d debris, %d drones checked: %s\n",
+        cells, s.ships.size(), s.debris.size(), s.drones.size(), bad ? "MISMATCH" : "match");
+    return bad;
+}
+
+int main(int argc, char** argv){
+    int ticks = argc > 1 ? atoi(argv[1]) : 600;
+    int rate = argc > 2 ? atoi(argv[2]) : 60;
+    const char* addr = argc > 3 ? argv[3] : "tcp:127.0.0.1:27961";
+
+    // the player plus 100 6x6 AI ships over a resident field, as in bench_fixed
+    Session *s = new Session();
+    session_reset(*s, 1, 600, 600);
+    ShipGrid hull;
+    hull.add(0, 0, BLOCK_CORE);
+    for(int r=-3;r<3;r++) for(int c=-3;c<3;c++)
+        if(r || c) hull.add(r, c, r == -3 ? BLOCK_MINER : (r == 2 && c > 0) ? BLOCK_THRUSTER : BLOCK_ARMOR);
+    int r0 = s->ships.coreR[PLAYER_SHIP], c0 = s->ships.coreC[PLAYER_SHIP];
+    s->stream.set_radius(0, 1200);
+    s->stream.update(s->world, r0, c0, 120);
+    for(int k=0;k<100;k++)
+        session_add_ship(*s, hull, (c0 + (k % 10 - 5) * 10 + 5) * GRID_CELL + GRID_CELL / 2, (r0 + (k / 10 - 5) * 10 + 5) * GRID_CELL + GRID_CELL / 2, k * 0.37);
+    s->world.clear_changes();
+
+    StateServer server;
+    if(!server.start(*s, addr)){ printf("cannot listen on %s\n", addr); return 1; }
+    ServerRun run;
+    run.s = s; run.server = &server; run.ticks = ticks; run.rate = rate;
+    run.viewerDone = false;
+    run.lastTick = -1;
+    std::thread serverThread(serverMain, &run);
+
+    NetLink link(net_connect(addr));
+    if(!link.open()){ printf("cannot connect to %s\n", addr); run.viewerDone = true; serverThread.join(); return 1; }
+    StateMirror mirror;
+    std::vector<uint8_t> msg, input;
+    std::vector<double> decodeUs, rttMs, sentAt(1, 0.0);
+    size_t keyframeBytes = 0;
+    long spawns = 0, deaths = 0;
+    uint32_t seq = 0, acked = 0;
+    bool failed = false;
+    while(link.open() && !(mirror.synced() && run.lastTick.load() >= 0 && mirror.tick() >= run.lastTick.load())){
+        if(!link.receive(msg)){
+            NetSocket sock = link.socket();
+            net_wait(&sock, 1, 100);
+            continue;
+        }
+        clk::time_point d0 = clk::now();
+        bool ok = mirror.apply(msg.data(), msg.size());
+        double us = since(d0) * 1e6;
+        double now = sched_default_now(nullptr);
+        if(!ok){ printf("message rejected (kind %d, %d bytes)\n", msg.empty() ? -1 : msg[0], (int)msg.size()); failed = true; break; }
+        if(msg[0] == STREAM_KEYFRAME) keyframeBytes = msg.size();
+        else{
+            decodeUs.push_back(us);
+            spawns += (long)mirror.drone_spawns().size(); deaths += mirror.drone_deaths();
+        }
+        if(mirror.input_ack() > acked){
+            acked = mirror.input_ack();
+            rttMs.push_back((now - sentAt[acked]) * 1e3);
+        }
+        mirror.clear_dirty_cells();
+        // the pilot answers every frame with its input for the next tick
+        stream_encode_input(++seq, pilotThrust(mirror.tick()), input);
+        sentAt.push_back(sched_default_now(nullptr));
+        link.send(input);
+    }
+    run.viewerDone = true;
+    link.close();
+    serverThread.join();
+    server.stop();
+
+    const StateServerStats &st = server.stats();
+    double meanBytes = mean(run.frameBytes), fullBytes = mean(run.fullBytes);
+    char pace[32];
+    if(rate > 0) snprintf(pace, sizeof(pace), "at %d Hz", rate);
+    else snprintf(pace, sizeof(pace), "unpaced");
+    printf("session: 600x600 map, %d ships, %d ticks %s over %s\n", s->ships.size(), s->tickCount, pace, addr);
+    printf("keyframe: %zu bytes\n", keyframeBytes);
+    printf("frames: %.1f bytes/tick mean, p50 %zu, p99 %zu, max %zu = %.1f kB/s at 60 Hz; copying the full state would be %.0f bytes/tick (%.0fx)\n",
+        meanBytes, pct(run.frameBytes, 0.5), pct(run.frameBytes, 0.99), pct(run.frameBytes, 1.0), meanBytes * 60 / 1000, fullBytes, meanBytes > 0 ? fullBytes / meanBytes : 0.0);
+    printf("wire: %llu bytes out, %llu in, %ld inputs taken; %d drone spawns, %d deaths\n",
+        (unsigned long long)st.bytesOut, (unsigned long long)st.bytesIn, st.inputs, (int)spawns, (int)deaths);
+    printf("server publish %.1f us/tick (p99 %.1f), viewer decode %.1f us/tick (p99 %.1f)\n",
+        mean(run.publishUs), pct(run.publishUs, 0.99), mean(decodeUs), pct(decodeUs, 0.99));
+    printf("input round trip: %d samples, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+        (int)rttMs.size(), pct(rttMs, 0.5), pct(rttMs, 0.99), pct(rttMs, 1.0));
+    int bad = failed ? 1 : checkMirror(*s, mirror);
+    delete s;
+    return bad ? 1 : 0;
+}
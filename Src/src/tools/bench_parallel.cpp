@@ -0,0 +1,103 @@
+// tools/bench_parallel.cpp
+// Parallel tick phases check and benchmark. One busy scenario (a 2000-block ship mining its
+// way through rock, 20000 drones swarming it) runs on the ticking thread alone and then on
+// thread pools of 1 to 8 workers; the state hash after every tick must be the same at every
+// thread count, and the read phases (mining, drones, collisions) and the apply phase are timed.
+//   bench_parallel [ticks=120] [seed=1] [drones=20000]
+#include "game.hpp"
+#include "replay.hpp"
+#include "thread_pool.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const int MAP = 4000;
+
+// roughly square ship of n blocks around the core: miners on the front row, armor elsewhere
+static void buildShip(ShipGrid& g, int n){
+    g.clear(); g.reserve(n);
+    int side = (int)ceil(sqrt((double)n)), half = side / 2;
+    g.add(0, 0, BLOCK_CORE, 100);
+    for(int r=-half;r<side-half && g.size()<n;r++) for(int c=-half;c<side-half && g.size()<n;c++)
+        g.add(r, c, r == -half ? BLOCK_MINER : BLOCK_ARMOR, 60);
+}
+
+struct Run { std::vector<uint64_t> hashes; uint64_t phaseNs[PHASE_COUNT]; long broken; };
+
+static void runScenario(ThreadPool* pool, int ticks, uint32_t seed, int drones, Run& out){
+    Session *s = new Session();
+    session_reset(*s, seed, MAP, MAP);
+    s->pool = pool;
+    ShipStore &sh = s->ships;
+    const int P = PLAYER_SHIP;
+    int r0 = MAP / 2, c0 = MAP / 2;
+    sh.x[P] = c0 * GRID_CELL + GRID_CELL / 2; sh.y[P] = r0 * GRID_CELL + GRID_CELL / 2;
+    sh.prevX[P] = sh.x[P]; sh.prevY[P] = sh.y[P];
+    buildShip(sh.grid[P], 2000);
+    sh.grid[P].update_transforms(sh.x[P], sh.y[P], sh.angle[P], GRID_CELL);
+    sh.coreR[P] = r0; sh.coreC[P] = c0;
+
+    // rock ahead of the ship (up the map), open space where it starts
+    Rng rng(seed);
+    s->stream.update(s->world, r0, c0, 160);
+    Block rock(BLOCK_ARMOR, 20);
+    for(int r=r0-150;r<=r0+150;r++) for(int c=c0-150;c<=c0+150;c++){
+        if(r > r0 - 25 && abs(c - c0) < 30) s->world.clear(r, c);
+        else if(rng.range(100) < 20) s->world.set(r, c, rock);
+        else s->world.clear(r, c);
+    }
+    s->drones.clear();
+    while(s->drones.size() < drones){
+        Drone d; d.x = (c0 - 120 + rng.range(240)) * GRID_CELL + 12.0; d.y = (r0 - 120 + rng.range(240)) * GRID_CELL + 12.0;
+        d.angle = 0; d.vel = Vec2(); d.hp = 1 << 20; d.cooldown = 0;
+        s->drones.push(d);
+    }
+
+    for(int p=0;p<PHASE_COUNT;p++) out.phaseNs[p] = 0;
+    out.hashes.clear();
+    out.broken = 0;
+    for(int t=0;t<ticks && !s->gameOver;t++){
+        sh.vx[P] = sin(t * 0.05) * 3.0; sh.vy[P] = -4.0;
+        s->resources = 0;
+        session_update_timed(*s, out.phaseNs);
+        out.hashes.push_back(replay_state_hash(*s));
+        out.broken += (long)s->world.changes().size();
+    }
+    s->pool = nullptr;
+    delete s;
+}
+
+int main(int argc, char** argv){
+    int ticks = argc > 1 ? atoi(argv[1]) : 120;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    int drones = argc > 3 ? atoi(argv[3]) : 20000;
+    bool ok = true;
+
+    Run serial;
+    runScenario(nullptr, ticks, seed, drones, serial);
+    const int threads[] = { 1, 2, 4, 8 };
+    printf("hardware threads: %u, %d ticks, %d drones, 2000-block ship\n", std::thread::hardware_concurrency(), ticks, drones);
+    printf("%-10s %12s %12s %12s %12s  %s\n", "threads", "mining us", "drones us", "collide us", "apply us", "hashes");
+    auto row = [&](const char* name, const Run& r, const char* verdict){
+        printf("%-10s %12.1f %12.1f %12.1f %12.1f  %s\n", name, r.phaseNs[PHASE_MINING] / 1e3 / ticks, r.phaseNs[PHASE_DRONES] / 1e3 / ticks,
+            r.phaseNs[PHASE_COLLISIONS] / 1e3 / ticks, r.phaseNs[PHASE_APPLY] / 1e3 / ticks, verdict);
+    };
+    row("no pool", serial, "reference");
+    printf("(%ld cells broken over the run)\n", serial.broken);
+    for(int n : threads){
+        ThreadPool pool(n);
+        Run r;
+        runScenario(&pool, ticks, seed, drones, r);
+        int bad = -1;
+        for(size_t t=0;t<serial.hashes.size() && bad < 0;t++) if(t >= r.hashes.size() || r.hashes[t] != serial.hashes[t]) bad = (int)t + 1;
+        if(bad < 0 && r.hashes.size() != serial.hashes.size()) bad = (int)serial.hashes.size() + 1;
+        char name[16], verdict[48];
+        snprintf(name, sizeof(name), "%d", n);
+        if(bad < 0) snprintf(verdict, sizeof(verdict), "identical");
+        else { snprintf(verdict, sizeof(verdict), "DIFFER from tick %d", bad); ok = false; }
+        row(name, r, verdict);
+    }
+    return ok ? 0 : 1;
+}
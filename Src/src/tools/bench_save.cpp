@@ -0,0 +1,122 @@
+// tools/bench_save.cpp
+// Save/load benchmark: for maps from 80x50 up to 100k x 100k, writes a full save, loads it back
+// through the memory-mapped path, then plays on, writes a delta checkpoint and restores
+// full + delta into a fresh session. Reports sizes, ms and MB/s, and checks that every restore
+// equals the original and keeps simulating identically.
+//   bench_save [prefix=bench_save] [seed=1]
+#include "save_file.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+static Vec2 scriptedThrust(int tick, void*){
+    double t = tick / 60.0;
+    return Vec2(cos(t * 0.35), sin(t * 0.21));
+}
+
+static bool sameWorld(const WorldGrid& a, const WorldGrid& b){
+    if(a.rows() != b.rows() || a.cols() != b.cols() || a.chunk_count() != b.chunk_count()) return false;
+    for(int i=0;i<a.chunk_count();i++){
+        const Chunk &ch = a.chunk(i);
+        for(int lr=0;lr<CHUNK_SIZE;lr++) for(int lc=0;lc<CHUNK_SIZE;lc++){
+            const Block &x = ch.at(lr, lc), &y = b.get(ch.row0()+lr, ch.col0()+lc);
+            if(x.bits != y.bits) return false;
+        }
+    }
+    return true;
+}
+
+static bool sameShip(const ShipGrid& a, const ShipGrid& b){
+    if(a.size() != b.size() || a.thrusters() != b.thrusters() || a.miners() != b.miners()) return false;
+    for(int i=0;i<a.size();i++)
+        if(a.row(i) != b.row(i) || a.col(i) != b.col(i) || a.type(i) != b.type(i) || a.hp(i) != b.hp(i)) return false;
+    return true;
+}
+
+// every component a save carries (prev* and throttle are not: a load starts a fresh tick);
+// targets only mean something to AI ships, from index ai on
+static bool sameShips(const ShipStore& a, const ShipStore& b, int ai){
+    if(a.size() != b.size()) return false;
+    for(int k=0;k<a.size();k++){
+        if(a.x[k] != b.x[k] || a.y[k] != b.y[k] || a.angle[k] != b.angle[k] || a.vx[k] != b.vx[k] || a.vy[k] != b.vy[k]
+            || a.angVel[k] != b.angVel[k] || a.coreR[k] != b.coreR[k] || a.coreC[k] != b.coreC[k] || a.ttl[k] != b.ttl[k]
+            || !sameShip(a.grid[k], b.grid[k])) return false;
+        if(k >= ai && (a.targetX[k] != b.targetX[k] || a.targetY[k] != b.targetY[k])) return false;
+    }
+    return true;
+}
+
+static bool sameSession(const Session& a, const Session& b){
+    return a.tickCount == b.tickCount && a.resources == b.resources && a.score == b.score
+        && a.rng.s == b.rng.s && a.paused == b.paused && a.gameOver == b.gameOver
+        && sameShips(a.ships, b.ships, PLAYER_SHIP + 1) && sameShips(a.debris, b.debris, a.debris.size())
+        && a.drones.x == b.drones.x && a.drones.y == b.drones.y && a.drones.vx == b.drones.vx
+        && a.drones.vy == b.drones.vy && a.drones.hp == b.drones.hp
+        && sameWorld(a.world, b.world);
+}
+
+// a few AI ships around the player's, so saves carry them too
+static void addFleet(Session& s){
+    ShipGrid hull;
+    hull.add(0, 0, BLOCK_CORE); hull.add(0, 1, BLOCK_ARMOR); hull.add(-1, 0, BLOCK_MINER);
+    hull.add(1, 0, BLOCK_ARMOR); hull.add(1, 1, BLOCK_THRUSTER);
+    for(int k=0;k<3;k++)
+        session_add_ship(s, hull, s.ships.x[PLAYER_SHIP] + (k - 1) * 6 * GRID_CELL, s.ships.y[PLAYER_SHIP] + 4 * GRID_CELL, k * 0.5);
+}
+
+static void run(Session& s, int ticks){ for(int i=0;i<ticks;i++) session_update(s); }
+
+int main(int argc, char** argv){
+    std::string prefix = argc > 1 ? argv[1] : "bench_save";
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    const int sizes[][2] = { {WORLD_ROWS, WORLD_COLS}, {1000, 1000}, {10000, 10000}, {100000, 100000} };
+    std::string fullPath = prefix + "_full.bin", deltaPath = prefix + "_delta.bin";
+
+    Session *a = new Session(), *b = new Session();
+    a->inputSource = scriptedThrust; b->inputSource = scriptedThrust;
+    int failures = 0;
+    for(auto &sz : sizes){
+        session_reset(*a, seed, sz[0], sz[1]);
+        addFleet(*a);
+        run(*a, 300);
+
+        std::vector<uint8_t> buf;
+        clk::time_point t0 = clk::now();
+        save_encode_full(*a, buf);
+        double encSecs = since(t0);
+        t0 = clk::now();
+        bool wrote = save_write_full(*a, fullPath.c_str());
+        double writeSecs = since(t0);
+        t0 = clk::now();
+        bool loaded = wrote && save_load(*b, fullPath.c_str());
+        double loadSecs = since(t0);
+        bool fullOk = loaded && sameSession(*a, *b);
+
+        // play on, checkpoint only what changed, restore full + delta elsewhere
+        run(*a, 1200);
+        std::vector<uint8_t> dbuf;
+        t0 = clk::now();
+        bool delta = save_encode_delta(*a, dbuf);
+        double deltaSecs = since(t0);
+        bool deltaOk = delta && save_write_delta(*a, deltaPath.c_str())
+            && save_load(*b, fullPath.c_str()) && save_load(*b, deltaPath.c_str()) && sameSession(*a, *b);
+        run(*a, 600); run(*b, 600);
+        bool resumeOk = sameSession(*a, *b);
+
+        double mb = buf.size() / (1024.0 * 1024.0);
+        double denseMB = (double)sz[0] * sz[1] * sizeof(Block) / (1024.0 * 1024.0);
+        printf("%6d x %-6d full %9.3f MB (dense %9.1f MB)  encode %7.2f ms %7.0f MB/s  write %7.2f ms  load %7.2f ms %7.0f MB/s  delta %7zu B %6.3f ms  [%s]\n",
+            sz[0], sz[1], mb, denseMB, encSecs * 1e3, mb / encSecs, writeSecs * 1e3, loadSecs * 1e3, mb / loadSecs,
+            dbuf.size(), deltaSecs * 1e3,
+            fullOk && deltaOk && resumeOk ? "ok" : (!fullOk ? "FULL MISMATCH" : (!deltaOk ? "DELTA MISMATCH" : "RESUME DIVERGED")));
+        failures += !(fullOk && deltaOk && resumeOk);
+    }
+    remove(fullPath.c_str()); remove(deltaPath.c_str());
+    delete a; delete b;
+    return failures ? 1 : 0;
+}
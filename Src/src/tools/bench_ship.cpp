@@ -0,0 +1,158 @@
+// tools/bench_ship.cpp
+// Ship block grid benchmark and check:
+//  1. random adds and removes: incremental mass, center of mass, inertia, thrust arm, extent
+//     and role lists must match a from-scratch recomputation after every edit
+//  2. placing every block in the world, per ship size: one shared transform pass vs the old
+//     scheme of a sin/cos + rotate per block in each of forces, mining and collisions
+//  3. whole ticks with ships of up to 20000 blocks flying through a 100k x 100k field,
+//     against the 16.7 ms of a 60 Hz tick
+//   bench_ship [ticks=600] [seed=1]
+#include "game.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+static bool near(double a, double b){ return fabs(a - b) <= 1e-9 * (1.0 + fabs(a) + fabs(b)); }
+
+// recompute everything from the blocks and compare
+static bool checkGrid(const ShipGrid& g){
+    double m = 0, sr = 0, sc = 0, sq = 0, thrustC = 0;
+    std::vector<int> thr, min;
+    int ext = 0;
+    for(int i=0;i<g.size();i++){
+        double bm = ship_block_mass(g.type(i)), r = g.row(i), c = g.col(i);
+        m += bm; sr += bm * r; sc += bm * c; sq += bm * (r * r + c * c);
+        if(g.type(i) == BLOCK_THRUSTER){ thr.push_back(i); thrustC += c; }
+        if(g.type(i) == BLOCK_MINER) min.push_back(i);
+        ext = std::max(ext, std::max(abs(g.row(i)), abs(g.col(i))));
+        if(g.find(g.row(i), g.col(i)) != i) return false;
+    }
+    if(g.size() == 0) return g.mass() == 0 && g.thrusters().empty() && g.miners().empty();
+    double cr = sr / m, cc = sc / m;
+    double inertia = sq + m / 6.0 - m * (cr * cr + cc * cc);
+    return near(g.mass(), m) && near(g.com_r(), cr) && near(g.com_c(), cc) && near(g.inertia(), inertia)
+        && near(g.thrust_arm(), cc * thr.size() - thrustC) && g.extent() == ext
+        && g.thrusters() == thr && g.miners() == min;
+}
+
+static int checkEdits(uint32_t seed){
+    Rng rng; rng.reseed(seed);
+    ShipGrid g;
+    const BlockType types[] = { BLOCK_ARMOR, BLOCK_THRUSTER, BLOCK_MINER, BLOCK_CORE };
+    int edits = 0;
+    for(int i=0;i<20000;i++){
+        int r = rng.range(41) - 20, c = rng.range(41) - 20;
+        if(rng.range(100) < 55) g.add(r, c, types[rng.range(4)], 10);
+        else g.remove(r, c);
+        edits++;
+        if(!checkGrid(g)) return edits;
+    }
+    return 0;
+}
+
+// roughly square ship of n blocks around the core: thrusters on the back rows, miners on the
+// front row, armor elsewhere
+static void buildShip(ShipGrid& g, int n){
+    g.clear(); g.reserve(n);
+    int side = (int)ceil(sqrt((double)n)), half = side / 2;
+    g.add(0, 0, BLOCK_CORE, 100);
+    for(int r=-half;r<side-half && g.size()<n;r++) for(int c=-half;c<side-half && g.size()<n;c++){
+        BlockType t = r == -half ? BLOCK_MINER : (r >= side - half - 2 && (c & 1) ? BLOCK_THRUSTER : BLOCK_ARMOR);
+        g.add(r, c, t, 60);
+    }
+}
+
+// the old per-system placement: every system walks every block, and computes sin/cos and the
+// rotation for each one it uses
+static double oldPlacement(const ShipGrid& g, double x, double y, double angle){
+    double acc = 0;
+    for(int pass=0;pass<3;pass++){
+        for(int i=0;i<g.size();i++){
+            BlockType t = g.type(i);
+            if(pass == 0 && t != BLOCK_THRUSTER) continue;
+            if(pass == 1 && t != BLOCK_MINER) continue;
+            double lx = g.col(i) * GRID_CELL, ly = g.row(i) * GRID_CELL;
+            double s = sin(angle), c = cos(angle);
+            double wx = x + lx * c - ly * s, wy = y + lx * s + ly * c;
+            acc += (int)(wx / GRID_CELL) + (int)(wy / GRID_CELL);
+        }
+    }
+    return acc;
+}
+
+static double newPlacement(ShipGrid& g, double x, double y, double angle){
+    g.update_transforms(x, y, angle, GRID_CELL);
+    double acc = 0;
+    for(int i : g.thrusters()) acc += g.world_c(i) + g.world_r(i);
+    for(int i : g.miners()) acc += g.world_c(i) + g.world_r(i);
+    for(int i=0;i<g.size();i++) acc += g.world_c(i) + g.world_r(i);
+    return acc;
+}
+
+static Vec2 fullThrust(int, void*){ return Vec2(0, -1); }
+
+int main(int argc, char** argv){
+    int ticks = argc > 1 ? atoi(argv[1]) : 600;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+
+    int bad = checkEdits(seed);
+    if(bad) printf("incremental mass properties: MISMATCH after edit %d\n", bad);
+    else printf("incremental mass properties: 20000 random edits, all match a full recomputation\n");
+
+    const int sizes[] = { 6, 100, 1000, 5000, 20000 };
+    printf("block placement per tick (ns):\n");
+    for(int n : sizes){
+        ShipGrid g; buildShip(g, n);
+        int reps = 2000000 / n + 10;
+        volatile double sink = 0;
+        clk::time_point t0 = clk::now();
+        for(int i=0;i<reps;i++) sink = sink + oldPlacement(g, 5000.5, 3000.25, i * 0.001);
+        double tOld = since(t0) / reps;
+        t0 = clk::now();
+        for(int i=0;i<reps;i++) sink = sink + newPlacement(g, 5000.5, 3000.25, i * 0.001);
+        double tNew = since(t0) / reps;
+        // edit cost: one block off and back on, mass properties and role lists included
+        t0 = clk::now();
+        int edge = g.size() - 1, er = g.row(edge), ec = g.col(edge);
+        BlockType et = g.type(edge);
+        for(int i=0;i<reps;i++){ g.remove(er, ec); g.add(er, ec, et, 60); }
+        double tEdit = since(t0) / reps / 2;
+        printf("  %6d blocks: per-system %10.0f  shared %9.0f  (%4.1fx)  edit %5.0f ns\n",
+            g.size(), tOld * 1e9, tNew * 1e9, tOld / tNew, tEdit * 1e9);
+    }
+
+    printf("ticks with big ships on a 100k x 100k map, %d ticks each:\n", ticks);
+    bool ok = !bad;
+    for(int n : sizes){
+        Session *s = new Session();
+        session_reset(*s, seed, 100000, 100000);
+        s->inputSource = fullThrust;
+        buildShip(s->ships.grid[PLAYER_SHIP], n);
+        s->ships.grid[PLAYER_SHIP].update_transforms(s->ships.x[PLAYER_SHIP], s->ships.y[PLAYER_SHIP], s->ships.angle[PLAYER_SHIP], GRID_CELL);
+        uint64_t phaseNs[PHASE_COUNT] = {0};
+        double worst = 0, x0 = s->ships.x[PLAYER_SHIP], y0 = s->ships.y[PLAYER_SHIP];
+        clk::time_point t0 = clk::now();
+        for(int i=0;i<ticks && !s->gameOver;i++){
+            clk::time_point t1 = clk::now();
+            s->resources = -1000000; // mining must not end the session
+            session_update_timed(*s, phaseNs);
+            double t = since(t1);
+            if(t > worst) worst = t;
+        }
+        double avg = since(t0) / ticks;
+        const ShipGrid &g = s->ships.grid[PLAYER_SHIP];
+        printf("  %6d blocks (mass %7.1f, inertia %10.0f): avg %7.3f ms  worst %7.3f ms  forces %6.0f ns  mining %6.0f ns  collisions %8.0f ns  moved %5.0f cells  %s\n",
+            g.size(), g.mass(), g.inertia(), avg * 1e3, worst * 1e3, (double)phaseNs[PHASE_SHIP_FORCES] / ticks,
+            (double)phaseNs[PHASE_MINING] / ticks, (double)phaseNs[PHASE_COLLISIONS] / ticks,
+            hypot(s->ships.x[PLAYER_SHIP] - x0, s->ships.y[PLAYER_SHIP] - y0) / GRID_CELL, avg < 1.0 / 60 ? "fits 60 Hz" : "OVER BUDGET");
+        if(avg >= 1.0 / 60) ok = false;
+        delete s;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+// tools/bench_split.cpp
+// Ship connectivity check and benchmark:
+//  1. square ships of 1k to 40k blocks lose random non-core blocks one at a time until half are
+//     gone; after each, ShipGrid::detach_after_remove() finds what was cut off and it is taken
+//     out. The grid left must be exactly what a flood fill from the core reaches (checked after
+//     every removal on the small ship, every 500th on the others), and the per-removal cost is
+//     compared with that flood fill
+//  2. the same ships in a session, drones scattered over the whole hull every tick until half
+//     the ship is gone: apply-phase cost per block destroyed or cut loose
+//   bench_split [ticks=600] [seed=1] [drones=4000]
+#include "game.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+// side x side armor square, core in the middle
+static void buildSquare(ShipGrid& g, int side){
+    g.clear(); g.reserve(side * side);
+    int half = side / 2;
+    g.add(0, 0, BLOCK_CORE);
+    for(int r=-half;r<side-half;r++) for(int c=-half;c<side-half;c++) g.add(r, c, BLOCK_ARMOR);
+}
+
+// blocks a flood fill from the core reaches: the reference the incremental search must match
+static int floodFromCore(const ShipGrid& g, std::vector<int>& queue, std::vector<uint8_t>& seen){
+    static const int DR[4] = { -1, 1, 0, 0 }, DC[4] = { 0, 0, -1, 1 };
+    int core = g.find(0, 0);
+    if(core < 0) return 0;
+    seen.assign(g.size(), 0);
+    queue.clear(); queue.push_back(core); seen[core] = 1;
+    for(size_t k=0;k<queue.size();k++){
+        int b = queue[k];
+        for(int d=0;d<4;d++){
+            int j = g.find(g.row(b) + DR[d], g.col(b) + DC[d]);
+            if(j >= 0 && !seen[j]){ seen[j] = 1; queue.push_back(j); }
+        }
+    }
+    return (int)queue.size();
+}
+
+static bool gridPass(int side, uint32_t seed){
+    ShipGrid g;
+    buildSquare(g, side);
+    int start = g.size(), checkEvery = side <= 32 ? 1 : 500;
+    Rng rng(seed);
+    std::vector<CellPos> order;
+    for(int i=0;i<g.size();i++) if(g.type(i) != BLOCK_CORE) order.push_back({ g.row(i), g.col(i) });
+    for(int i=(int)order.size()-1;i>0;i--) std::swap(order[i], order[rng.range(i + 1)]);
+
+    std::vector<CellPos> cells; std::vector<int> ends;
+    std::vector<int> queue; std::vector<uint8_t> seen;
+    std::vector<double> ns;
+    long removals = 0, fragments = 0, cut = 0, checks = 0;
+    double floodNs = 0; long floods = 0;
+    bool ok = true;
+    for(const CellPos &p : order){
+        if(g.size() <= start / 2) break;
+        if(g.find(p.r, p.c) < 0) continue; // already cut loose with a fragment
+        clk::time_point t0 = clk::now();
+        g.remove(p.r, p.c);
+        cells.clear(); ends.clear();
+        int f = g.detach_after_remove(p.r, p.c, cells, ends);
+        for(const CellPos &q : cells) g.remove(q.r, q.c);
+        ns.push_back(since(t0) * 1e9);
+        removals++; fragments += f; cut += (long)cells.size();
+        if(removals % checkEvery == 0){
+            t0 = clk::now();
+            int reached = floodFromCore(g, queue, seen);
+            floodNs += since(t0) * 1e9; floods++;
+            checks++;
+            if(reached != g.size()){ ok = false; printf("  removal %ld: %d blocks reach the core, %d in the grid\n", removals, reached, g.size()); break; }
+        }
+    }
+    std::vector<double> sorted(ns);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0; for(double v : ns) sum += v;
+    auto pct = [&](double p){ return sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))]; };
+    printf("  %6d blocks: %6ld removals %5ld fragments %6ld cut  avg %7.0f ns  p50 %6.0f  p99 %8.0f  max %9.0f ns  flood fill %10.0f ns  %ld checks %s\n",
+        start, removals, fragments, cut, sum / std::max(1L, removals), pct(0.5), pct(0.99), sorted.empty() ? 0.0 : sorted.back(),
+        floodNs / std::max(1L, floods), checks, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static const int MAP = 4000;
+
+static bool firePass(int side, int ticks, int drones, uint32_t seed){
+    Session *s = new Session();
+    session_reset(*s, seed, MAP, MAP);
+    ShipStore &sh = s->ships;
+    const int P = PLAYER_SHIP;
+    int r0 = MAP / 2, c0 = MAP / 2;
+    sh.x[P] = c0 * GRID_CELL + GRID_CELL / 2; sh.y[P] = r0 * GRID_CELL + GRID_CELL / 2;
+    sh.prevX[P] = sh.x[P]; sh.prevY[P] = sh.y[P];
+    sh.coreR[P] = r0; sh.coreC[P] = c0;
+    buildSquare(sh.grid[P], side);
+    sh.grid[P].update_transforms(sh.x[P], sh.y[P], sh.angle[P], GRID_CELL);
+    // open space around the ship, so every drone over it hits the hull
+    s->stream.update(s->world, r0, c0, side + 64);
+    for(int r=r0-side-32;r<=r0+side+32;r++) for(int c=c0-side-32;c<=c0+side+32;c++) s->world.clear(r, c);
+    s->drones.clear();
+    Rng rng(seed);
+    int half = side / 2;
+    while(s->drones.size() < drones){
+        Drone d; d.x = sh.x[P] + (rng.range(side) - half) * GRID_CELL; d.y = sh.y[P] + (rng.range(side) - half) * GRID_CELL;
+        d.angle = 0; d.vel = Vec2(); d.hp = 1 << 20; d.cooldown = 0;
+        s->drones.push(d);
+    }
+    int start = sh.grid[P].size();
+    uint64_t phaseNs[PHASE_COUNT] = {0};
+    long destroyed = 0, cut = 0;
+    int t = 0;
+    for(;t<ticks && !s->gameOver && sh.grid[P].size() > start / 2;t++){
+        // heavy fire all over the hull, every drone shooting every tick: left alone they would
+        // all close in on the core
+        for(int i=0;i<s->drones.size();i++){
+            s->drones.x[i] = sh.x[P] + (rng.range(side) - half) * GRID_CELL + 1.0;
+            s->drones.y[i] = sh.y[P] + (rng.range(side) - half) * GRID_CELL + 1.0;
+            s->drones.cooldown[i] = 0;
+        }
+        sh.vx[P] = 0; sh.vy[P] = 0; sh.angVel[P] = 0; // the shoves would fling the ship around
+        s->resources = 0;
+        int before = sh.grid[P].size();
+        session_update_timed(*s, phaseNs);
+        // pieces cut loose this tick have had one debris tick
+        long loose = 0;
+        for(int k=0;k<s->debris.size();k++) if(s->debris.ttl[k] == DEBRIS_LIFETIME - 1) loose += s->debris.grid[k].size();
+        cut += loose;
+        destroyed += before - sh.grid[P].size() - loose;
+    }
+    std::vector<int> queue; std::vector<uint8_t> seen;
+    bool ok = floodFromCore(sh.grid[P], queue, seen) == sh.grid[P].size();
+    printf("  %6d blocks: %4d ticks %6ld destroyed %6ld cut loose  apply %9.0f ns/tick  %6.0f ns per block destroyed or cut  %s\n",
+        start, t, destroyed, cut, (double)phaseNs[PHASE_APPLY] / std::max(1, t),
+        destroyed + cut ? (double)phaseNs[PHASE_APPLY] / (destroyed + cut) : 0.0, ok ? "connected" : "NOT CONNECTED");
+    delete s;
+    return ok;
+}
+
+int main(int argc, char** argv){
+    int ticks = argc > 1 ? atoi(argv[1]) : 600;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    int drones = argc > 3 ? atoi(argv[3]) : 4000;
+    const int sides[] = { 32, 100, 200 };
+    bool ok = true;
+    printf("random removals until half the ship is gone (ns per removal, cut-off fragments included):\n");
+    for(int side : sides) ok &= gridPass(side, seed);
+    printf("%d drones over the ship, up to %d ticks:\n", drones, ticks);
+    for(int side : sides) ok &= firePass(side, ticks, drones, seed);
+    printf(ok ? "ok\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
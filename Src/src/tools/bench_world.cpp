@@ -0,0 +1,52 @@
+// tools/bench_world.cpp
+// Sparse world benchmark: generates maps from the default 80x50 up to 100k x 100k and reports
+// occupied chunks, memory, and random cell lookup cost (hits inside asteroid chunks and misses
+// in empty space) plus a few simulated ticks.
+//   bench_world [lookups=4000000] [seed=1]
+#include "game.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+typedef std::chrono::steady_clock clk;
+static double since(clk::time_point t0){ return std::chrono::duration<double>(clk::now() - t0).count(); }
+
+int main(int argc, char** argv){
+    long lookups = argc > 1 ? atol(argv[1]) : 4000000;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    const int sizes[][2] = { {WORLD_ROWS, WORLD_COLS}, {1000, 1000}, {10000, 10000}, {100000, 100000} };
+
+    Session *s = new Session();
+    for(auto &sz : sizes){
+        clk::time_point t0 = clk::now();
+        session_reset(*s, seed, sz[0], sz[1]);
+        double genSecs = since(t0);
+        const WorldGrid &w = s->world;
+
+        // hits: random cells inside occupied chunks; misses: random cells anywhere
+        Rng rng(seed);
+        long hit = 0;
+        t0 = clk::now();
+        for(long i=0;i<lookups;i++){
+            const Chunk &ch = w.chunk(rng.range(w.chunk_count()));
+            hit += w.get(ch.row0() + rng.range(CHUNK_SIZE), ch.col0() + rng.range(CHUNK_SIZE)).empty() ? 0 : 1;
+        }
+        double hitNs = since(t0) * 1e9 / lookups;
+        t0 = clk::now();
+        long any = 0;
+        for(long i=0;i<lookups;i++) any += w.get(rng.range(w.rows()), rng.range(w.cols())).empty() ? 0 : 1;
+        double anyNs = since(t0) * 1e9 / lookups;
+
+        const int ticks = 6000;
+        t0 = clk::now();
+        for(int i=0;i<ticks && !s->gameOver;i++) session_update(*s);
+        double tickNs = since(t0) * 1e9 / ticks;
+
+        double denseMB = (double)sz[0] * sz[1] * sizeof(Block) / (1024.0*1024.0);
+        printf("%6d x %-6d gen %8.2f ms  chunks %7d  mem %8.2f MB (dense %10.1f MB)  lookup hit %5.1f ns  any %5.1f ns  tick %6.0f ns  [%ld/%ld]\n",
+            sz[0], sz[1], genSecs * 1e3, w.chunk_count(), w.memory_bytes() / (1024.0*1024.0), denseMB,
+            hitNs, anyNs, tickNs, hit, any);
+    }
+    delete s;
+    return 0;
+}
@@ -0,0 +1,178 @@
+// tools/input_latency.cpp
+// Input queue check and latency measurement:
+//  1. a producer thread pushes numbered pointer moves in bursts, with a key down/up every
+//     TRANSITION_EVERY events, while a consumer drains them once per simulated tick, some ticks
+//     long enough to fill the queue. Events must arrive in order, every move must be delivered
+//     or coalesced into a later one, every transition delivered or counted as dropped, and the
+//     last position must arrive
+//  2. a full queue: moves pushed far past capacity with no consumer, then MOVE_RESERVE / 2
+//     key and button down/up events each behind another move. All of them must be delivered,
+//     in order, followed by the newest position
+//  3. the real sim thread at 60 Hz with the Windows build's wiring (the input source drains the
+//     queue at the start of a tick), a scripted typist pressing and releasing keys, and this
+//     thread standing in for the renderer: frames paced at 60 Hz, each "presented" right after
+//     sim_view_update(). Prints receipt-to-present latency p50/p99/max.
+//   input_latency [events=2000000] [seconds=3]
+#include "frame_scheduler.hpp"
+#include "input_queue.hpp"
+#include "sim_thread.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+static const long TRANSITION_EVERY = 1024;
+
+static InputEvent numbered(int kind, long n){
+    InputEvent e; e.time = 0; e.kind = kind; e.key = 0;
+    e.x = (int)(n & 0xffff); e.y = (int)(n >> 16);
+    return e;
+}
+static long numberOf(const InputEvent& e){ return (long)e.x | ((long)e.y << 16); }
+static bool isTransition(const InputEvent& e){ return e.kind != INPUT_POINTER_MOVE; }
+
+static int queuePass(long events){
+    InputQueue *q = new InputQueue();
+    std::atomic<bool> done(false);
+    long transitions = 0;
+    std::thread producer([&]{
+        Rng rng(3);
+        long next = 0;
+        while(next < events){
+            int burst = 1 + rng.range(64);
+            for(int k=0;k<burst && next < events;k++){
+                bool key = next % TRANSITION_EVERY == TRANSITION_EVERY - 1;
+                q->push(numbered(key ? (transitions % 2 ? INPUT_KEY_UP : INPUT_KEY_DOWN) : INPUT_POINTER_MOVE, next));
+                transitions += key;
+                next++;
+            }
+            if(rng.range(8) == 0) std::this_thread::yield();
+        }
+        while(!q->flush()) std::this_thread::yield();
+        done.store(true, std::memory_order_release);
+    });
+    long received = 0, keys = 0, outOfOrder = 0, ticks = 0;
+    long last = -1;
+    InputEvent e;
+    for(;;){
+        bool finished = done.load(std::memory_order_acquire);
+        while(q->pop(e)){
+            long n = numberOf(e);
+            if(n <= last) outOfOrder++;
+            last = n;
+            received++;
+            keys += isTransition(e);
+        }
+        ticks++;
+        if(finished) break;
+        // now and then a long tick, so the producer also runs into a full queue
+        if(ticks % 64 == 0) sched_precise_wait(0.002, nullptr);
+        else std::this_thread::yield();
+    }
+    producer.join();
+    long dropped = (long)q->dropped(), coalesced = (long)q->coalesced();
+    long lastMove = events - 1 - ((events - 1) % TRANSITION_EVERY == TRANSITION_EVERY - 1);
+    bool ok = !outOfOrder && keys + dropped == transitions && received - keys + coalesced == events - transitions
+        && last >= lastMove;
+    printf("queue: %ld events  %ld received over %ld drains  %ld moves coalesced  %ld/%ld key events (%ld dropped)  out-of-order %ld  %s\n",
+        events, received, ticks, coalesced, keys, transitions, dropped, outOfOrder, ok ? "ok" : "FAILED");
+    delete q;
+    return ok ? 0 : 1;
+}
+
+static int fullQueuePass(){
+    InputQueue *q = new InputQueue();
+    long n = 0;
+    for(uint32_t i=0;i<InputQueue::CAPACITY * 2;i++) q->push(numbered(INPUT_POINTER_MOVE, n++));
+    const int kinds[] = { INPUT_KEY_DOWN, INPUT_KEY_UP, INPUT_POINTER_DOWN, INPUT_POINTER_UP };
+    long transitions = InputQueue::MOVE_RESERVE / 2;
+    for(long k=0;k<transitions;k++){
+        q->push(numbered(INPUT_POINTER_MOVE, n++));
+        q->push(numbered(kinds[k % 4], n++));
+    }
+    long newest = n;
+    q->push(numbered(INPUT_POINTER_MOVE, n++));
+    InputEvent e;
+    long keys = 0, outOfOrder = 0, last = -1, lastPos = -1, drains = 0;
+    for(;;){
+        while(q->pop(e)){
+            long m = numberOf(e);
+            if(m <= last) outOfOrder++;
+            last = m;
+            if(isTransition(e)){ if(e.kind != kinds[keys % 4]) outOfOrder++; keys++; }
+            else lastPos = m;
+        }
+        drains++;
+        if(q->flush() && drains > 1) break;
+    }
+    bool ok = !outOfOrder && keys == transitions && q->dropped() == 0 && lastPos == newest;
+    printf("full queue: %ld/%ld key and button events delivered behind %ld moves (%u coalesced), newest position %s  %s\n",
+        keys, transitions, n - transitions, q->coalesced(), lastPos == newest ? "delivered" : "LOST", ok ? "ok" : "FAILED");
+    delete q;
+    return ok ? 0 : 1;
+}
+
+// the sim side of the Windows wiring, with keys mapped straight to thrust
+static InputQueue g_queue;
+static int g_keysHeld = 0;
+static long g_applied = 0;
+
+static Vec2 queuedThrust(int, void*){
+    InputEvent e;
+    bool first = true;
+    while(g_queue.pop(e)){
+        if(first) sim_thread_note_input(e.time);
+        first = false;
+        g_keysHeld += e.kind == INPUT_KEY_DOWN ? 1 : -1;
+        g_applied++;
+    }
+    return Vec2(g_keysHeld > 0 ? 1.0 : 0.0, 0.0);
+}
+
+static int simPass(double seconds){
+    game_set_input_source(queuedThrust, nullptr);
+    game_init(1);
+    sim_thread_start(1.0 / 60.0);
+    std::atomic<bool> stop(false);
+    long pushed = 0;
+    std::thread typist([&]{
+        Rng rng(5);
+        bool down = false;
+        while(!stop.load(std::memory_order_relaxed)){
+            sched_precise_wait((20 + rng.range(60)) / 1000.0, nullptr);
+            InputEvent e; e.time = sched_default_now(nullptr); e.kind = down ? INPUT_KEY_UP : INPUT_KEY_DOWN;
+            e.key = 'W'; e.x = e.y = 0;
+            if(g_queue.push(e)){ down = !down; pushed++; }
+        }
+        if(down){ InputEvent e; e.time = sched_default_now(nullptr); e.kind = INPUT_KEY_UP; e.key = 'W'; e.x = e.y = 0; g_queue.push(e); pushed++; }
+    });
+    FrameScheduler frames(1.0 / 60.0, 5);
+    long presented = 0;
+    double t0 = sched_default_now(nullptr);
+    while(sched_default_now(nullptr) - t0 < seconds){
+        if(!frames.frame_due()){ frames.wait_next_frame(); continue; }
+        frames.step(nullptr, nullptr);
+        sim_view_update();
+        sim_view_clear_dirty_cells();
+        sim_view_note_present(sched_default_now(nullptr));
+        presented++;
+    }
+    stop.store(true);
+    typist.join();
+    sim_thread_stop();
+    const InputLatencyStats &lat = sim_view_input_latency();
+    printf("sim thread: %d ticks, %ld frames, %ld key events pushed, %ld applied\n", game_get_tick(), presented, pushed, g_applied);
+    printf("input to present: %ld samples  p50 %.2f ms  p99 %.2f ms  max %.2f ms  (one tick + one frame is %.1f ms)\n",
+        lat.count, lat.p50Ms, lat.p99Ms, lat.maxMs, 2000.0 / 60.0);
+    return lat.count > 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv){
+    long events = argc > 1 ? atol(argv[1]) : 2000000;
+    double seconds = argc > 2 ? atof(argv[2]) : 3.0;
+    int failed = queuePass(events);
+    failed |= fullQueuePass();
+    failed |= simPass(seconds);
+    printf(failed ? "FAILED\n" : "ok\n");
+    return failed;
+}
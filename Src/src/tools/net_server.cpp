@@ -0,0 +1,60 @@
+// tools/net_server.cpp
+// Headless authoritative server: the default session ticks at 60 Hz through game_update() with
+// no window, and streams to viewers over a socket (state_server.hpp). The first viewer to
+// connect pilots the ship, the rest watch; a finished game starts over and every viewer gets a
+// keyframe of the new one. Prints viewers and bandwidth every 5 seconds.
+//   net_server [addr=tcp:127.0.0.1:27960] [seed=1] [seconds=0, 0 = until killed]
+#include "game.hpp"
+#include "frame_scheduler.hpp"
+#include "state_server.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+static StateServer g_server;
+
+static void tick(void*){
+    game_update();
+    g_server.publish(game_dirty_cells());
+    game_clear_dirty_cells();
+}
+
+static void newGame(uint32_t seed){
+    game_init(seed);
+    // viewers regenerate streamed regions themselves: only the ticks' own changes go out
+    game_session().stream.report_streamed(false);
+}
+
+int main(int argc, char** argv){
+    const char* addr = argc > 1 ? argv[1] : "tcp:127.0.0.1:27960";
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+    double seconds = argc > 3 ? atof(argv[3]) : 0;
+
+    newGame(seed);
+    if(!g_server.start(game_session(), addr)){ printf("cannot listen on %s\n", addr); return 1; }
+    printf("serving seed %u on %s\n", seed, addr);
+
+    FrameScheduler sched(1.0/60.0);
+    sched.reset();
+    double start = sched_default_now(nullptr), lastReport = start;
+    uint64_t lastBytes = 0;
+    while(game_is_running()){
+        g_server.poll();
+        sched.step(tick, nullptr);
+        if(game_is_over()){
+            newGame(++seed);
+            g_server.resync();
+        }
+        double now = sched_default_now(nullptr);
+        if(now - lastReport >= 5.0){
+            const StateServerStats &st = g_server.stats();
+            printf("tick %d: %d viewers (%ld joined, %ld dropped), %.1f kB/s out, last frame %zu bytes, %ld inputs\n",
+                game_get_tick(), st.viewers, st.joined, st.dropped, (st.bytesOut - lastBytes) / (now - lastReport) / 1000,
+                st.lastFrameBytes, st.inputs);
+            lastBytes = st.bytesOut; lastReport = now;
+        }
+        if(seconds > 0 && now - start >= seconds) break;
+        sched.wait_next_frame();
+    }
+    g_server.stop();
+    return 0;
+}
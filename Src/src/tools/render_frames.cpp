@@ -0,0 +1,55 @@
+// tools/render_frames.cpp
+// Headless software-renderer benchmark: simulates a session and renders every frame into a
+// persistent framebuffer, reporting ms/frame and fill rate. Optionally dumps frames as PPM.
+//   render_frames [frames=600] [ticksPerFrame=1] [dumpEvery=0] [outPrefix=frame]
+#include "render_soft.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static Vec2 scriptedThrust(int tick, void*){
+    double t = tick / 60.0;
+    return Vec2(cos(t * 0.35), sin(t * 0.21));
+}
+
+int main(int argc, char** argv){
+    int frames = argc > 1 ? atoi(argv[1]) : 600;
+    int ticksPerFrame = argc > 2 ? atoi(argv[2]) : 1;
+    int dumpEvery = argc > 3 ? atoi(argv[3]) : 0;
+    std::string prefix = argc > 4 ? argv[4] : "frame";
+
+    game_set_input_source(scriptedThrust, nullptr);
+    game_init(1);
+
+    int w = game_get_window_width(), h = game_get_window_height();
+    std::vector<uint32_t> pixels((size_t)w * h);
+    Framebuffer fb = { pixels.data(), w, h, w };
+
+    typedef std::chrono::steady_clock clk;
+    double renderSecs = 0;
+    int dumped = 0;
+    for(int f=0;f<frames;f++){
+        for(int t=0;t<ticksPerFrame;t++) game_update();
+        sim_view_update(); // no sim thread: captures the session in place
+        sim_view_clear_dirty_cells();
+        clk::time_point t0 = clk::now();
+        render_draw_world(fb);
+        render_draw_hud(fb);
+        render_draw_ui(fb);
+        if(sim_view().gameOver) render_draw_text(fb, 160, 120, "GAME OVER", fb_rgb(255,80,80), 6);
+        renderSecs += std::chrono::duration<double>(clk::now() - t0).count();
+        if(dumpEvery > 0 && f % dumpEvery == 0){
+            char path[512];
+            snprintf(path, sizeof(path), "%s_%05d.ppm", prefix.c_str(), f);
+            if(!fb_write_ppm(fb, path)){ fprintf(stderr, "cannot write %s\n", path); return 1; }
+            dumped++;
+        }
+    }
+    double msPerFrame = renderSecs * 1e3 / frames;
+    printf("frames: %d  %dx%d  %.3f ms/frame  %.0f fps  %.1f Mpix/s  dumped: %d\n",
+        frames, w, h, msPerFrame, 1e3 / msPerFrame, (double)w * h * frames / renderSecs / 1e6, dumped);
+    return 0;
+}
@@ -0,0 +1,105 @@
+// tools/replay.cpp
+// Records and replays input streams headlessly. Replays run at full CPU speed with no window
+// or frame pacing and verify the state hash after every tick.
+//   replay record <file> [ticks=36000] [seed=1]   record a scripted keyboard-style pilot
+//   replay play <file> [stopTick]                 replay (a recording from the game or a tool)
+//   replay check [ticks=36000] [seed=1]           record, replay, then tamper with one input
+//                                                 and check the drift is caught at that tick
+#include "replay.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// keyboard-style pilot: a held direction (each axis -1, 0 or 1) that changes every 45 ticks
+static Vec2 keyboardPilot(int tick, void*){
+    uint32_t k = (uint32_t)(tick / 45) * 2654435761u;
+    k ^= k >> 15;
+    return Vec2((double)((int)(k % 3) - 1), (double)((int)((k / 3) % 3) - 1));
+}
+
+static bool record(const char* path, int ticks, uint32_t seed){
+    Session* s = new Session();
+    s->inputSource = keyboardPilot;
+    session_reset(*s, seed);
+    ReplayRecorder rec;
+    if(!rec.start(*s, path)){ fprintf(stderr, "cannot record to %s\n", path); delete s; return false; }
+    for(int i=0;i<ticks && !s->gameOver;i++) session_update(*s);
+    int recorded = rec.ticks();
+    rec.stop();
+    bool ok = !rec.failed();
+    FILE* f = fopen(path, "rb");
+    long bytes = 0;
+    if(f){ fseek(f, 0, SEEK_END); bytes = ftell(f); fclose(f); }
+    printf("recorded %d ticks (seed %u) to %s: %ld bytes, %.2f bytes/tick%s\n",
+        recorded, seed, path, bytes, recorded ? (double)bytes / recorded : 0.0, ok ? "" : "  WRITE FAILED");
+    delete s;
+    return ok;
+}
+
+static bool play(const Replay& r, int stopTick, bool quiet){
+    if(r.numeric != SIM_NUMERIC){
+        printf("recorded by a %s build; this one computes in %s, so it cannot reproduce the hashes\n",
+            r.numeric ? "fixed-point" : "double", SIM_NUMERIC ? "fixed point" : "double");
+        return false;
+    }
+    Session* s = new Session();
+    ReplayResult res;
+    bool ok = replay_run(r, *s, res, stopTick);
+    if(!quiet || !ok){
+        printf("replayed %d/%d ticks in %.3f s (%.0f ticks/sec, %.0fx real time)\n", res.ticks, r.ticks(),
+            res.seconds, res.ticks / (res.seconds > 0 ? res.seconds : 1e-9), res.ticks / 60.0 / (res.seconds > 0 ? res.seconds : 1e-9));
+        if(ok) printf("all hashes match; final: tick=%d resources=%d score=%d drones=%d\n",
+            s->tickCount, s->resources, s->score, s->drones.size());
+        else printf("DRIFT at tick %d: expected %08x got %08x\n", res.mismatchTick, res.expected, res.actual);
+    }
+    delete s;
+    return ok;
+}
+
+int main(int argc, char** argv){
+    const char* mode = argc > 1 ? argv[1] : "check";
+    if(!strcmp(mode, "record") && argc > 2){
+        int ticks = argc > 3 ? atoi(argv[3]) : 36000;
+        uint32_t seed = argc > 4 ? (uint32_t)strtoul(argv[4], nullptr, 10) : 1;
+        return record(argv[2], ticks, seed) ? 0 : 1;
+    }
+    if(!strcmp(mode, "play") && argc > 2){
+        Replay r;
+        if(!replay_load(argv[2], r)){ fprintf(stderr, "cannot load %s\n", argv[2]); return 1; }
+        printf("%s: seed %u, map %dx%d, %d ticks, %d input runs\n", argv[2], r.seed, r.rows, r.cols, r.ticks(), (int)r.inputs.size());
+        return play(r, argc > 3 ? atoi(argv[3]) : 0, false) ? 0 : 1;
+    }
+    if(!strcmp(mode, "check")){
+        int ticks = argc > 2 ? atoi(argv[2]) : 36000;
+        uint32_t seed = argc > 3 ? (uint32_t)strtoul(argv[3], nullptr, 10) : 1;
+        const char* path = "replay_check.bin";
+        Replay r;
+        if(!record(path, ticks, seed) || !replay_load(path, r)){ fprintf(stderr, "record/load failed\n"); return 1; }
+        bool clean = play(r, 0, false);
+
+        // change one input run in the middle; the replay must report drift, not before that run
+        Replay bad = r;
+        size_t mid = bad.inputs.size() / 2;
+        int from = bad.inputs[mid].firstTick;
+        bad.inputs[mid].thrust.x += 0.5;
+        Session* s = new Session();
+        ReplayResult res;
+        bool caught = !replay_run(bad, *s, res) && res.mismatchTick >= from;
+        delete s;
+        printf("tampered input at tick %d: %s at tick %d\n", from, caught ? "drift caught" : "NOT CAUGHT", res.mismatchTick);
+
+        // fast-forward to a tick and stop there
+        Replay part = r;
+        int stop = r.ticks() / 3;
+        s = new Session();
+        bool ffOk = replay_run(part, *s, res, stop) && s->tickCount == stop;
+        delete s;
+        printf("fast-forward to tick %d: %s\n", stop, ffOk ? "ok" : "FAILED");
+        remove(path);
+        bool ok = clean && caught && ffOk;
+        printf("%s\n", ok ? "replay check passed" : "replay check FAILED");
+        return ok ? 0 : 1;
+    }
+    fprintf(stderr, "usage: replay record <file> [ticks] [seed] | play <file> [stopTick] | check [ticks] [seed]\n");
+    return 2;
+}
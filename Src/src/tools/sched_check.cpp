@@ -0,0 +1,84 @@
+// tools/sched_check.cpp
+// Headless frame-scheduler check: drives FrameScheduler with a fake clock through steady,
+// faster-than-tick, stalled and jittery frame patterns and checks ticks, dropped time, alpha
+// and jitter against the expected values. Tick and frame lengths are powers of two so every
+// expected value is exact. Exits non-zero on the first mismatch.
+//   sched_check
+#include "frame_scheduler.hpp"
+#include <cmath>
+#include <cstdio>
+
+struct FakeClock { double t; double overshoot; };
+static double fakeNow(void* u){ return ((FakeClock*)u)->t; }
+static void fakeWait(double s, void* u){ FakeClock *c = (FakeClock*)u; c->t += s + c->overshoot; }
+static void countTick(void* u){ (*(long*)u)++; }
+
+static int g_failures = 0;
+static void check(bool ok, const char* what){
+    printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+    if(!ok) g_failures++;
+}
+static bool near(double a, double b){ return std::fabs(a - b) < 1e-9; }
+
+int main(){
+    const double DT = 1.0 / 64;
+    long ticks = 0;
+    FakeClock clock = { 100.0, 0.0 };
+    FrameScheduler sched(DT, 4);
+    sched.set_clock(fakeNow, fakeWait, &clock);
+
+    printf("steady: frame interval == tick\n");
+    sched.step(countTick, &ticks); // first frame only starts the clock
+    bool oneEach = true;
+    for(int f=0;f<640;f++){
+        sched.wait_next_frame();
+        if(!sched.frame_due()){ oneEach = false; break; }
+        if(sched.step(countTick, &ticks) != 1 || sched.alpha() != 0) oneEach = false;
+    }
+    check(oneEach, "one tick per frame, alpha 0");
+    check(ticks == 640 && sched.totals().ticks == 640, "640 ticks in 640 frames");
+    check(sched.totals().dropped == 0 && sched.totals().maxJitter == 0, "nothing dropped, no jitter");
+
+    printf("fast: frames at twice the tick rate\n");
+    sched.set_frame_interval(DT / 2);
+    sched.set_clock(fakeNow, fakeWait, &clock);
+    ticks = 0;
+    sched.step(countTick, &ticks);
+    bool alternating = true;
+    for(int f=0;f<64;f++){
+        sched.wait_next_frame();
+        int n = sched.step(countTick, &ticks);
+        double want = (f & 1) ? 0.0 : 0.5;
+        if(n != ((f & 1) ? 1 : 0) || sched.alpha() != want) alternating = false;
+    }
+    check(alternating, "ticks alternate 0/1, alpha alternates 0.5/0");
+    check(ticks == 32, "32 ticks in 64 half-tick frames");
+
+    printf("stall: one 1 s frame, cap 4 steps\n");
+    sched.set_frame_interval(DT);
+    sched.set_clock(fakeNow, fakeWait, &clock);
+    ticks = 0;
+    sched.step(countTick, &ticks);
+    clock.t += 1.0 + DT / 4;
+    int n = sched.step(countTick, &ticks);
+    const FrameStats &st = sched.last();
+    check(n == 4 && ticks == 4, "ran exactly max_steps ticks");
+    check(near(st.dropped, 60 * DT), "dropped the 60 ticks over the cap");
+    check(near(st.alpha, 0.25), "kept the fractional tick as alpha");
+    check(sched.totals().cappedFrames == 1, "counted one capped frame");
+    sched.wait_next_frame();
+    check(sched.step(countTick, &ticks) == 1, "back to one tick per frame after the stall");
+
+    printf("jitter: waits overshoot by 1/1024 s\n");
+    sched.set_clock(fakeNow, fakeWait, &clock);
+    clock.overshoot = 1.0 / 1024;
+    ticks = 0;
+    sched.step(countTick, &ticks);
+    for(int f=0;f<64;f++){ sched.wait_next_frame(); sched.step(countTick, &ticks); }
+    check(near(sched.totals().maxJitter, 1.0 / 1024), "jitter equals the overshoot");
+    // 64 frames of 17/1024 s = 68 ticks (4 frames catch up with a second tick)
+    check(ticks == 68 && sched.totals().dropped == 0, "overshoot is caught up, not dropped");
+
+    printf(g_failures ? "FAILED: %d\n" : "all checks passed\n", g_failures);
+    return g_failures ? 1 : 0;
+}
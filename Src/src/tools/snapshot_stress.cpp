@@ -0,0 +1,128 @@
+// tools/snapshot_stress.cpp
+// Torn-read stress check for the snapshot triple buffer. A writer thread publishes snapshots
+// whose every field is derived from the sequence number, plus random world edits, while a reader
+// thread takes them and checks each one for mixed sequence numbers and applies its cell changes
+// to a mirror world. At the end the mirror must equal the writer's world. Every SYNTH_PACE
+// publishes the writer waits for the reader to catch up to within SYNTH_PACE, so a single-core or
+// busy box still interleaves the two; the pass fails if under 1% of publishes were read. A
+// second pass runs the real sim thread at a raised tick rate against a reading loop.
+//   snapshot_stress [publishes=200000] [simSeconds=2]
+#include "frame_scheduler.hpp"
+#include "sim_thread.hpp"
+#include <cmath>
+#include <cstdio>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
+static long countMismatches(const WorldGrid& a, const WorldGrid& b){
+    long bad = 0;
+    for(int pass=0;pass<2;pass++){
+        const WorldGrid &x = pass ? b : a, &y = pass ? a : b;
+        for(int i=0;i<x.chunk_count();i++){
+            const Chunk &ch = x.chunk(i);
+            for(int lr=0;lr<CHUNK_SIZE;lr++) for(int lc=0;lc<CHUNK_SIZE;lc++)
+                if(ch.at(lr, lc).type() != y.get(ch.row0()+lr, ch.col0()+lc).type()) bad++;
+        }
+    }
+    return bad;
+}
+
+static bool snapshotConsistent(const SimSnapshot& s){
+    uint64_t q = s.seq;
+    if(s.tick != (int)q || s.shipX != (double)q || s.shipY != -(double)q || s.score != (int)(q % 1000)) return false;
+    size_t n = q % 97;
+    if(s.droneX.size() != n || s.droneY.size() != n) return false;
+    for(size_t i=0;i<n;i++) if(s.droneX[i] != (double)(q * 1000 + i) || s.droneY[i] != (double)q) return false;
+    return true;
+}
+
+static const long SYNTH_PACE = 32;
+
+static int syntheticPass(long publishes){
+    SnapshotChannel ch;
+    WorldGrid writerWorld; writerWorld.reset(256, 256);
+    SnapshotView view; view.sync(writerWorld, 0);
+    std::atomic<uint64_t> seen(0); // last seq the reader took
+
+    std::thread writer([&]{
+        Rng rng(7);
+        std::vector<CellPos> changed;
+        for(long k=1;k<=publishes;k++){
+            if(k % SYNTH_PACE == 0)
+                while(seen.load(std::memory_order_acquire) + SYNTH_PACE < (uint64_t)k) std::this_thread::yield();
+            changed.clear();
+            int edits = rng.range(4);
+            for(int e=0;e<edits;e++){
+                int r = rng.range(256), c = rng.range(256);
+                Block b((BlockType)rng.range(BLOCK_TYPE_COUNT), 1);
+                writerWorld.set(r, c, b);
+            }
+            for(const CellPos &p : writerWorld.changes()) changed.push_back(p);
+            writerWorld.clear_changes();
+            ch.note_changes(writerWorld, changed);
+            SimSnapshot &s = ch.back();
+            uint64_t q = (uint64_t)k; // publish() will stamp this same seq
+            s.tick = (int)q; s.shipX = (double)q; s.shipY = -(double)q; s.score = (int)(q % 1000);
+            s.droneX.resize(q % 97); s.droneY.resize(q % 97);
+            for(size_t i=0;i<s.droneX.size();i++){ s.droneX[i] = (double)(q * 1000 + i); s.droneY[i] = (double)q; }
+            ch.publish();
+        }
+    });
+
+    long reads = 0, torn = 0, backwards = 0;
+    uint64_t last = 0;
+    while(last < (uint64_t)publishes){
+        if(!ch.acquire()){ std::this_thread::yield(); continue; }
+        const SimSnapshot &s = ch.front();
+        if(!snapshotConsistent(s)) torn++;
+        if(s.seq <= last) backwards++;
+        last = s.seq;
+        seen.store(last, std::memory_order_release);
+        view.apply(s);
+        reads++;
+    }
+    writer.join();
+    bool tooFew = reads * 100 < publishes;
+    long bad = countMismatches(writerWorld, view.world());
+    printf("synthetic: %ld publishes  %ld reads (%.1f%% skipped)  torn %ld  out-of-order %ld  mirror mismatches %ld\n",
+        publishes, reads, 100.0 * (publishes - reads) / publishes, torn, backwards, bad);
+    if(tooFew) printf("synthetic: too few reads to exercise concurrent acquire/publish (need 1%% of publishes)\n");
+    return (torn || backwards || bad || tooFew) ? 1 : 0;
+}
+
+static Vec2 scriptedThrust(int tick, void*){
+    double t = tick / 60.0;
+    return Vec2(cos(t * 0.35), sin(t * 0.21));
+}
+
+static int simPass(double seconds){
+    game_set_input_source(scriptedThrust, nullptr);
+    game_init(1);
+    sim_thread_start(1.0 / 600.0);
+    long reads = 0, bad = 0;
+    uint64_t last = 0;
+    double t0 = sched_default_now(nullptr);
+    while(sched_default_now(nullptr) - t0 < seconds){
+        if(!sim_view_update()) continue;
+        const SimSnapshot &s = sim_view();
+        if(s.seq <= last || s.droneX.size() != s.dronePrevX.size() || s.droneY.size() != s.droneX.size()) bad++;
+        last = s.seq;
+        sim_view_clear_dirty_cells();
+        reads++;
+    }
+    sim_thread_stop();
+    long mismatches = countMismatches(game_get_world(), sim_view_world());
+    printf("sim thread: %d ticks in %.1f s  %ld snapshots read  bad %ld  mirror mismatches %ld\n",
+        game_get_tick(), seconds, reads, bad, mismatches);
+    return (bad || mismatches) ? 1 : 0;
+}
+
+int main(int argc, char** argv){
+    long publishes = argc > 1 ? atol(argv[1]) : 200000;
+    double simSeconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int failed = syntheticPass(publishes);
+    failed |= simPass(simSeconds);
+    printf(failed ? "FAILED\n" : "ok\n");
+    return failed;
+}